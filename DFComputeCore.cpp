@@ -6,17 +6,28 @@
 
 #include "DFComputeCore.h"
 #include "cuda_compute/DFCudaMgr.hpp"
+#include "cuda_compute/DFCpuMgr.hpp"
 #include <dlfcn.h>
 namespace dexsim {
 namespace compute {
 DFComputeCore::DFComputeCore(bool useCuda) {
     if (useCuda) { CudaInit(); }
+    if (cu_mgr_ == nullptr) { CpuInit(); }
 }
 
 void DFComputeCore::CudaInit() {
-    cu_mgr_ = new cudamgr::CudaManager();
+    auto* cuda_mgr = new cudamgr::CudaManager();
+    if (!cuda_mgr->IsInitialized()) {
+        std::cerr << "CUDA is unavailable, falling back to the CPU backend."
+                  << std::endl;
+        delete cuda_mgr;
+        return;
+    }
+    cu_mgr_ = cuda_mgr;
 }
 
+void DFComputeCore::CpuInit() { cu_mgr_ = new cudamgr::CpuManager(); }
+
 int DFComputeCore::CreateStream(int stream_type) {
     int stream_id = cu_mgr_->CreateStreamInFamily(stream_type);
     if (stream_id == -1) {
@@ -53,6 +53,26 @@ public:
     /// \warning This function does not check if the stream is currently in use.
     void DeleteStream(int stream_type, int stream_id);
 
+    /// \brief Creates the pool of streams of a family, with IDs 0 ..
+    /// num_streams - 1
+    ///
+    /// \param stream_type The type of the stream family, without streams yet
+    /// \param config Size, priority and blocking behaviour of the streams
+    /// \return true if the pool was created
+    bool ConfigureStreamPool(int stream_type,
+                             const cudamgr::StreamPoolConfig& config) {
+        return cu_mgr_->ConfigureStreamPool(stream_type, config);
+    }
+
+    /// \brief Picks an idle or, failing that, the next stream of a pool for
+    /// independent work
+    ///
+    /// \param stream_type The type of the stream family
+    /// \return The ID of the stream, -1 if the family has no pool
+    int AcquireStream(int stream_type) {
+        return cu_mgr_->AcquireStream(stream_type);
+    }
+
     /// \brief Create a HyperArray with the specified dimensions and shape.
     ///
     /// \param arr Pointer to CUdeviceptr that will store the allocated memory
@@ -72,6 +92,98 @@ public:
         cu_mgr_->CreateArray<T>(arr, ndim, shape, data, use_gpu);
     }
 
+    /// \brief Creates an array owned by the returned reference, which
+    /// releases it with its last copy
+    template <typename T>
+    cudamgr::HyperArrayRef<T> MakeArray(int ndim,
+                                        int* shape,
+                                        T* data,
+                                        bool use_gpu = false) {
+        return cu_mgr_->MakeArray<T>(ndim, shape, data, use_gpu);
+    }
+
+    /// \brief Releases an array or view and, with its last reference, its
+    /// storage
+    ///
+    /// \param arr Handle from CreateArray or one of the view creators
+    template <typename T>
+    void ReleaseArray(HyperArrayHook arr) {
+        cu_mgr_->ReleaseArray<T>(arr);
+    }
+
+    /// \brief Creates an array holding num_envs environments of one shape in
+    /// a single allocation, the environment being the leading dimension
+    ///
+    /// \param arr Receives the batched array
+    /// \param num_envs Number of environments
+    /// \param ndim Number of dimensions of one environment, at most 3
+    /// \param shape Shape of one environment
+    /// \param data num_envs environments stored one after another
+    /// \param use_gpu Same as for CreateArray
+    template <typename T>
+    void CreateBatchedArray(HyperArrayHook* arr,
+                            int num_envs,
+                            int ndim,
+                            int* shape,
+                            T* data,
+                            bool use_gpu = false) {
+        cu_mgr_->CreateBatchedArray<T>(arr, num_envs, ndim, shape, data,
+                                       use_gpu);
+    }
+
+    /// \brief Creates a view of arr[index] along the leading dimension, e.g.
+    /// one environment of a batched array. The view shares the storage of arr
+    /// and can be launched and synced without copies.
+    ///
+    /// \return The view, to be released with ReleaseView
+    template <typename T>
+    HyperArrayHook CreateView(HyperArrayHook arr, int index) {
+        return cu_mgr_->CreateView<T>(arr, index);
+    }
+
+    /// \brief Creates a view of a contiguous arr with another shape of the
+    /// same size, sharing its storage
+    ///
+    /// \return The view, to be released with ReleaseView
+    template <typename T>
+    HyperArrayHook Reshape(HyperArrayHook arr, int ndim, const int* shape) {
+        return cu_mgr_->Reshape<T>(arr, ndim, shape);
+    }
+
+    /// \brief Creates a view of arr with its dimensions reordered, view
+    /// dimension i being dimension perm[i] of arr
+    ///
+    /// \return The view, to be released with ReleaseView
+    template <typename T>
+    HyperArrayHook Permute(HyperArrayHook arr, const int* perm) {
+        return cu_mgr_->Permute<T>(arr, perm);
+    }
+
+    /// \brief Creates a view of arr with dimensions dim0 and dim1 swapped
+    ///
+    /// \return The view, to be released with ReleaseView
+    template <typename T>
+    HyperArrayHook Transpose(HyperArrayHook arr, int dim0, int dim1) {
+        return cu_mgr_->Transpose<T>(arr, dim0, dim1);
+    }
+
+    /// \brief Creates a view of the elements [begin, end) with the given step
+    /// along dimension dim of arr
+    ///
+    /// \return The view, to be released with ReleaseView
+    template <typename T>
+    HyperArrayHook Slice(
+            HyperArrayHook arr, int dim, int begin, int end, int step = 1) {
+        return cu_mgr_->Slice<T>(arr, dim, begin, end, step);
+    }
+
+    /// \brief Releases a view created with CreateView, Reshape, Permute,
+    /// Transpose or Slice
+    template <typename T>
+    void ReleaseView(HyperArrayHook view) {
+        cu_mgr_->ReleaseView<T>(view);
+    }
+
     /// \brief Allocates device memory for a HyperArray
     ///
     /// \param arr HyperArray handle created with CreateArray
@@ -147,6 +259,127 @@ public:
         cu_mgr_->WriteArrayDataDevice(arr, data);
     }
 
+    /// \brief Enqueues a host to device copy on a stream
+    ///
+    /// \param arr HyperArray handle created with CreateArray
+    /// \param stream_type The type of the stream family, -1 for default
+    /// \param stream_id The ID of the stream to use
+    /// \tparam T Type of data stored in the array
+    /// \return Event to wait on or chain, release it with ReleaseEvent.
+    /// nullptr if there is nothing to wait for, e.g. the copy was skipped,
+    /// already finished or failed
+    template <typename T>
+    cudamgr::EventHandle SyncToDeviceAsync(HyperArrayHook arr,
+                                           int stream_type = -1,
+                                           int stream_id = -1) {
+        return cu_mgr_->SyncToDeviceAsync<T>(arr, stream_type, stream_id);
+    }
+
+    /// \brief Enqueues a device to host copy on a stream
+    ///
+    /// \param arr HyperArray handle created with CreateArray
+    /// \param stream_type The type of the stream family, -1 for default
+    /// \param stream_id The ID of the stream to use
+    /// \tparam T Type of data stored in the array
+    /// \return Event to wait on or chain, release it with ReleaseEvent.
+    /// nullptr if there is nothing to wait for, e.g. the copy was skipped,
+    /// already finished or failed
+    template <typename T>
+    cudamgr::EventHandle SyncToHostAsync(HyperArrayHook arr,
+                                         int stream_type = -1,
+                                         int stream_id = -1) {
+        return cu_mgr_->SyncToHostAsync<T>(arr, stream_type, stream_id);
+    }
+
+    /// \brief Enqueues a copy of the device data into a host buffer
+    ///
+    /// \param arr HyperArray handle created with CreateArray
+    /// \param data Output buffer, valid once the event completes
+    /// \param stream_type The type of the stream family, -1 for default
+    /// \param stream_id The ID of the stream to use
+    /// \tparam T Type of data stored in the array
+    /// \return Event to wait on or chain, release it with ReleaseEvent.
+    /// nullptr if there is nothing to wait for, e.g. the copy was skipped,
+    /// already finished or failed
+    template <typename T>
+    cudamgr::EventHandle GetArrayDataDeviceAsync(HyperArrayHook arr,
+                                                 T* data,
+                                                 int stream_type = -1,
+                                                 int stream_id = -1) {
+        return cu_mgr_->GetArrayDataDeviceAsync<T>(arr, data, stream_type,
+                                                   stream_id);
+    }
+
+    /// \brief Enqueues a copy of a host buffer into the device data
+    ///
+    /// \param arr HyperArray handle created with CreateArray
+    /// \param data Host data, untouched until the event completes
+    /// \param stream_type The type of the stream family, -1 for default
+    /// \param stream_id The ID of the stream to use
+    /// \tparam T Type of data stored in the array
+    /// \return Event to wait on or chain, release it with ReleaseEvent.
+    /// nullptr if there is nothing to wait for, e.g. the copy was skipped,
+    /// already finished or failed
+    template <typename T>
+    cudamgr::EventHandle WriteArrayDataDeviceAsync(HyperArrayHook arr,
+                                                   T* data,
+                                                   int stream_type = -1,
+                                                   int stream_id = -1) {
+        return cu_mgr_->WriteArrayDataDeviceAsync<T>(arr, data, stream_type,
+                                                     stream_id);
+    }
+
+    /// \brief Blocks until the event has completed
+    void WaitEvent(cudamgr::EventHandle event) { cu_mgr_->WaitEvent(event); }
+
+    /// \brief Makes future work on a stream wait for the event
+    ///
+    /// \param stream_type The type of the stream family, -1 for default
+    /// \param stream_id The ID of the stream to use
+    /// \param event Event returned by one of the *Async calls
+    void StreamWaitEvent(int stream_type,
+                         int stream_id,
+                         cudamgr::EventHandle event) {
+        cu_mgr_->StreamWaitEvent(stream_type, stream_id, event);
+    }
+
+    /// \brief Returns true once the event has completed, never blocks
+    bool QueryEvent(cudamgr::EventHandle event) {
+        return cu_mgr_->QueryEvent(event);
+    }
+
+    /// \brief Gives an event back to the manager for reuse
+    void ReleaseEvent(cudamgr::EventHandle event) {
+        cu_mgr_->ReleaseEvent(event);
+    }
+
+    /// \brief Marks the work queued on a stream so far, tokens need no release
+    ///
+    /// \param stream_type The type of the stream family, -1 for default
+    /// \param stream_id The ID of the stream to use
+    /// \return Token for Wait, kNoSignal on failure
+    cudamgr::SignalToken Signal(int stream_type, int stream_id) {
+        return cu_mgr_->Signal(stream_type, stream_id);
+    }
+
+    /// \brief Makes future work on a stream wait for a token, the host does
+    /// not block
+    ///
+    /// \param stream_type The type of the stream family, -1 for default
+    /// \param stream_id The ID of the stream to use
+    /// \param token Token returned by Signal
+    void Wait(int stream_type, int stream_id, cudamgr::SignalToken token) {
+        cu_mgr_->Wait(stream_type, stream_id, token);
+    }
+
+    /// \brief Returns true once the work before the token has finished
+    bool QuerySignal(cudamgr::SignalToken token) {
+        return cu_mgr_->QuerySignal(token);
+    }
+
+    /// \brief Blocks until the work before the token has finished
+    void WaitSignal(cudamgr::SignalToken token) { cu_mgr_->WaitSignal(token); }
+
     /// \brief Releases GPU data for a HyperArray
     ///
     /// \tparam T Type of data stored in the array
@@ -178,10 +411,10 @@ public:
     /// \brief Shares CPU data from a HyperArray to a pointer
     ///
     /// \param src Source HyperArray handle
-    /// \param dst Destination pointer
+    /// \param dst Receives the first element of src
     /// \tparam T Type of data stored in the array
     template <typename T>
-    void ShareFromArrayDataHost(HyperArrayHook src, T* dst) {
+    void ShareFromArrayDataHost(HyperArrayHook src, T** dst) {
         cu_mgr_->ShareFromArrayDataHost<T>(src, dst);
     }
 
@@ -198,10 +431,10 @@ public:
     /// \brief Shares GPU data from a HyperArray to a pointer
     ///
     /// \param src Source HyperArray handle
-    /// \param dst Destination pointer
+    /// \param dst Receives the device address of the first element of src
     /// \tparam T Type of data stored in the array
     template <typename T>
-    void ShareFromArrayDataDevice(HyperArrayHook src, T* dst) {
+    void ShareFromArrayDataDevice(HyperArrayHook src, T** dst) {
         cu_mgr_->ShareFromArrayDataDevice<T>(src, dst);
     }
 
@@ -215,6 +448,42 @@ public:
         cu_mgr_->ShareFromArrayDataDevice<T>(src, dst);
     }
 
+    /// \brief Launches a kernel whose arguments may have different element
+    /// types, e.g. f32 positions, i32 indices and ui8 masks
+    ///
+    /// \param func Name of the kernel function to launch
+    /// \param num_arrays Number of arrays to pass to the kernel
+    /// \param arrays Array of HyperArray handles
+    /// \param stream_type The type of the stream family
+    /// \param stream_id The ID of the stream to use
+    /// \param write_mask Bit i marks arrays[i] as written by the kernel
+    void Launch(const char* func,
+                int num_arrays,
+                HyperArrayHook* arrays,
+                int stream_type = -1,
+                int stream_id = -1,
+                uint32_t write_mask = ~0u) {
+        cu_mgr_->Launch(func, num_arrays, arrays, stream_type, stream_id,
+                        write_mask);
+    }
+
+    /// \brief Launches a kernel looked up with GetKernel, arguments may have
+    /// different element types
+    void Launch(cudamgr::KernelHandle kernel,
+                int num_arrays,
+                HyperArrayHook* arrays,
+                int stream_type = -1,
+                int stream_id = -1,
+                uint32_t write_mask = ~0u) {
+        cu_mgr_->Launch(kernel, num_arrays, arrays, stream_type, stream_id,
+                        write_mask);
+    }
+
+    /// \brief Element type of a HyperArray
+    DType GetArrayDType(HyperArrayHook arr) const {
+        return cudamgr::ToArrayBase(arr)->dtype_;
+    }
+
     /// \brief Launches a CUDA kernel with the specified function name and
     ///
     /// arrays. \param func Name of the kernel function to launch \param
@@ -222,13 +491,287 @@ public:
     /// HyperArray handles \tparam T Type of data stored in the arrays
     /// \param stream_type The type of the stream family
     /// \param stream_id The ID of the stream to use
+    /// \param write_mask Bit i marks arrays[i] as written by the kernel, its
+    /// host copy becomes stale. Read-only inputs may be left out.
     template <typename T>
     void Launch(const char* func,
                 int num_arrays,
                 HyperArrayHook* arrays,
                 int stream_type = -1,
-                int stream_id = -1) {
-        cu_mgr_->Launch<T>(func, num_arrays, arrays, stream_type, stream_id);
+                int stream_id = -1,
+                uint32_t write_mask = ~0u) {
+        cu_mgr_->Launch<T>(func, num_arrays, arrays, stream_type, stream_id,
+                           write_mask);
+    }
+
+    /// \brief Looks up a kernel once, launches through the handle skip the
+    /// name lookup
+    ///
+    /// \param func Name of the kernel function
+    /// \return Kernel handle, cudamgr::kInvalidKernel if it does not exist
+    cudamgr::KernelHandle GetKernel(const char* func) {
+        return cu_mgr_->GetKernel(func);
+    }
+
+    /// \brief Loads kernels before their first launch, which would otherwise
+    /// load their modules
+    ///
+    /// \param funcs Names of the kernels
+    /// \param count Number of names
+    /// \return Number of kernels that are ready to launch
+    int Preload(const char* const* funcs, int count) {
+        return cu_mgr_->Preload(funcs, count);
+    }
+
+    /// \brief Launches a kernel looked up with GetKernel
+    ///
+    /// \param kernel Handle returned by GetKernel
+    /// \param num_arrays Number of arrays to pass to the kernel
+    /// \param arrays Array of HyperArray handles
+    /// \param stream_type The type of the stream family
+    /// \param stream_id The ID of the stream to use
+    /// \param write_mask Bit i marks arrays[i] as written by the kernel
+    /// \tparam T Type of data stored in the arrays
+    template <typename T>
+    void Launch(cudamgr::KernelHandle kernel,
+                int num_arrays,
+                HyperArrayHook* arrays,
+                int stream_type = -1,
+                int stream_id = -1,
+                uint32_t write_mask = ~0u) {
+        cu_mgr_->Launch<T>(kernel, num_arrays, arrays, stream_type, stream_id,
+                           write_mask);
+    }
+
+    /// \brief Binds a kernel looked up with GetKernel to its arrays
+    template <typename T>
+    cudamgr::LaunchHook BindLaunch(cudamgr::KernelHandle kernel,
+                                   int num_arrays,
+                                   HyperArrayHook* arrays,
+                                   int stream_type = -1,
+                                   int stream_id = -1,
+                                   uint32_t write_mask = ~0u) {
+        return cu_mgr_->BindLaunch<T>(kernel, num_arrays, arrays, stream_type,
+                                      stream_id, write_mask);
+    }
+
+    /// \brief Binds a kernel to its arrays once, for launches repeated every
+    /// frame. Submitting it skips the kernel lookup and argument packing.
+    ///
+    /// \param func Name of the kernel function to launch
+    /// \param num_arrays Number of arrays to pass to the kernel
+    /// \param arrays Array of HyperArray handles
+    /// \param stream_type The type of the stream family
+    /// \param stream_id The ID of the stream to use
+    /// \param write_mask Bit i marks arrays[i] as written by the kernel
+    /// \return Handle for SubmitLaunch, nullptr if the kernel does not exist
+    /// \tparam T Type of data stored in the arrays
+    template <typename T>
+    cudamgr::LaunchHook BindLaunch(const char* func,
+                                   int num_arrays,
+                                   HyperArrayHook* arrays,
+                                   int stream_type = -1,
+                                   int stream_id = -1,
+                                   uint32_t write_mask = ~0u) {
+        return cu_mgr_->BindLaunch<T>(func, num_arrays, arrays, stream_type,
+                                      stream_id, write_mask);
+    }
+
+    /// \brief BindLaunch for arguments with different element types
+    cudamgr::LaunchHook BindLaunch(const char* func,
+                                   int num_arrays,
+                                   HyperArrayHook* arrays,
+                                   int stream_type = -1,
+                                   int stream_id = -1,
+                                   uint32_t write_mask = ~0u) {
+        return cu_mgr_->BindLaunch(func, num_arrays, arrays, stream_type,
+                                   stream_id, write_mask);
+    }
+
+    /// \brief BindLaunch by kernel handle for arguments with different element
+    /// types
+    cudamgr::LaunchHook BindLaunch(cudamgr::KernelHandle kernel,
+                                   int num_arrays,
+                                   HyperArrayHook* arrays,
+                                   int stream_type = -1,
+                                   int stream_id = -1,
+                                   uint32_t write_mask = ~0u) {
+        return cu_mgr_->BindLaunch(kernel, num_arrays, arrays, stream_type,
+                                   stream_id, write_mask);
+    }
+
+    /// \brief Submits a launch created with BindLaunch
+    void SubmitLaunch(cudamgr::LaunchHook launch) {
+        cu_mgr_->SubmitLaunch(launch);
+    }
+
+    /// \brief Launches one kernel over many independent argument sets, e.g.
+    /// one per environment. Records are validated and packed in one pass and
+    /// submitted back-to-back; an invalid record fails the whole batch.
+    ///
+    /// \param func Name of the kernel function to launch
+    /// \param records Arrays and write mask of every launch
+    /// \param count Number of records
+    /// \param stream_type The type of the stream family
+    /// \param stream_id The ID of the stream to use
+    /// \return true if every record was submitted
+    bool LaunchBatch(const char* func,
+                     const cudamgr::LaunchRecord* records,
+                     int count,
+                     int stream_type = -1,
+                     int stream_id = -1) {
+        return cu_mgr_->LaunchBatch(func, records, count, stream_type,
+                                    stream_id);
+    }
+
+    /// \brief LaunchBatch by kernel handle
+    bool LaunchBatch(cudamgr::KernelHandle kernel,
+                     const cudamgr::LaunchRecord* records,
+                     int count,
+                     int stream_type = -1,
+                     int stream_id = -1) {
+        return cu_mgr_->LaunchBatch(kernel, records, count, stream_type,
+                                    stream_id);
+    }
+
+    /// \brief Selects how launches created from now on map onto the grid
+    ///
+    /// \param mode cudamgr::LAUNCH_SHAPED (one thread per element) or
+    /// cudamgr::LAUNCH_FLAT (a device-sized grid striding over the flattened
+    /// domain)
+    void SetLaunchMode(cudamgr::LaunchMode mode) {
+        cu_mgr_->SetLaunchMode(mode);
+    }
+
+    /// \brief Changes the launch mode of a launch created with BindLaunch
+    void SetLaunchMode(cudamgr::LaunchHook launch, cudamgr::LaunchMode mode) {
+        cu_mgr_->SetLaunchMode(launch, mode);
+    }
+
+    /// \brief Releases a launch created with BindLaunch
+    void ReleaseLaunch(cudamgr::LaunchHook launch) {
+        cu_mgr_->ReleaseLaunch(launch);
+    }
+
+    /// \brief Times block shapes for a bound launch and keeps the fastest
+    ///
+    /// The launch is run repeatedly, only use it on launches that can be
+    /// repeated without changing the result. The choice is persisted per
+    /// kernel and problem size.
+    ///
+    /// \param launch Handle returned by BindLaunch
+    /// \param repeats Number of timed submissions per candidate
+    /// \return true if a block shape was chosen
+    bool AutotuneLaunch(cudamgr::LaunchHook launch, int repeats = 10) {
+        return cu_mgr_->AutotuneLaunch(launch, repeats);
+    }
+
+    /// \brief Starts recording a fixed launch sequence into a graph
+    ///
+    /// Launches and *Async transfers issued until EndCapture are recorded on
+    /// the given stream instead of being executed.
+    ///
+    /// \param stream_type The type of the stream family
+    /// \param stream_id The ID of the stream to capture on
+    /// \return true if capturing started
+    bool BeginCapture(int stream_type, int stream_id) {
+        return cu_mgr_->BeginCapture(stream_type, stream_id);
+    }
+
+    /// \brief Stops recording and builds the executable graph
+    ///
+    /// \return Graph for ReplayGraph, nullptr if the capture failed
+    cudamgr::GraphHook EndCapture() { return cu_mgr_->EndCapture(); }
+
+    /// \brief Replays a captured graph with one submission. Kernel arguments
+    /// follow arrays whose device memory changed since the capture.
+    ///
+    /// \param graph Graph returned by EndCapture
+    /// \return true if the graph was submitted
+    bool ReplayGraph(cudamgr::GraphHook graph) {
+        return cu_mgr_->ReplayGraph(graph);
+    }
+
+    /// \brief Releases a graph returned by EndCapture
+    void ReleaseGraph(cudamgr::GraphHook graph) {
+        cu_mgr_->ReleaseGraph(graph);
+    }
+
+    /// \brief Declares that the host copy was written through a raw pointer
+    ///
+    /// \param arr HyperArray handle created with CreateArray
+    /// \tparam T Type of data stored in the array
+    template <typename T>
+    void MarkHostModified(HyperArrayHook arr) {
+        cu_mgr_->MarkHostModified<T>(arr);
+    }
+
+    /// \brief Declares that the device copy was written outside the manager
+    ///
+    /// \param arr HyperArray handle created with CreateArray
+    /// \tparam T Type of data stored in the array
+    template <typename T>
+    void MarkDeviceModified(HyperArrayHook arr) {
+        cu_mgr_->MarkDeviceModified<T>(arr);
+    }
+
+    /// \brief Bytes transferred and bytes saved by skipping clean syncs
+    cudamgr::TransferStats GetTransferStats() const {
+        return cu_mgr_->GetTransferStats();
+    }
+
+    /// \brief Resets the counters returned by GetTransferStats
+    void ResetTransferStats() { cu_mgr_->ResetTransferStats(); }
+
+    /// \brief Allocates host storage of new arrays in page-locked memory
+    ///
+    /// \param enable true to pin host storage allocated from now on
+    void SetPinnedHostMemory(bool enable) {
+        cu_mgr_->SetPinnedHostMemory(enable);
+    }
+
+    /// \brief Page-locks a caller owned host buffer used for transfers
+    ///
+    /// \param ptr Start of the buffer
+    /// \param size Size of the buffer in bytes
+    /// \return true if the buffer is registered
+    bool RegisterHostMemory(void* ptr, size_t size) {
+        return cu_mgr_->RegisterHostMemory(ptr, size);
+    }
+
+    /// \brief Undoes RegisterHostMemory
+    ///
+    /// \param ptr Start of the buffer passed to RegisterHostMemory
+    void UnregisterHostMemory(void* ptr) { cu_mgr_->UnregisterHostMemory(ptr); }
+
+    /// \brief Returns cached device memory that no array uses to the driver
+    ///
+    /// \return Number of bytes released
+    size_t TrimDeviceMemory() { return cu_mgr_->TrimDeviceMemory(); }
+
+    /// \brief Hit/miss and fragmentation statistics of the device memory pool
+    cudamgr::MemoryPoolStats GetDeviceMemoryStats() const {
+        return cu_mgr_->GetDeviceMemoryStats();
+    }
+
+    /// \brief Host memory for per-frame temporaries, aligned to 64 bytes and
+    /// valid until the next ResetScratch
+    void* AllocateScratch(size_t size) {
+        return cu_mgr_->AllocateScratch(size);
+    }
+
+    /// \brief Makes all scratch memory available again, e.g. once per frame
+    void ResetScratch() { cu_mgr_->ResetScratch(); }
+
+    /// \brief Returns cached pageable host memory that no array uses to the
+    /// system
+    ///
+    /// \return Number of bytes released
+    size_t TrimHostMemory() { return cu_mgr_->TrimHostMemory(); }
+
+    /// \brief Hit/miss statistics of the host arena
+    cudamgr::HostArenaStats GetHostArenaStats() const {
+        return cu_mgr_->GetHostArenaStats();
     }
 
     /// \brief Synchronizes the specified stream
@@ -243,7 +786,7 @@ public:
 
     /// \brief Get the CUDA driver
     ///
-    /// \return the CUdevice in CudaMgr
+    /// \return the CUdevice in CudaMgr, nullptr on the CPU backend
     cudamgr::ICudaFunctionManager* GetCudaDriver() {
         return cu_mgr_->GetCuda();
     }
@@ -258,6 +801,10 @@ private:
     /// \warning While cuda is initialized, the warp library is also loaded.
     void CudaInit();
 
+    /// \brief Initializes the host backend, used when CUDA is not requested or
+    /// not available. Kernels run from HostKernelRegistry on a thread pool.
+    void CpuInit();
+
     DFComputeCore(const DFComputeCore&) = delete;
     DFComputeCore& operator=(const DFComputeCore&) = delete;
     DFComputeCore(DFComputeCore&&) = delete;
@@ -265,7 +812,7 @@ private:
 
     inline static std::unique_ptr<DFComputeCore> _instance;
     inline static std::once_flag _initFlag;
-    cudamgr::ICudaManager* cu_mgr_;
+    cudamgr::ICudaManager* cu_mgr_ = nullptr;
 };
 }  // namespace compute
 }  // namespace dexsim
\ No newline at end of file
@@ -0,0 +1,96 @@
+# Turns a kernel directory into a translation unit that registers its modules
+# and CoreLUT.txt entries with EmbeddedKernelRegistry.
+#
+#   cmake -DKERNEL_DIR=<dir> -DOUTPUT=<file.cpp> -P DFEmbedKernels.cmake
+#
+# CoreLUT.txt files are parsed like CudaManager::ProcessFile, later files win.
+# The module of a type is <type>.cubin next to its CoreLUT.txt when present,
+# <type>.ptx otherwise.
+
+if(NOT KERNEL_DIR OR NOT OUTPUT)
+    message(FATAL_ERROR "DFEmbedKernels.cmake needs KERNEL_DIR and OUTPUT")
+endif()
+
+file(GLOB_RECURSE LUTS "${KERNEL_DIR}/CoreLUT.txt")
+list(SORT LUTS)
+
+set(TYPES "")
+set(KERNELS "")
+foreach(LUT IN LISTS LUTS)
+    get_filename_component(LUT_DIR "${LUT}" DIRECTORY)
+    file(STRINGS "${LUT}" LINES)
+    set(TYPE "")
+    foreach(LINE IN LISTS LINES)
+        string(STRIP "${LINE}" LINE)
+        if(LINE MATCHES "^([^ ]+) ")
+            set(TYPE "${CMAKE_MATCH_1}")
+            list(APPEND TYPES "${TYPE}")
+            set("MODULE_DIR_${TYPE}" "${LUT_DIR}")
+        endif()
+        if(LINE MATCHES "^([^:]*):(.*)$" AND NOT TYPE STREQUAL "")
+            list(APPEND KERNELS "${CMAKE_MATCH_1}")
+            set("KERNEL_MODULE_${CMAKE_MATCH_1}" "${TYPE}")
+            set("KERNEL_SYMBOL_${CMAKE_MATCH_1}" "${CMAKE_MATCH_2}")
+        endif()
+    endforeach()
+endforeach()
+if(TYPES)
+    list(REMOVE_DUPLICATES TYPES)
+endif()
+if(KERNELS)
+    list(REMOVE_DUPLICATES KERNELS)
+endif()
+
+set(SOURCE "// Generated by DFEmbedKernels.cmake from ${KERNEL_DIR}, do not edit.\n")
+string(APPEND SOURCE "#include \"DFEmbeddedKernels.h\"\n")
+
+set(MODULE_TABLE "")
+set(INDEX 0)
+foreach(TYPE IN LISTS TYPES)
+    set(IMAGE "${MODULE_DIR_${TYPE}}/${TYPE}.cubin")
+    set(CUBIN "true")
+    if(NOT EXISTS "${IMAGE}")
+        set(IMAGE "${MODULE_DIR_${TYPE}}/${TYPE}.ptx")
+        set(CUBIN "false")
+    endif()
+    if(NOT EXISTS "${IMAGE}")
+        message(WARNING "No PTX or cubin for kernel module ${TYPE}")
+        continue()
+    endif()
+    file(SIZE "${IMAGE}" SIZE)
+    file(READ "${IMAGE}" HEX HEX)
+    # 16 bytes per line, the trailing 0 terminates PTX for the JIT
+    string(REGEX REPLACE "(................................)" "\\1\n" HEX
+           "${HEX}")
+    string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," HEX "${HEX}")
+    string(APPEND SOURCE "\nstatic const unsigned char kModule${INDEX}[] = {\n"
+           "${HEX}0x00};\n")
+    string(APPEND MODULE_TABLE
+           "    {\"${TYPE}\", kModule${INDEX}, ${SIZE}, ${CUBIN}},\n")
+    math(EXPR INDEX "${INDEX} + 1")
+endforeach()
+
+set(KERNEL_TABLE "")
+foreach(KERNEL IN LISTS KERNELS)
+    string(APPEND KERNEL_TABLE "    {\"${KERNEL}\", "
+           "\"${KERNEL_MODULE_${KERNEL}}\", \"${KERNEL_SYMBOL_${KERNEL}}\"},\n")
+endforeach()
+
+if(INDEX GREATER 0 AND KERNELS)
+    string(APPEND SOURCE
+           "\nstatic const ::dexsim::cudamgr::EmbeddedModule kModules[] = {\n"
+           "${MODULE_TABLE}};\n"
+           "\nstatic const ::dexsim::cudamgr::EmbeddedKernel kKernels[] = {\n"
+           "${KERNEL_TABLE}};\n"
+           "\nDF_REGISTER_EMBEDDED_KERNELS(kModules, kKernels);\n")
+else()
+    message(WARNING "No kernels found to embed in ${KERNEL_DIR}")
+endif()
+
+# an unchanged file keeps the object from being rebuilt
+if(EXISTS "${OUTPUT}")
+    file(READ "${OUTPUT}" OLD_SOURCE)
+endif()
+if(NOT SOURCE STREQUAL "${OLD_SOURCE}")
+    file(WRITE "${OUTPUT}" "${SOURCE}")
+endif()
@@ -0,0 +1,95 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// To facilitate external usage, we define some types in the dexsim namespace
+// and place them outside the compute namespace Thanks this, you can only use
+// f32 or i32, not compute::f32 or compute::i32
+namespace dexsim {
+// the hook of HyperArray. In the future, HyperArray may be defined in different
+// backends, such as CPU, CUDA, Vulkan, etc. So we use a void* to represent the
+// HyperArray, and the specific type is defined in the backend.
+using HyperArrayHook = void*;
+
+using i8 = int8_t;
+using i16 = int16_t;
+using i32 = int32_t;
+using i64 = int64_t;
+using ui8 = uint8_t;
+using ui16 = uint16_t;
+using ui32 = uint32_t;
+using ui64 = uint64_t;
+using f32 = float;
+using f64 = double;
+
+// Element type of a HyperArray, recorded when the array is created so that
+// launches can pack arguments of different types together.
+enum DType : uint8_t {
+    DTYPE_UNKNOWN = 0,
+    DTYPE_I8,
+    DTYPE_I16,
+    DTYPE_I32,
+    DTYPE_I64,
+    DTYPE_UI8,
+    DTYPE_UI16,
+    DTYPE_UI32,
+    DTYPE_UI64,
+    DTYPE_F32,
+    DTYPE_F64,
+};
+
+// DTypeOf<T>::value is the DType of a scalar type, DTYPE_UNKNOWN for others
+template <typename T>
+struct DTypeOf {
+    static constexpr DType value = DTYPE_UNKNOWN;
+};
+template <> struct DTypeOf<i8> { static constexpr DType value = DTYPE_I8; };
+template <> struct DTypeOf<i16> { static constexpr DType value = DTYPE_I16; };
+template <> struct DTypeOf<i32> { static constexpr DType value = DTYPE_I32; };
+template <> struct DTypeOf<i64> { static constexpr DType value = DTYPE_I64; };
+template <> struct DTypeOf<ui8> { static constexpr DType value = DTYPE_UI8; };
+template <> struct DTypeOf<ui16> { static constexpr DType value = DTYPE_UI16; };
+template <> struct DTypeOf<ui32> { static constexpr DType value = DTYPE_UI32; };
+template <> struct DTypeOf<ui64> { static constexpr DType value = DTYPE_UI64; };
+template <> struct DTypeOf<f32> { static constexpr DType value = DTYPE_F32; };
+template <> struct DTypeOf<f64> { static constexpr DType value = DTYPE_F64; };
+
+// Size of one element in bytes, 0 for DTYPE_UNKNOWN
+inline size_t DTypeSize(DType dtype) {
+    switch (dtype) {
+        case DTYPE_I8:
+        case DTYPE_UI8:
+            return 1;
+        case DTYPE_I16:
+        case DTYPE_UI16:
+            return 2;
+        case DTYPE_I32:
+        case DTYPE_UI32:
+        case DTYPE_F32:
+            return 4;
+        case DTYPE_I64:
+        case DTYPE_UI64:
+        case DTYPE_F64:
+            return 8;
+        default:
+            return 0;
+    }
+}
+
+// Short name used in kernel names and messages, e.g. "f32"
+inline const char* DTypeName(DType dtype) {
+    switch (dtype) {
+        case DTYPE_I8: return "i8";
+        case DTYPE_I16: return "i16";
+        case DTYPE_I32: return "i32";
+        case DTYPE_I64: return "i64";
+        case DTYPE_UI8: return "ui8";
+        case DTYPE_UI16: return "ui16";
+        case DTYPE_UI32: return "ui32";
+        case DTYPE_UI64: return "ui64";
+        case DTYPE_F32: return "f32";
+        case DTYPE_F64: return "f64";
+        default: return "unknown";
+    }
+}
+}  // namespace dexsim
@@ -0,0 +1,293 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) 2021-2025 DexForce Technology Co., Ltd.
+//
+// All rights reserved.
+// ----------------------------------------------------------------------------
+#include <cstring>
+
+#include "DFCpuMgr.hpp"
+
+namespace dexsim {
+namespace cudamgr {
+
+CpuManager::CpuManager(unsigned num_threads) : pool_(num_threads) {
+    std::cout << "Cpu manager init successful, " << pool_.Size()
+              << " worker threads." << std::endl;
+}
+
+void CpuManager::UnInit() {}
+
+std::vector<bool>* CpuManager::GetStreamFamily(int stream_type) {
+    switch (stream_type) {
+        case RENDERING_STREAM:
+            return &rendering_stream_;
+        case CALCULATE_STREAM:
+            return &calculate_stream_;
+        case GEOMETRY_STREAM:
+            return &geometry_stream_;
+        case PHYSICS_STREAM:
+            return &physics_stream_;
+        case CUSTOM_STREAM:
+            return &custom_stream_;
+        default:
+            std::cerr << "Invalid stream type: " << stream_type << std::endl;
+            return nullptr;
+    }
+}
+
+int CpuManager::CreateStreamInFamily(int stream_type) {
+    std::vector<bool>* targetStreamFamily = GetStreamFamily(stream_type);
+    if (targetStreamFamily == nullptr) return -1;
+    std::lock_guard<std::mutex> lock(stream_mutex_);
+
+    for (size_t i = 0; i < targetStreamFamily->size(); ++i) {
+        if (!(*targetStreamFamily)[i]) {
+            (*targetStreamFamily)[i] = true;
+            return static_cast<int>(i);
+        }
+    }
+    targetStreamFamily->push_back(true);
+    return static_cast<int>(targetStreamFamily->size()) - 1;
+}
+
+void CpuManager::DeleteStreamFromFamily(int stream_type, int stream_id) {
+    std::vector<bool>* targetStreamFamily = GetStreamFamily(stream_type);
+    if (targetStreamFamily == nullptr) return;
+    std::lock_guard<std::mutex> lock(stream_mutex_);
+
+    if (stream_id < 0 ||
+        stream_id >= static_cast<int>(targetStreamFamily->size()) ||
+        !(*targetStreamFamily)[stream_id]) {
+        std::cerr << "Invalid stream ID: " << stream_id << std::endl;
+        return;
+    }
+    if (stream_id < pool_sizes_[stream_type]) {
+        std::cerr << "Warning: stream " << stream_id << " of stream family "
+                  << stream_type << " belongs to its pool, it is not "
+                  << "deleted." << std::endl;
+        return;
+    }
+    (*targetStreamFamily)[stream_id] = false;
+}
+
+bool CpuManager::ConfigureStreamPool(int stream_type,
+                                     const StreamPoolConfig& config) {
+    std::vector<bool>* targetStreamFamily = GetStreamFamily(stream_type);
+    if (targetStreamFamily == nullptr) return false;
+    std::lock_guard<std::mutex> lock(stream_mutex_);
+    if (config.num_streams < 1 || !targetStreamFamily->empty()) {
+        std::cerr << "Warning: Failed to create the stream pool of family "
+                  << stream_type << ", it needs at least one stream and no "
+                  << "streams created before." << std::endl;
+        return false;
+    }
+    targetStreamFamily->assign(config.num_streams, true);
+    pool_sizes_[stream_type] = config.num_streams;
+    return true;
+}
+
+// launches finish before they return, every stream is idle
+int CpuManager::AcquireStream(int stream_type) {
+    if (GetStreamFamily(stream_type) == nullptr) return -1;
+    std::lock_guard<std::mutex> lock(stream_mutex_);
+    int pool = pool_sizes_[stream_type];
+    if (pool == 0) {
+        std::cerr << "Warning: stream family " << stream_type
+                  << " has no stream pool, see ConfigureStreamPool."
+                  << std::endl;
+        return -1;
+    }
+    return static_cast<int>(next_pool_stream_[stream_type]++ % pool);
+}
+
+void CpuManager::AllocateDeviceMemoryImpl(CUdeviceptr* arr, size_t size) {
+    void* data = host_arena_.Allocate(size);
+    if (data == nullptr) {
+        std::cerr << "Failed to allocate host backed device memory of "
+                  << size << " bytes." << std::endl;
+        return;
+    }
+    *arr = reinterpret_cast<CUdeviceptr>(data);
+}
+
+// there is no DMA engine to feed, pinning would only cost locked pages
+void* CpuManager::AllocateHostMemoryImpl(size_t size, bool& pinned) {
+    pinned = false;
+    return host_arena_.Allocate(size);
+}
+
+void CpuManager::ReleaseHostMemoryImpl(void* ptr, bool) {
+    host_arena_.Free(ptr);
+}
+
+bool CpuManager::RegisterHostMemory(void*, size_t) { return true; }
+
+void CpuManager::UnregisterHostMemory(void*) {}
+
+void CpuManager::ReleaseArrayDataDeviceImpl(SharedDataGPU* gpuData) {
+    if (--gpuData->semaphore_ == 0) {
+        gpuData->is_allocated_ = false;
+        if (!gpuData->is_external_) {
+            host_arena_.Free(reinterpret_cast<void*>(gpuData->value_));
+        }
+        SlabDelete(gpuData);
+    }
+}
+
+// launches are synchronous, no stream is still using the memory
+void CpuManager::WaitStreamUseImpl(const SharedDataGPU*) {}
+
+void CpuManager::SyncToHostImpl(CUdeviceptr src, void* dst, size_t size) {
+    std::memcpy(dst, reinterpret_cast<const void*>(src), size);
+}
+
+void CpuManager::SyncToDeviceImpl(void* src, CUdeviceptr dst, size_t size) {
+    std::memcpy(reinterpret_cast<void*>(dst), src, size);
+}
+
+// host copies complete before returning, so there is never an event to wait on
+bool CpuManager::SyncToHostAsyncImpl(CUdeviceptr src,
+                                     void* dst,
+                                     size_t size,
+                                     int,
+                                     int,
+                                     EventHandle* event) {
+    SyncToHostImpl(src, dst, size);
+    *event = nullptr;
+    return true;
+}
+
+bool CpuManager::SyncToDeviceAsyncImpl(const void* src,
+                                       CUdeviceptr dst,
+                                       size_t size,
+                                       int,
+                                       int,
+                                       EventHandle* event) {
+    std::memcpy(reinterpret_cast<void*>(dst), src, size);
+    *event = nullptr;
+    return true;
+}
+
+void CpuManager::Copy2DToHostImpl(CUdeviceptr src,
+                                  size_t src_pitch,
+                                  void* dst,
+                                  size_t dst_pitch,
+                                  size_t width,
+                                  size_t height) {
+    Copy2DToDeviceImpl(reinterpret_cast<const void*>(src), src_pitch,
+                       reinterpret_cast<CUdeviceptr>(dst), dst_pitch, width,
+                       height);
+}
+
+void CpuManager::Copy2DToDeviceImpl(const void* src,
+                                    size_t src_pitch,
+                                    CUdeviceptr dst,
+                                    size_t dst_pitch,
+                                    size_t width,
+                                    size_t height) {
+    const auto* from = static_cast<const char*>(src);
+    auto* to = reinterpret_cast<char*>(dst);
+    for (size_t row = 0; row < height; ++row) {
+        std::memcpy(to + row * dst_pitch, from + row * src_pitch, width);
+    }
+}
+
+void CpuManager::WaitEvent(EventHandle) {}
+
+void CpuManager::StreamWaitEvent(int, int, EventHandle) {}
+
+bool CpuManager::QueryEvent(EventHandle) { return true; }
+
+void CpuManager::ReleaseEvent(EventHandle) {}
+
+// launches and copies have finished when they return, every signal is reached
+SignalToken CpuManager::Signal(int, int) { return kNoSignal; }
+
+void CpuManager::Wait(int, int, SignalToken) {}
+
+bool CpuManager::QuerySignal(SignalToken) { return true; }
+
+void CpuManager::WaitSignal(SignalToken) {}
+
+void* CpuManager::FindKernelImpl(const char* name) {
+    HostKernel kernel = HostKernelRegistry::Instance().Find(name);
+    if (kernel == nullptr) return nullptr;
+    return reinterpret_cast<void*>(kernel);
+}
+
+// host kernels are registered at static initialization, nothing to load
+void CpuManager::PreloadImpl(const char* const*, int) {}
+
+// the launch domain is the packed bounds, there is no grid to compute
+void CpuManager::ConfigureLaunchImpl(BoundLaunch*) {}
+
+void CpuManager::SubmitLaunchImpl(BoundLaunch* launch) {
+    // host launches complete before returning, the stream is irrelevant
+    auto kernel = reinterpret_cast<HostKernel>(launch->kernel);
+    void** argv = launch->args.argv;
+    pool_.ParallelFor(launch->args.bounds.size, kHostLaunchGrain,
+                      [kernel, argv](size_t begin, size_t end) {
+                          kernel(argv, begin, end);
+                      });
+}
+
+bool CpuManager::SubmitBatchImpl(BoundLaunch* launches, int count) {
+    size_t total = 0;
+    for (int i = 0; i < count; ++i) { total += launches[i].args.bounds.size; }
+    if (total / count >= kHostLaunchGrain) {
+        for (int i = 0; i < count; ++i) { SubmitLaunchImpl(&launches[i]); }
+        return true;
+    }
+    // records too small to split are spread over the pool whole
+    size_t grain = kHostLaunchGrain / (total / count + 1) + 1;
+    pool_.ParallelFor(count, grain, [launches](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            auto kernel = reinterpret_cast<HostKernel>(launches[i].kernel);
+            kernel(launches[i].args.argv, 0, launches[i].args.bounds.size);
+        }
+    });
+    return true;
+}
+
+// host launches have no block shape, there is nothing to tune
+bool CpuManager::AutotuneLaunchImpl(BoundLaunch*, int) { return false; }
+
+// a host graph is the recorded op list itself, replay walks it in order
+bool CpuManager::BeginCaptureImpl(LaunchGraph*) { return true; }
+
+bool CpuManager::CaptureOpImpl(LaunchGraph*, GraphOp*) { return true; }
+
+bool CpuManager::EndCaptureImpl(LaunchGraph*) { return true; }
+
+bool CpuManager::ReplayGraphImpl(LaunchGraph* graph) {
+    for (auto& op : graph->ops) {
+        switch (op.kind) {
+            case GraphOp::KERNEL:
+                SubmitLaunchImpl(op.launch.get());
+                break;
+            case GraphOp::COPY_TO_DEVICE:
+                std::memcpy(reinterpret_cast<void*>(op.device), op.host,
+                            op.size);
+                break;
+            case GraphOp::COPY_TO_HOST:
+                std::memcpy(op.host, reinterpret_cast<const void*>(op.device),
+                            op.size);
+                break;
+        }
+    }
+    return true;
+}
+
+void CpuManager::ReleaseGraphImpl(LaunchGraph*) {}
+
+// device storage lives in the host arena too
+size_t CpuManager::TrimDeviceMemory() { return host_arena_.Trim(); }
+
+MemoryPoolStats CpuManager::GetDeviceMemoryStats() const { return {}; }
+
+CUcontext* CpuManager::GetCudaContext() { return &cu_context_; }
+CUdevice* CpuManager::GetCudaDevice() { return &cu_device_; }
+ICudaFunctionManager* CpuManager::GetCuda() const { return nullptr; }
+
+}  // namespace cudamgr
+}  // namespace dexsim
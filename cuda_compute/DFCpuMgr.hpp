@@ -0,0 +1,127 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) 2021-2025 DexForce Technology Co., Ltd.
+//
+// All rights reserved.
+// ----------------------------------------------------------------------------
+#pragma once
+
+#include <mutex>
+
+#include "DFCudaMgr.h"
+#include "DFHostKernels.h"
+#include "DFThreadPool.h"
+
+namespace dexsim {
+namespace cudamgr {
+
+/// \brief Host backend of ICudaManager.
+///
+/// "Device" memory is plain host memory, and Launch runs the kernel registered
+/// in HostKernelRegistry over the launch domain on a work-stealing thread pool.
+/// Launches are synchronous, streams are only tracked so that the stream family
+/// API behaves like on the CUDA backend.
+class CpuManager : public ICudaManager {
+public:
+    /// \param num_threads Number of worker threads, 0 means one per hardware
+    /// thread.
+    explicit CpuManager(unsigned num_threads = 0);
+
+    int CreateStreamInFamily(int stream_type) override;
+    void DeleteStreamFromFamily(int stream_type, int stream_id) override;
+    // priorities and blocking do not apply, pools only hand out IDs
+    bool ConfigureStreamPool(int stream_type,
+                             const StreamPoolConfig& config) override;
+    int AcquireStream(int stream_type) override;
+
+    void WaitEvent(EventHandle event) override;
+    void StreamWaitEvent(int stream_type,
+                         int stream_id,
+                         EventHandle event) override;
+    bool QueryEvent(EventHandle event) override;
+    void ReleaseEvent(EventHandle event) override;
+    SignalToken Signal(int stream_type, int stream_id) override;
+    void Wait(int stream_type, int stream_id, SignalToken token) override;
+    bool QuerySignal(SignalToken token) override;
+    void WaitSignal(SignalToken token) override;
+
+    bool RegisterHostMemory(void* ptr, size_t size) override;
+    void UnregisterHostMemory(void* ptr) override;
+
+    size_t TrimDeviceMemory() override;
+    MemoryPoolStats GetDeviceMemoryStats() const override;
+
+    CUdevice* GetCudaDevice() override;
+    CUcontext* GetCudaContext() override;
+    ICudaFunctionManager* GetCuda() const override;
+    void UnInit() override;
+
+protected:
+    void* AllocateHostMemoryImpl(size_t size, bool& pinned) override;
+    void ReleaseHostMemoryImpl(void* ptr, bool pinned) override;
+    void ReleaseArrayDataDeviceImpl(SharedDataGPU* gpuData) override;
+    void WaitStreamUseImpl(const SharedDataGPU* gpuData) override;
+    void AllocateDeviceMemoryImpl(CUdeviceptr* arr, size_t size) override;
+    void SyncToHostImpl(CUdeviceptr src, void* dst, size_t size) override;
+    void SyncToDeviceImpl(void* src, CUdeviceptr dst, size_t size) override;
+    bool SyncToHostAsyncImpl(CUdeviceptr src,
+                             void* dst,
+                             size_t size,
+                             int stream_type,
+                             int stream_id,
+                             EventHandle* event) override;
+    bool SyncToDeviceAsyncImpl(const void* src,
+                               CUdeviceptr dst,
+                               size_t size,
+                               int stream_type,
+                               int stream_id,
+                               EventHandle* event) override;
+    void Copy2DToHostImpl(CUdeviceptr src,
+                          size_t src_pitch,
+                          void* dst,
+                          size_t dst_pitch,
+                          size_t width,
+                          size_t height) override;
+    void Copy2DToDeviceImpl(const void* src,
+                            size_t src_pitch,
+                            CUdeviceptr dst,
+                            size_t dst_pitch,
+                            size_t width,
+                            size_t height) override;
+
+    void* FindKernelImpl(const char* name) override;
+    void PreloadImpl(const char* const* funcs, int count) override;
+    void ConfigureLaunchImpl(BoundLaunch* launch) override;
+    void SubmitLaunchImpl(BoundLaunch* launch) override;
+    bool SubmitBatchImpl(BoundLaunch* launches, int count) override;
+    bool AutotuneLaunchImpl(BoundLaunch* launch, int repeats) override;
+
+    bool BeginCaptureImpl(LaunchGraph* graph) override;
+    bool CaptureOpImpl(LaunchGraph* graph, GraphOp* op) override;
+    bool EndCaptureImpl(LaunchGraph* graph) override;
+    bool ReplayGraphImpl(LaunchGraph* graph) override;
+    void ReleaseGraphImpl(LaunchGraph* graph) override;
+
+private:
+    std::vector<bool>* GetStreamFamily(int stream_type);
+
+    // smallest number of elements worth handing to another worker
+    static constexpr size_t kHostLaunchGrain = 4096;
+
+    ThreadPool pool_;
+    CUdevice cu_device_ = 0;
+    CUcontext cu_context_ = nullptr;
+
+    // host launches are synchronous, a stream is just an occupied slot
+    std::vector<bool> rendering_stream_;
+    std::vector<bool> calculate_stream_;
+    std::vector<bool> geometry_stream_;
+    std::vector<bool> physics_stream_;
+    std::vector<bool> custom_stream_;
+    // pool streams are the first slots of a family
+    int pool_sizes_[CUSTOM_STREAM + 1] = {};
+    unsigned int next_pool_stream_[CUSTOM_STREAM + 1] = {};
+    std::mutex stream_mutex_;
+};
+
+}  // namespace cudamgr
+}  // namespace dexsim
@@ -14,12 +14,26 @@
 #define dlsym GetProcAddress
 #endif
 
+// a missing required entry point fails the whole load, so that the caller
+// falls back to the CPU backend instead of calling through a null pointer
 #define LOAD_CUDA_FUNCTION(name, version)                    \
     PFN_##name = reinterpret_cast<decltype(PFN_##name)>(     \
             dlsym(cuda_lib, #name version));                 \
     if (!PFN_##name) {                                       \
         std::cerr << "Error loading CUDA function " << #name \
                   << " (symbol not found)\n";                \
+        complete = false;                                    \
+    }
+
+// older drivers lack these, the manager checks HasFunction before relying on
+// them
+#define LOAD_OPTIONAL_CUDA_FUNCTION(name, version)            \
+    PFN_##name = reinterpret_cast<decltype(PFN_##name)>(      \
+            dlsym(cuda_lib, #name version));                  \
+    if (!PFN_##name) {                                        \
+        std::cerr << "Warning: optional CUDA function " << #name \
+                  << " not found\n";                          \
+        missing_.insert(#name);                               \
     }
 
 namespace dexsim {
@@ -37,10 +51,12 @@ CudaFunctionManager::CudaFunctionManager() {
         return;
     }
 
+    bool complete = true;
+
     // Driver and Initialization
     LOAD_CUDA_FUNCTION(cuDriverGetVersion, "");
     LOAD_CUDA_FUNCTION(cuInit, "");
-    LOAD_CUDA_FUNCTION(cuGetProcAddress, "");
+    LOAD_OPTIONAL_CUDA_FUNCTION(cuGetProcAddress, "");
 
     // Device Management
     LOAD_CUDA_FUNCTION(cuDeviceGetCount, "");
@@ -60,17 +76,35 @@ CudaFunctionManager::CudaFunctionManager() {
     LOAD_CUDA_FUNCTION(cuMemFree, "");
     LOAD_CUDA_FUNCTION(cuMemcpyHtoD, "");
     LOAD_CUDA_FUNCTION(cuMemcpyDtoH, "");
+    LOAD_CUDA_FUNCTION(cuMemcpyHtoDAsync, "_v2");
+    LOAD_CUDA_FUNCTION(cuMemcpyDtoHAsync, "_v2");
+    LOAD_CUDA_FUNCTION(cuMemcpy2D, "_v2");
+
+    // Page-Locked Host Memory
+    LOAD_CUDA_FUNCTION(cuMemHostAlloc, "");
+    LOAD_CUDA_FUNCTION(cuMemFreeHost, "");
+    LOAD_OPTIONAL_CUDA_FUNCTION(cuMemHostRegister, "_v2");
+    LOAD_OPTIONAL_CUDA_FUNCTION(cuMemHostUnregister, "");
 
     // Module and Kernel Execution
     LOAD_CUDA_FUNCTION(cuModuleLoadData, "");
     LOAD_CUDA_FUNCTION(cuModuleLoadDataEx, "");
     LOAD_CUDA_FUNCTION(cuModuleGetFunction, "");
+    LOAD_OPTIONAL_CUDA_FUNCTION(cuLinkCreate, "_v2");
+    LOAD_OPTIONAL_CUDA_FUNCTION(cuLinkAddData, "_v2");
+    LOAD_OPTIONAL_CUDA_FUNCTION(cuLinkComplete, "");
+    LOAD_OPTIONAL_CUDA_FUNCTION(cuLinkDestroy, "");
+    LOAD_OPTIONAL_CUDA_FUNCTION(cuFuncGetAttribute, "");
+    LOAD_OPTIONAL_CUDA_FUNCTION(cuOccupancyMaxPotentialBlockSize, "");
     LOAD_CUDA_FUNCTION(cuLaunchKernel, "");
 
     // Stream and Event Management
     LOAD_CUDA_FUNCTION(cuStreamCreate, "");
+    LOAD_OPTIONAL_CUDA_FUNCTION(cuStreamCreateWithPriority, "");
+    LOAD_OPTIONAL_CUDA_FUNCTION(cuCtxGetStreamPriorityRange, "");
     LOAD_CUDA_FUNCTION(cuStreamDestroy, "");
     LOAD_CUDA_FUNCTION(cuStreamSynchronize, "");
+    LOAD_CUDA_FUNCTION(cuStreamQuery, "");
     LOAD_CUDA_FUNCTION(cuEventCreate, "");
     LOAD_CUDA_FUNCTION(cuEventRecord, "");
     LOAD_CUDA_FUNCTION(cuStreamWaitEvent, "");
@@ -78,20 +112,39 @@ CudaFunctionManager::CudaFunctionManager() {
     // Event Management
     LOAD_CUDA_FUNCTION(cuEventDestroy, "");
     LOAD_CUDA_FUNCTION(cuEventSynchronize, "");
+    LOAD_CUDA_FUNCTION(cuEventQuery, "");
+    LOAD_OPTIONAL_CUDA_FUNCTION(cuEventElapsedTime, "");
+
+    // Graph Management
+    LOAD_OPTIONAL_CUDA_FUNCTION(cuStreamBeginCapture, "_v2");
+    LOAD_OPTIONAL_CUDA_FUNCTION(cuStreamEndCapture, "");
+    LOAD_OPTIONAL_CUDA_FUNCTION(cuStreamGetCaptureInfo, "_v2");
+    LOAD_OPTIONAL_CUDA_FUNCTION(cuGraphInstantiateWithFlags, "");
+    LOAD_OPTIONAL_CUDA_FUNCTION(cuGraphLaunch, "");
+    LOAD_OPTIONAL_CUDA_FUNCTION(cuGraphExecKernelNodeSetParams, "");
+    LOAD_OPTIONAL_CUDA_FUNCTION(cuGraphExecDestroy, "");
+    LOAD_OPTIONAL_CUDA_FUNCTION(cuGraphDestroy, "");
 
     // Pointer Attributes
-    LOAD_CUDA_FUNCTION(cuPointerGetAttribute, "");
+    LOAD_OPTIONAL_CUDA_FUNCTION(cuPointerGetAttribute, "");
 
     // Error Handling
     LOAD_CUDA_FUNCTION(cuGetErrorString, "");
 
+    if (!complete) {
+        std::cerr << "CUDA library lacks required functions, it is not used."
+                  << std::endl;
+        return;
+    }
+    loaded_ = true;
     std::cout << "CUDA library loaded successfully." << std::endl;
 }
 
 CudaFunctionManager::~CudaFunctionManager() {}
 
 extern "C" void cudaCodesMgr(ICudaFunctionManager** mgr) {
-    *mgr = &CudaFunctionManager::instance();
+    auto& instance = CudaFunctionManager::instance();
+    *mgr = instance.IsLoaded() ? &instance : nullptr;
 }
 }  // namespace cudamgr
 }  // namespace dexsim
\ No newline at end of file
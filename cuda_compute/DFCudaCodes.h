@@ -31,6 +31,10 @@ enum CUDA_CODES {
     CUDA_ERROR_DEINITIALIZED = 4,
     CUDA_ERROR_NO_DEVICE = 100,
     CUDA_ERROR_INVALID_DEVICE = 101,
+    CUDA_ERROR_INVALID_CONTEXT = 201,
+    CUDA_ERROR_INVALID_HANDLE = 400,
+    CUDA_ERROR_NOT_READY = 600,
+    CUDA_ERROR_NOT_SUPPORTED = 801,
     CU_GET_PROC_ADDRESS_DEFAULT = 0,
     CU_ENABLE_DEFAULT = 0,
 };
@@ -50,6 +54,64 @@ enum CUjit_option {
     CU_JIT_CACHE_MODE
 };
 
+enum CUjitInputType {
+    CU_JIT_INPUT_CUBIN = 0,
+    CU_JIT_INPUT_PTX = 1,
+    CU_JIT_INPUT_FATBINARY = 2,
+};
+
+enum CUstream_flags {
+    CU_STREAM_DEFAULT = 0x0,
+    CU_STREAM_NON_BLOCKING = 0x1,
+};
+
+enum CUevent_flags {
+    CU_EVENT_DEFAULT = 0x0,
+    CU_EVENT_BLOCKING_SYNC = 0x1,
+    CU_EVENT_DISABLE_TIMING = 0x2,
+};
+
+enum CUmemhost_flags {
+    CU_MEMHOSTALLOC_PORTABLE = 0x01,
+    CU_MEMHOSTREGISTER_PORTABLE = 0x01,
+};
+
+enum CUmemorytype {
+    CU_MEMORYTYPE_HOST = 0x01,
+    CU_MEMORYTYPE_DEVICE = 0x02,
+    CU_MEMORYTYPE_ARRAY = 0x03,
+    CU_MEMORYTYPE_UNIFIED = 0x04,
+};
+
+enum CUdevice_attribute {
+    CU_DEVICE_ATTRIBUTE_MAX_THREADS_PER_BLOCK = 1,
+    CU_DEVICE_ATTRIBUTE_WARP_SIZE = 10,
+    CU_DEVICE_ATTRIBUTE_MULTIPROCESSOR_COUNT = 16,
+    CU_DEVICE_ATTRIBUTE_MAX_THREADS_PER_MULTIPROCESSOR = 39,
+    CU_DEVICE_ATTRIBUTE_COMPUTE_CAPABILITY_MAJOR = 75,
+    CU_DEVICE_ATTRIBUTE_COMPUTE_CAPABILITY_MINOR = 76,
+};
+
+enum CUfunction_attribute {
+    CU_FUNC_ATTRIBUTE_MAX_THREADS_PER_BLOCK = 0,
+    CU_FUNC_ATTRIBUTE_SHARED_SIZE_BYTES = 1,
+    CU_FUNC_ATTRIBUTE_CONST_SIZE_BYTES = 2,
+    CU_FUNC_ATTRIBUTE_LOCAL_SIZE_BYTES = 3,
+    CU_FUNC_ATTRIBUTE_NUM_REGS = 4,
+};
+
+enum CUstreamCaptureMode {
+    CU_STREAM_CAPTURE_MODE_GLOBAL = 0,
+    CU_STREAM_CAPTURE_MODE_THREAD_LOCAL = 1,
+    CU_STREAM_CAPTURE_MODE_RELAXED = 2,
+};
+
+enum CUstreamCaptureStatus {
+    CU_STREAM_CAPTURE_STATUS_NONE = 0,
+    CU_STREAM_CAPTURE_STATUS_ACTIVE = 1,
+    CU_STREAM_CAPTURE_STATUS_INVALIDATED = 2,
+};
+
 // CUDA types
 using CUGraphicsResource_t = struct cudaGraphicsResource*;
 using CUstream = struct CUstream_st*;
@@ -61,9 +123,56 @@ using CUfunction = struct CUfunc_st*;
 using CUdevice_v1 = int;
 using CUevent = struct CUevent_st*;
 using CUdevice = CUdevice_v1;
+using CUgraph = struct CUgraph_st*;
+using CUgraphExec = struct CUgraphExec_st*;
+using CUgraphNode = struct CUgraphNode_st*;
+using CUlinkState = struct CUlinkState_st*;
+using CUarray = struct CUarray_st*;
+// dynamic shared memory needed by a block of the given size
+using CUoccupancyB2DSize = size_t (*)(int blockSize);
+
+struct CUDA_KERNEL_NODE_PARAMS {
+    CUfunction func;
+    unsigned int gridDimX;
+    unsigned int gridDimY;
+    unsigned int gridDimZ;
+    unsigned int blockDimX;
+    unsigned int blockDimY;
+    unsigned int blockDimZ;
+    unsigned int sharedMemBytes;
+    void** kernelParams;
+    void** extra;
+};
+
+struct CUDA_MEMCPY2D {
+    size_t srcXInBytes;
+    size_t srcY;
+    CUmemorytype srcMemoryType;
+    const void* srcHost;
+    CUdeviceptr srcDevice;
+    CUarray srcArray;
+    size_t srcPitch;
+    size_t dstXInBytes;
+    size_t dstY;
+    CUmemorytype dstMemoryType;
+    void* dstHost;
+    CUdeviceptr dstDevice;
+    CUarray dstArray;
+    size_t dstPitch;
+    size_t WidthInBytes;
+    size_t Height;
+};
 
 class ICudaFunctionManager {
 public:
+    /// \brief Whether the driver provides an optional entry point
+    ///
+    /// Calls to a missing one return CUDA_ERROR_NOT_SUPPORTED. Required entry
+    /// points are always present.
+    ///
+    /// \param name Name of the entry point, e.g. "cuGraphLaunch"
+    virtual bool HasFunction(const char* /*name*/) const { return true; }
+
     ICUDA_API(cuDriverGetVersion, (int* version), (version))
     ICUDA_API(cuInit, (unsigned int flags), (flags))
     ICUDA_API(cuGetProcAddress,
@@ -98,6 +207,29 @@ public:
     ICUDA_API(cuMemcpyDtoH,
               (void* dstHost, CUdeviceptr srcDevice, size_t ByteCount),
               (dstHost, srcDevice, ByteCount))
+    ICUDA_API(cuMemcpyHtoDAsync,
+              (CUdeviceptr dstDevice,
+               const void* srcHost,
+               size_t ByteCount,
+               CUstream hStream),
+              (dstDevice, srcHost, ByteCount, hStream))
+    ICUDA_API(cuMemcpyDtoHAsync,
+              (void* dstHost,
+               CUdeviceptr srcDevice,
+               size_t ByteCount,
+               CUstream hStream),
+              (dstHost, srcDevice, ByteCount, hStream))
+    ICUDA_API(cuMemcpy2D, (const CUDA_MEMCPY2D* pCopy), (pCopy))
+
+    // Page-Locked Host Memory
+    ICUDA_API(cuMemHostAlloc,
+              (void** pp, size_t bytesize, unsigned int Flags),
+              (pp, bytesize, Flags))
+    ICUDA_API(cuMemFreeHost, (void* p), (p))
+    ICUDA_API(cuMemHostRegister,
+              (void* p, size_t bytesize, unsigned int Flags),
+              (p, bytesize, Flags))
+    ICUDA_API(cuMemHostUnregister, (void* p), (p))
 
     // Module and Kernel Control
     ICUDA_API(cuModuleLoadData,
@@ -110,6 +242,42 @@ public:
     ICUDA_API(cuModuleGetFunction,
               (CUfunction * hfunc, CUmodule hmod, const char* name),
               (hfunc, hmod, name))
+    ICUDA_API(cuLinkCreate,
+              (unsigned int numOptions,
+               CUjit_option* options,
+               void** optionValues,
+               CUlinkState* stateOut),
+              (numOptions, options, optionValues, stateOut))
+    ICUDA_API(cuLinkAddData,
+              (CUlinkState state,
+               CUjitInputType type,
+               void* data,
+               size_t size,
+               const char* name,
+               unsigned int numOptions,
+               CUjit_option* options,
+               void** optionValues),
+              (state, type, data, size, name, numOptions, options, optionValues))
+    ICUDA_API(cuLinkComplete,
+              (CUlinkState state, void** cubinOut, size_t* sizeOut),
+              (state, cubinOut, sizeOut))
+    ICUDA_API(cuLinkDestroy, (CUlinkState state), (state))
+    ICUDA_API(cuFuncGetAttribute,
+              (int* pi, CUfunction_attribute attrib, CUfunction hfunc),
+              (pi, attrib, hfunc))
+    ICUDA_API(cuOccupancyMaxPotentialBlockSize,
+              (int* minGridSize,
+               int* blockSize,
+               CUfunction func,
+               CUoccupancyB2DSize blockSizeToDynamicSMemSize,
+               size_t dynamicSMemSize,
+               int blockSizeLimit),
+              (minGridSize,
+               blockSize,
+               func,
+               blockSizeToDynamicSMemSize,
+               dynamicSMemSize,
+               blockSizeLimit))
     ICUDA_API(cuLaunchKernel,
               (CUfunction f,
                unsigned int gridDimX,
@@ -138,8 +306,15 @@ public:
     ICUDA_API(cuStreamCreate,
               (CUstream * stream, unsigned int flags),
               (stream, flags))
+    ICUDA_API(cuStreamCreateWithPriority,
+              (CUstream * stream, unsigned int flags, int priority),
+              (stream, flags, priority))
+    ICUDA_API(cuCtxGetStreamPriorityRange,
+              (int* leastPriority, int* greatestPriority),
+              (leastPriority, greatestPriority))
     ICUDA_API(cuStreamDestroy, (CUstream stream), (stream))
     ICUDA_API(cuStreamSynchronize, (CUstream stream), (stream))
+    ICUDA_API(cuStreamQuery, (CUstream stream), (stream))
     ICUDA_API(cuEventCreate,
               (CUevent * event, unsigned int flags),
               (event, flags))
@@ -155,6 +330,41 @@ public:
     ICUDA_API(cuEventRecord, (CUevent event, CUstream stream), (event, stream))
     ICUDA_API(cuEventDestroy, (CUevent event), (event))
     ICUDA_API(cuEventSynchronize, (CUevent event), (event))
+    ICUDA_API(cuEventQuery, (CUevent event), (event))
+    ICUDA_API(cuEventElapsedTime,
+              (float* pMilliseconds, CUevent hStart, CUevent hEnd),
+              (pMilliseconds, hStart, hEnd))
+
+    // Graph Management
+    ICUDA_API(cuStreamBeginCapture,
+              (CUstream stream, CUstreamCaptureMode mode),
+              (stream, mode))
+    ICUDA_API(cuStreamEndCapture,
+              (CUstream stream, CUgraph * phGraph),
+              (stream, phGraph))
+    ICUDA_API(cuStreamGetCaptureInfo,
+              (CUstream stream,
+               CUstreamCaptureStatus * captureStatus,
+               unsigned long long* id,
+               CUgraph* graph,
+               const CUgraphNode** dependencies,
+               size_t* numDependencies),
+              (stream, captureStatus, id, graph, dependencies, numDependencies))
+    ICUDA_API(cuGraphInstantiateWithFlags,
+              (CUgraphExec * phGraphExec,
+               CUgraph hGraph,
+               unsigned long long flags),
+              (phGraphExec, hGraph, flags))
+    ICUDA_API(cuGraphLaunch,
+              (CUgraphExec hGraphExec, CUstream hStream),
+              (hGraphExec, hStream))
+    ICUDA_API(cuGraphExecKernelNodeSetParams,
+              (CUgraphExec hGraphExec,
+               CUgraphNode hNode,
+               const CUDA_KERNEL_NODE_PARAMS* nodeParams),
+              (hGraphExec, hNode, nodeParams))
+    ICUDA_API(cuGraphExecDestroy, (CUgraphExec hGraphExec), (hGraphExec))
+    ICUDA_API(cuGraphDestroy, (CUgraph hGraph), (hGraph))
 
     // Pointer Attributes
     ICUDA_API(cuPointerGetAttribute,
@@ -5,11 +5,19 @@
 // ----------------------------------------------------------------------------
 
 #pragma once
+#include <string>
+#include <unordered_set>
+
 #include "DFCudaCodes.h"
 
-#define CUDA_API_FUNC(name, DECL, ARGS) \
-    CUDA_CODES(*PFN_##name) DECL;       \
-    CUDA_CODES name DECL { return PFN_##name ARGS; }
+// optional entry points may be missing from the driver, their pointer is
+// then null
+#define CUDA_API_FUNC(name, DECL, ARGS)                                  \
+    CUDA_CODES(*PFN_##name) DECL = nullptr;                              \
+    CUDA_CODES name DECL {                                               \
+        return PFN_##name != nullptr ? PFN_##name ARGS                   \
+                                     : CUDA_ERROR_NOT_SUPPORTED;         \
+    }
 
 namespace dexsim {
 namespace cudamgr {
@@ -21,12 +29,24 @@ public:
         return instance;
     }
 
+    /// \brief Whether the driver library was found and provides every
+    /// required entry point
+    bool IsLoaded() const { return loaded_; }
+
+    bool HasFunction(const char* name) const override {
+        return missing_.count(name) == 0;
+    }
+
 private:
     CudaFunctionManager();
     ~CudaFunctionManager();
     CudaFunctionManager(const CudaFunctionManager&) = delete;
     CudaFunctionManager& operator=(const CudaFunctionManager&) = delete;
 
+    bool loaded_ = false;
+    // optional entry points the driver does not provide
+    std::unordered_set<std::string> missing_;
+
     // Driver Management
     CUDA_API_FUNC(cuDriverGetVersion, (int* version), (version))
     CUDA_API_FUNC(cuInit, (unsigned int flags), (flags))
@@ -67,6 +87,29 @@ private:
     CUDA_API_FUNC(cuMemcpyDtoH,
                   (void* dstHost, CUdeviceptr srcDevice, size_t ByteCount),
                   (dstHost, srcDevice, ByteCount))
+    CUDA_API_FUNC(cuMemcpyHtoDAsync,
+                  (CUdeviceptr dstDevice,
+                   const void* srcHost,
+                   size_t ByteCount,
+                   CUstream hStream),
+                  (dstDevice, srcHost, ByteCount, hStream))
+    CUDA_API_FUNC(cuMemcpyDtoHAsync,
+                  (void* dstHost,
+                   CUdeviceptr srcDevice,
+                   size_t ByteCount,
+                   CUstream hStream),
+                  (dstHost, srcDevice, ByteCount, hStream))
+    CUDA_API_FUNC(cuMemcpy2D, (const CUDA_MEMCPY2D* pCopy), (pCopy))
+
+    // Page-Locked Host Memory
+    CUDA_API_FUNC(cuMemHostAlloc,
+                  (void** pp, size_t bytesize, unsigned int Flags),
+                  (pp, bytesize, Flags))
+    CUDA_API_FUNC(cuMemFreeHost, (void* p), (p))
+    CUDA_API_FUNC(cuMemHostRegister,
+                  (void* p, size_t bytesize, unsigned int Flags),
+                  (p, bytesize, Flags))
+    CUDA_API_FUNC(cuMemHostUnregister, (void* p), (p))
 
     // Module and Kernel Control
     CUDA_API_FUNC(cuModuleLoadData,
@@ -82,6 +125,49 @@ private:
     CUDA_API_FUNC(cuModuleGetFunction,
                   (CUfunction * hfunc, CUmodule hmod, const char* name),
                   (hfunc, hmod, name))
+    CUDA_API_FUNC(cuLinkCreate,
+                  (unsigned int numOptions,
+                   CUjit_option* options,
+                   void** optionValues,
+                   CUlinkState* stateOut),
+                  (numOptions, options, optionValues, stateOut))
+    CUDA_API_FUNC(cuLinkAddData,
+                  (CUlinkState state,
+                   CUjitInputType type,
+                   void* data,
+                   size_t size,
+                   const char* name,
+                   unsigned int numOptions,
+                   CUjit_option* options,
+                   void** optionValues),
+                  (state,
+                   type,
+                   data,
+                   size,
+                   name,
+                   numOptions,
+                   options,
+                   optionValues))
+    CUDA_API_FUNC(cuLinkComplete,
+                  (CUlinkState state, void** cubinOut, size_t* sizeOut),
+                  (state, cubinOut, sizeOut))
+    CUDA_API_FUNC(cuLinkDestroy, (CUlinkState state), (state))
+    CUDA_API_FUNC(cuFuncGetAttribute,
+                  (int* pi, CUfunction_attribute attrib, CUfunction hfunc),
+                  (pi, attrib, hfunc))
+    CUDA_API_FUNC(cuOccupancyMaxPotentialBlockSize,
+                  (int* minGridSize,
+                   int* blockSize,
+                   CUfunction func,
+                   CUoccupancyB2DSize blockSizeToDynamicSMemSize,
+                   size_t dynamicSMemSize,
+                   int blockSizeLimit),
+                  (minGridSize,
+                   blockSize,
+                   func,
+                   blockSizeToDynamicSMemSize,
+                   dynamicSMemSize,
+                   blockSizeLimit))
     CUDA_API_FUNC(cuLaunchKernel,
                   (CUfunction f,
                    unsigned int gridDimX,
@@ -110,8 +196,15 @@ private:
     CUDA_API_FUNC(cuStreamCreate,
                   (CUstream * stream, unsigned int flags),
                   (stream, flags))
+    CUDA_API_FUNC(cuStreamCreateWithPriority,
+                  (CUstream * stream, unsigned int flags, int priority),
+                  (stream, flags, priority))
+    CUDA_API_FUNC(cuCtxGetStreamPriorityRange,
+                  (int* leastPriority, int* greatestPriority),
+                  (leastPriority, greatestPriority))
     CUDA_API_FUNC(cuStreamDestroy, (CUstream stream), (stream))
     CUDA_API_FUNC(cuStreamSynchronize, (CUstream stream), (stream))
+    CUDA_API_FUNC(cuStreamQuery, (CUstream stream), (stream))
     CUDA_API_FUNC(cuEventCreate,
                   (CUevent * event, unsigned int flags),
                   (event, flags))
@@ -129,6 +222,46 @@ private:
     // Event Management
     CUDA_API_FUNC(cuEventDestroy, (CUevent event), (event))
     CUDA_API_FUNC(cuEventSynchronize, (CUevent event), (event))
+    CUDA_API_FUNC(cuEventQuery, (CUevent event), (event))
+    CUDA_API_FUNC(cuEventElapsedTime,
+                  (float* pMilliseconds, CUevent hStart, CUevent hEnd),
+                  (pMilliseconds, hStart, hEnd))
+
+    // Graph Management
+    CUDA_API_FUNC(cuStreamBeginCapture,
+                  (CUstream stream, CUstreamCaptureMode mode),
+                  (stream, mode))
+    CUDA_API_FUNC(cuStreamEndCapture,
+                  (CUstream stream, CUgraph * phGraph),
+                  (stream, phGraph))
+    CUDA_API_FUNC(cuStreamGetCaptureInfo,
+                  (CUstream stream,
+                   CUstreamCaptureStatus * captureStatus,
+                   unsigned long long* id,
+                   CUgraph* graph,
+                   const CUgraphNode** dependencies,
+                   size_t* numDependencies),
+                  (stream,
+                   captureStatus,
+                   id,
+                   graph,
+                   dependencies,
+                   numDependencies))
+    CUDA_API_FUNC(cuGraphInstantiateWithFlags,
+                  (CUgraphExec * phGraphExec,
+                   CUgraph hGraph,
+                   unsigned long long flags),
+                  (phGraphExec, hGraph, flags))
+    CUDA_API_FUNC(cuGraphLaunch,
+                  (CUgraphExec hGraphExec, CUstream hStream),
+                  (hGraphExec, hStream))
+    CUDA_API_FUNC(cuGraphExecKernelNodeSetParams,
+                  (CUgraphExec hGraphExec,
+                   CUgraphNode hNode,
+                   const CUDA_KERNEL_NODE_PARAMS* nodeParams),
+                  (hGraphExec, hNode, nodeParams))
+    CUDA_API_FUNC(cuGraphExecDestroy, (CUgraphExec hGraphExec), (hGraphExec))
+    CUDA_API_FUNC(cuGraphDestroy, (CUgraph hGraph), (hGraph))
 
     CUDA_API_FUNC(cuPointerGetAttribute,
                   (int* data, int attribute, CUdeviceptr ptr),
@@ -0,0 +1,688 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) 2021-2025 DexForce Technology Co., Ltd.
+//
+// All rights reserved.
+// ----------------------------------------------------------------------------
+#include "DFCudaHostCodes.hpp"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace dexsim {
+namespace cudamgr {
+
+HostFunctionManager::~HostFunctionManager() {
+    for (auto& allocation : allocations_) {
+        std::free(reinterpret_cast<void*>(allocation.first));
+    }
+}
+
+// Driver Management
+CUDA_CODES HostFunctionManager::cuDriverGetVersion(int* version) {
+    *version = 12000;
+    return CUDA_SUCCESS;
+}
+
+CUDA_CODES HostFunctionManager::cuInit(unsigned int) { return CUDA_SUCCESS; }
+
+CUDA_CODES HostFunctionManager::cuGetProcAddress(const char*,
+                                                 void** pfn,
+                                                 int,
+                                                 uint64_t) {
+    *pfn = nullptr;
+    return CUDA_ERROR_INVALID_VALUE;
+}
+
+// Device Management
+CUDA_CODES HostFunctionManager::cuDeviceGetCount(int* count) {
+    *count = 1;
+    return CUDA_SUCCESS;
+}
+
+CUDA_CODES HostFunctionManager::cuDeviceGet(CUdevice* device, int ordinal) {
+    if (ordinal != 0) return CUDA_ERROR_INVALID_DEVICE;
+    *device = 0;
+    return CUDA_SUCCESS;
+}
+
+CUDA_CODES HostFunctionManager::cuDeviceGetName(char* name,
+                                                int len,
+                                                CUdevice) {
+    std::strncpy(name, "Host stand-in device", len);
+    if (len > 0) name[len - 1] = '\0';
+    return CUDA_SUCCESS;
+}
+
+CUDA_CODES HostFunctionManager::cuDeviceGetAttribute(int* pi,
+                                                     int attr,
+                                                     CUdevice) {
+    // a small device, enough for the manager's launch sizing
+    switch (attr) {
+        case CU_DEVICE_ATTRIBUTE_MAX_THREADS_PER_BLOCK:
+            *pi = 1024;
+            break;
+        case CU_DEVICE_ATTRIBUTE_WARP_SIZE:
+            *pi = 32;
+            break;
+        case CU_DEVICE_ATTRIBUTE_MULTIPROCESSOR_COUNT:
+            *pi = 8;
+            break;
+        case CU_DEVICE_ATTRIBUTE_MAX_THREADS_PER_MULTIPROCESSOR:
+            *pi = 2048;
+            break;
+        case CU_DEVICE_ATTRIBUTE_COMPUTE_CAPABILITY_MAJOR:
+            *pi = 8;
+            break;
+        case CU_DEVICE_ATTRIBUTE_COMPUTE_CAPABILITY_MINOR:
+            *pi = 6;
+            break;
+        default:
+            *pi = 0;
+            break;
+    }
+    return CUDA_SUCCESS;
+}
+
+// Context Management
+CUDA_CODES HostFunctionManager::cuCtxCreate(CUcontext* pctx,
+                                            unsigned int,
+                                            CUdevice) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    *pctx = NewHandle<CUcontext>();
+    current_contexts_[std::this_thread::get_id()] = *pctx;
+    return CUDA_SUCCESS;
+}
+
+CUDA_CODES HostFunctionManager::cuCtxGetCurrent(CUcontext* pctx) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = current_contexts_.find(std::this_thread::get_id());
+    *pctx = it == current_contexts_.end() ? nullptr : it->second;
+    return CUDA_SUCCESS;
+}
+
+CUDA_CODES HostFunctionManager::cuCtxSynchronize() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    held_events_.clear();
+    return CUDA_SUCCESS;
+}
+
+CUDA_CODES HostFunctionManager::cuCtxSetCurrent(CUcontext ctx) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    current_contexts_[std::this_thread::get_id()] = ctx;
+    return CUDA_SUCCESS;
+}
+
+CUDA_CODES HostFunctionManager::cuDevicePrimaryCtxRetain(CUcontext* pctx,
+                                                         CUdevice dev) {
+    return cuCtxCreate(pctx, 0, dev);
+}
+
+// Memory Management
+CUDA_CODES HostFunctionManager::cuMemAlloc(CUdeviceptr* dptr,
+                                           size_t bytesize) {
+    if (bytesize == 0) return CUDA_ERROR_INVALID_VALUE;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (current_contexts_.count(std::this_thread::get_id()) == 0) {
+        return CUDA_ERROR_INVALID_CONTEXT;
+    }
+    void* data = std::malloc(bytesize);
+    if (data == nullptr) return CUDA_ERROR_OUT_OF_MEMORY;
+    *dptr = reinterpret_cast<CUdeviceptr>(data);
+    allocations_[*dptr] = bytesize;
+    ++alloc_count_;
+    bytes_allocated_ += bytesize;
+    return CUDA_SUCCESS;
+}
+
+CUDA_CODES HostFunctionManager::cuMemFree(CUdeviceptr dptr) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = allocations_.find(dptr);
+    if (it == allocations_.end()) return CUDA_ERROR_INVALID_VALUE;
+    bytes_allocated_ -= it->second;
+    allocations_.erase(it);
+    ++free_count_;
+    std::free(reinterpret_cast<void*>(dptr));
+    return CUDA_SUCCESS;
+}
+
+CUDA_CODES HostFunctionManager::cuMemcpyHtoD(CUdeviceptr dstDevice,
+                                             const void* srcHost,
+                                             size_t ByteCount) {
+    std::memcpy(reinterpret_cast<void*>(dstDevice), srcHost, ByteCount);
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++copy_count_;
+    return CUDA_SUCCESS;
+}
+
+CUDA_CODES HostFunctionManager::cuMemcpyDtoH(void* dstHost,
+                                             CUdeviceptr srcDevice,
+                                             size_t ByteCount) {
+    std::memcpy(dstHost, reinterpret_cast<const void*>(srcDevice), ByteCount);
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++copy_count_;
+    return CUDA_SUCCESS;
+}
+
+// streams complete work immediately, so async copies are plain copies
+CUDA_CODES HostFunctionManager::cuMemcpyHtoDAsync(CUdeviceptr dstDevice,
+                                                  const void* srcHost,
+                                                  size_t ByteCount,
+                                                  CUstream hStream) {
+    GraphNode node;
+    node.dst = reinterpret_cast<void*>(dstDevice);
+    node.src = srcHost;
+    node.copy_size = ByteCount;
+    if (Capture(hStream, node)) return CUDA_SUCCESS;
+    return cuMemcpyHtoD(dstDevice, srcHost, ByteCount);
+}
+
+CUDA_CODES HostFunctionManager::cuMemcpyDtoHAsync(void* dstHost,
+                                                  CUdeviceptr srcDevice,
+                                                  size_t ByteCount,
+                                                  CUstream hStream) {
+    GraphNode node;
+    node.dst = dstHost;
+    node.src = reinterpret_cast<const void*>(srcDevice);
+    node.copy_size = ByteCount;
+    if (Capture(hStream, node)) return CUDA_SUCCESS;
+    return cuMemcpyDtoH(dstHost, srcDevice, ByteCount);
+}
+
+// host and device pointers are both plain addresses, copied row by row
+CUDA_CODES HostFunctionManager::cuMemcpy2D(const CUDA_MEMCPY2D* pCopy) {
+    auto address = [](CUmemorytype type, const void* host, CUdeviceptr device,
+                      size_t x, size_t y, size_t pitch) -> char* {
+        const void* base = type == CU_MEMORYTYPE_HOST
+                                   ? host
+                                   : reinterpret_cast<const void*>(device);
+        return const_cast<char*>(static_cast<const char*>(base)) + y * pitch +
+               x;
+    };
+    if (pCopy == nullptr || pCopy->srcMemoryType == CU_MEMORYTYPE_ARRAY ||
+        pCopy->dstMemoryType == CU_MEMORYTYPE_ARRAY ||
+        (pCopy->Height > 1 && (pCopy->srcPitch < pCopy->WidthInBytes ||
+                               pCopy->dstPitch < pCopy->WidthInBytes))) {
+        return CUDA_ERROR_INVALID_VALUE;
+    }
+    const char* src = address(pCopy->srcMemoryType, pCopy->srcHost,
+                              pCopy->srcDevice, pCopy->srcXInBytes,
+                              pCopy->srcY, pCopy->srcPitch);
+    char* dst = address(pCopy->dstMemoryType, pCopy->dstHost,
+                        pCopy->dstDevice, pCopy->dstXInBytes, pCopy->dstY,
+                        pCopy->dstPitch);
+    for (size_t row = 0; row < pCopy->Height; ++row) {
+        std::memcpy(dst + row * pCopy->dstPitch, src + row * pCopy->srcPitch,
+                    pCopy->WidthInBytes);
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++copy_count_;
+    return CUDA_SUCCESS;
+}
+
+// Page-Locked Host Memory
+CUDA_CODES HostFunctionManager::cuMemHostAlloc(void** pp,
+                                               size_t bytesize,
+                                               unsigned int) {
+    if (bytesize == 0) return CUDA_ERROR_INVALID_VALUE;
+    *pp = std::malloc(bytesize);
+    if (*pp == nullptr) return CUDA_ERROR_OUT_OF_MEMORY;
+    std::lock_guard<std::mutex> lock(mutex_);
+    pinned_[*pp] = bytesize;
+    pinned_bytes_ += bytesize;
+    return CUDA_SUCCESS;
+}
+
+CUDA_CODES HostFunctionManager::cuMemFreeHost(void* p) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = pinned_.find(p);
+    if (it == pinned_.end()) return CUDA_ERROR_INVALID_VALUE;
+    pinned_bytes_ -= it->second;
+    pinned_.erase(it);
+    std::free(p);
+    return CUDA_SUCCESS;
+}
+
+CUDA_CODES HostFunctionManager::cuMemHostRegister(void* p,
+                                                  size_t bytesize,
+                                                  unsigned int) {
+    if (p == nullptr || bytesize == 0) return CUDA_ERROR_INVALID_VALUE;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (pinned_.count(p) != 0) return CUDA_ERROR_INVALID_VALUE;
+    pinned_[p] = bytesize;
+    pinned_bytes_ += bytesize;
+    return CUDA_SUCCESS;
+}
+
+CUDA_CODES HostFunctionManager::cuMemHostUnregister(void* p) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = pinned_.find(p);
+    if (it == pinned_.end()) return CUDA_ERROR_INVALID_VALUE;
+    pinned_bytes_ -= it->second;
+    pinned_.erase(it);
+    return CUDA_SUCCESS;
+}
+
+// Module and Kernel Control
+CUDA_CODES HostFunctionManager::cuModuleLoadData(CUmodule* module,
+                                                 const void* image) {
+    return cuModuleLoadDataEx(module, image, 0, nullptr, nullptr);
+}
+
+CUDA_CODES HostFunctionManager::cuModuleLoadDataEx(CUmodule* module,
+                                                   const void* image,
+                                                   unsigned int,
+                                                   CUjit_option*,
+                                                   void**) {
+    if (image == nullptr) return CUDA_ERROR_INVALID_VALUE;
+    std::lock_guard<std::mutex> lock(mutex_);
+    *module = NewHandle<CUmodule>();
+    ++module_load_count_;
+    return CUDA_SUCCESS;
+}
+
+CUDA_CODES HostFunctionManager::cuModuleGetFunction(CUfunction* hfunc,
+                                                    CUmodule hmod,
+                                                    const char* name) {
+    if (hmod == nullptr || name == nullptr) return CUDA_ERROR_INVALID_VALUE;
+    std::lock_guard<std::mutex> lock(mutex_);
+    *hfunc = NewHandle<CUfunction>();
+    return CUDA_SUCCESS;
+}
+
+namespace {
+// A linked "cubin" is the PTX behind a fixed tag, enough for the module cache
+// to tell compiled images from source.
+constexpr char kHostCubinTag[] = "HOSTCUBIN";
+}  // namespace
+
+CUDA_CODES HostFunctionManager::cuLinkCreate(unsigned int,
+                                             CUjit_option*,
+                                             void**,
+                                             CUlinkState* stateOut) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    *stateOut = NewHandle<CUlinkState>();
+    links_[*stateOut].assign(kHostCubinTag,
+                             kHostCubinTag + sizeof(kHostCubinTag));
+    return CUDA_SUCCESS;
+}
+
+CUDA_CODES HostFunctionManager::cuLinkAddData(CUlinkState state,
+                                              CUjitInputType,
+                                              void* data,
+                                              size_t size,
+                                              const char*,
+                                              unsigned int,
+                                              CUjit_option*,
+                                              void**) {
+    if (data == nullptr) return CUDA_ERROR_INVALID_VALUE;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = links_.find(state);
+    if (it == links_.end()) return CUDA_ERROR_INVALID_VALUE;
+    const char* bytes = static_cast<const char*>(data);
+    it->second.insert(it->second.end(), bytes, bytes + size);
+    return CUDA_SUCCESS;
+}
+
+CUDA_CODES HostFunctionManager::cuLinkComplete(CUlinkState state,
+                                               void** cubinOut,
+                                               size_t* sizeOut) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = links_.find(state);
+    if (it == links_.end()) return CUDA_ERROR_INVALID_VALUE;
+    // owned by the link state, like the driver's output
+    *cubinOut = it->second.data();
+    *sizeOut = it->second.size();
+    ++link_count_;
+    return CUDA_SUCCESS;
+}
+
+CUDA_CODES HostFunctionManager::cuLinkDestroy(CUlinkState state) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    links_.erase(state);
+    return CUDA_SUCCESS;
+}
+
+CUDA_CODES HostFunctionManager::cuFuncGetAttribute(int* pi,
+                                                   CUfunction_attribute attrib,
+                                                   CUfunction hfunc) {
+    if (hfunc == nullptr) return CUDA_ERROR_INVALID_VALUE;
+    switch (attrib) {
+        case CU_FUNC_ATTRIBUTE_MAX_THREADS_PER_BLOCK:
+            *pi = 1024;
+            break;
+        case CU_FUNC_ATTRIBUTE_NUM_REGS:
+            *pi = 32;
+            break;
+        default:
+            *pi = 0;
+            break;
+    }
+    return CUDA_SUCCESS;
+}
+
+CUDA_CODES HostFunctionManager::cuOccupancyMaxPotentialBlockSize(
+        int* minGridSize,
+        int* blockSize,
+        CUfunction func,
+        CUoccupancyB2DSize,
+        size_t,
+        int blockSizeLimit) {
+    if (func == nullptr) return CUDA_ERROR_INVALID_VALUE;
+    // what a 32-register kernel gets on most devices
+    *blockSize = blockSizeLimit > 0 && blockSizeLimit < 256 ? blockSizeLimit
+                                                            : 256;
+    // one full wave on the device reported by cuDeviceGetAttribute
+    *minGridSize = 8 * (2048 / *blockSize);
+    return CUDA_SUCCESS;
+}
+
+CUDA_CODES HostFunctionManager::cuLaunchKernel(CUfunction f,
+                                               unsigned int gridDimX,
+                                               unsigned int gridDimY,
+                                               unsigned int gridDimZ,
+                                               unsigned int blockDimX,
+                                               unsigned int blockDimY,
+                                               unsigned int blockDimZ,
+                                               unsigned int,
+                                               CUstream hStream,
+                                               void** kernelParams,
+                                               void**) {
+    if (f == nullptr) return CUDA_ERROR_INVALID_VALUE;
+    GraphNode node;
+    node.func = f;
+    node.params = kernelParams;
+    if (Capture(hStream, node)) return CUDA_SUCCESS;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (current_contexts_.count(std::this_thread::get_id()) == 0) {
+        return CUDA_ERROR_INVALID_CONTEXT;
+    }
+    // a destroyed stream is no longer a valid handle
+    if (hStream != nullptr && streams_.count(hStream) == 0) {
+        return CUDA_ERROR_INVALID_HANDLE;
+    }
+    last_kernel_params_ = kernelParams;
+    last_grid_dim_[0] = gridDimX;
+    last_grid_dim_[1] = gridDimY;
+    last_grid_dim_[2] = gridDimZ;
+    last_block_dim_[0] = blockDimX;
+    last_block_dim_[1] = blockDimY;
+    last_block_dim_[2] = blockDimZ;
+    ++launch_count_;
+    return CUDA_SUCCESS;
+}
+
+// Stream and Event Management
+CUDA_CODES HostFunctionManager::cuStreamCreate(CUstream* stream,
+                                               unsigned int flags) {
+    return cuStreamCreateWithPriority(stream, flags, 0);
+}
+
+// the range of current GPUs, lower numbers are scheduled first
+CUDA_CODES HostFunctionManager::cuStreamCreateWithPriority(CUstream* stream,
+                                                           unsigned int flags,
+                                                           int priority) {
+    if (priority > 0) priority = 0;
+    if (priority < -5) priority = -5;
+    std::lock_guard<std::mutex> lock(mutex_);
+    *stream = NewHandle<CUstream>();
+    streams_[*stream] = {flags, priority};
+    return CUDA_SUCCESS;
+}
+
+CUDA_CODES HostFunctionManager::cuCtxGetStreamPriorityRange(
+        int* leastPriority, int* greatestPriority) {
+    if (leastPriority != nullptr) *leastPriority = 0;
+    if (greatestPriority != nullptr) *greatestPriority = -5;
+    return CUDA_SUCCESS;
+}
+
+CUDA_CODES HostFunctionManager::cuStreamDestroy(CUstream stream) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    streams_.erase(stream);
+    return CUDA_SUCCESS;
+}
+
+CUDA_CODES HostFunctionManager::cuStreamSynchronize(CUstream) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stream_sync_count_;
+    return CUDA_SUCCESS;
+}
+
+// work completes when it is enqueued, every stream is idle
+CUDA_CODES HostFunctionManager::cuStreamQuery(CUstream) {
+    return CUDA_SUCCESS;
+}
+
+bool HostFunctionManager::GetStreamInfo(CUstream stream,
+                                        unsigned int* flags,
+                                        int* priority) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = streams_.find(stream);
+    if (it == streams_.end()) return false;
+    if (flags != nullptr) *flags = it->second.first;
+    if (priority != nullptr) *priority = it->second.second;
+    return true;
+}
+
+CUDA_CODES HostFunctionManager::cuEventCreate(CUevent* event, unsigned int) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    *event = NewHandle<CUevent>();
+    return CUDA_SUCCESS;
+}
+
+CUDA_CODES HostFunctionManager::cuStreamWaitEvent(CUstream,
+                                                  CUevent,
+                                                  unsigned int) {
+    return CUDA_SUCCESS;
+}
+
+CUDA_CODES HostFunctionManager::cuEventRecord(CUevent event, CUstream) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    event_times_[event] = std::chrono::steady_clock::now();
+    if (hold_work_) {
+        held_events_.insert(event);
+    } else {
+        held_events_.erase(event);
+    }
+    return CUDA_SUCCESS;
+}
+
+CUDA_CODES HostFunctionManager::cuEventDestroy(CUevent event) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    event_times_.erase(event);
+    held_events_.erase(event);
+    return CUDA_SUCCESS;
+}
+
+CUDA_CODES HostFunctionManager::cuEventSynchronize(CUevent event) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    held_events_.erase(event);
+    return CUDA_SUCCESS;
+}
+
+CUDA_CODES HostFunctionManager::cuEventQuery(CUevent event) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return held_events_.count(event) != 0 ? CUDA_ERROR_NOT_READY
+                                          : CUDA_SUCCESS;
+}
+
+void HostFunctionManager::HoldWork(bool hold) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    hold_work_ = hold;
+    if (!hold) held_events_.clear();
+}
+
+CUDA_CODES HostFunctionManager::cuEventElapsedTime(float* pMilliseconds,
+                                                   CUevent hStart,
+                                                   CUevent hEnd) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto start = event_times_.find(hStart);
+    auto end = event_times_.find(hEnd);
+    if (start == event_times_.end() || end == event_times_.end()) {
+        return CUDA_ERROR_INVALID_VALUE;
+    }
+    *pMilliseconds = std::chrono::duration<float, std::milli>(end->second -
+                                                              start->second)
+                             .count();
+    return CUDA_SUCCESS;
+}
+
+// Graph Management
+bool HostFunctionManager::Capture(CUstream stream, const GraphNode& node) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = capturing_.find(stream);
+    if (stream == nullptr || it == capturing_.end()) return false;
+    it->second.push_back(node);
+    it->second.back().handle = NewHandle<CUgraphNode>();
+    return true;
+}
+
+CUDA_CODES HostFunctionManager::cuStreamBeginCapture(CUstream stream,
+                                                     CUstreamCaptureMode) {
+    // the legacy stream cannot be captured
+    if (stream == nullptr) return CUDA_ERROR_INVALID_VALUE;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!capturing_.emplace(stream, Graph()).second) {
+        return CUDA_ERROR_INVALID_VALUE;
+    }
+    return CUDA_SUCCESS;
+}
+
+CUDA_CODES HostFunctionManager::cuStreamEndCapture(CUstream stream,
+                                                   CUgraph* phGraph) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = capturing_.find(stream);
+    if (it == capturing_.end()) return CUDA_ERROR_INVALID_VALUE;
+    *phGraph = NewHandle<CUgraph>();
+    graphs_[*phGraph] = std::move(it->second);
+    capturing_.erase(it);
+    return CUDA_SUCCESS;
+}
+
+CUDA_CODES HostFunctionManager::cuStreamGetCaptureInfo(
+        CUstream stream,
+        CUstreamCaptureStatus* captureStatus,
+        unsigned long long* id,
+        CUgraph* graph,
+        const CUgraphNode** dependencies,
+        size_t* numDependencies) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = capturing_.find(stream);
+    bool active = it != capturing_.end();
+    *captureStatus = active ? CU_STREAM_CAPTURE_STATUS_ACTIVE
+                            : CU_STREAM_CAPTURE_STATUS_NONE;
+    if (id != nullptr) *id = reinterpret_cast<uintptr_t>(stream);
+    if (graph != nullptr) *graph = nullptr;
+    // captured work is a chain, the last node is the only dependency
+    bool has_node = active && !it->second.empty();
+    if (dependencies != nullptr) {
+        *dependencies = has_node ? &it->second.back().handle : nullptr;
+    }
+    if (numDependencies != nullptr) *numDependencies = has_node ? 1 : 0;
+    return CUDA_SUCCESS;
+}
+
+CUDA_CODES HostFunctionManager::cuGraphInstantiateWithFlags(
+        CUgraphExec* phGraphExec,
+        CUgraph hGraph,
+        unsigned long long) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = graphs_.find(hGraph);
+    if (it == graphs_.end()) return CUDA_ERROR_INVALID_VALUE;
+    *phGraphExec = NewHandle<CUgraphExec>();
+    execs_[*phGraphExec] = it->second;
+    return CUDA_SUCCESS;
+}
+
+CUDA_CODES HostFunctionManager::cuGraphLaunch(CUgraphExec hGraphExec,
+                                              CUstream) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = execs_.find(hGraphExec);
+    if (it == execs_.end()) return CUDA_ERROR_INVALID_VALUE;
+    for (const auto& node : it->second) {
+        if (node.copy_size != 0) {
+            std::memcpy(node.dst, node.src, node.copy_size);
+            ++copy_count_;
+        } else {
+            last_kernel_params_ = node.params;
+            ++launch_count_;
+        }
+    }
+    ++graph_launch_count_;
+    return CUDA_SUCCESS;
+}
+
+CUDA_CODES HostFunctionManager::cuGraphExecKernelNodeSetParams(
+        CUgraphExec hGraphExec,
+        CUgraphNode hNode,
+        const CUDA_KERNEL_NODE_PARAMS* nodeParams) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = execs_.find(hGraphExec);
+    if (it == execs_.end()) return CUDA_ERROR_INVALID_VALUE;
+    for (auto& node : it->second) {
+        if (node.handle != hNode || node.copy_size != 0) continue;
+        node.func = nodeParams->func;
+        node.params = nodeParams->kernelParams;
+        ++node_update_count_;
+        return CUDA_SUCCESS;
+    }
+    return CUDA_ERROR_INVALID_VALUE;
+}
+
+CUDA_CODES HostFunctionManager::cuGraphExecDestroy(CUgraphExec hGraphExec) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return execs_.erase(hGraphExec) != 0 ? CUDA_SUCCESS
+                                         : CUDA_ERROR_INVALID_VALUE;
+}
+
+CUDA_CODES HostFunctionManager::cuGraphDestroy(CUgraph hGraph) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return graphs_.erase(hGraph) != 0 ? CUDA_SUCCESS : CUDA_ERROR_INVALID_VALUE;
+}
+
+// Pointer Attributes
+CUDA_CODES HostFunctionManager::cuPointerGetAttribute(int* data,
+                                                      int,
+                                                      CUdeviceptr) {
+    *data = 0;
+    return CUDA_SUCCESS;
+}
+
+// Error Handling
+CUDA_CODES HostFunctionManager::cuGetErrorString(CUDA_CODES error,
+                                                 const char** pStr) {
+    switch (error) {
+        case CUDA_SUCCESS:
+            *pStr = "no error";
+            break;
+        case CUDA_ERROR_INVALID_VALUE:
+            *pStr = "invalid argument";
+            break;
+        case CUDA_ERROR_OUT_OF_MEMORY:
+            *pStr = "out of memory";
+            break;
+        case CUDA_ERROR_INVALID_DEVICE:
+            *pStr = "invalid device ordinal";
+            break;
+        case CUDA_ERROR_INVALID_CONTEXT:
+            *pStr = "invalid device context";
+            break;
+        case CUDA_ERROR_INVALID_HANDLE:
+            *pStr = "invalid resource handle";
+            break;
+        case CUDA_ERROR_NOT_READY:
+            *pStr = "device not ready";
+            break;
+        default:
+            *pStr = "unknown error";
+            break;
+    }
+    return CUDA_SUCCESS;
+}
+
+extern "C" void cudaHostCodesMgr(ICudaFunctionManager** mgr) {
+    static HostFunctionManager instance;
+    *mgr = &instance;
+}
+}  // namespace cudamgr
+}  // namespace dexsim
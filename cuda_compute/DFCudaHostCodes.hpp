@@ -0,0 +1,269 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) 2021-2025 DexForce Technology Co., Ltd.
+//
+// All rights reserved.
+// ----------------------------------------------------------------------------
+
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "DFCudaCodes.h"
+
+namespace dexsim {
+namespace cudamgr {
+
+/// \brief Host-memory stand-in for the CUDA driver.
+///
+/// Device memory is host memory and copies are memcpy, modules, functions,
+/// streams and events are opaque tokens, and kernel launches are only
+/// counted. Handing it to CudaManager exercises every bookkeeping path of the
+/// CUDA backend (memory pool, streams, launches) on machines without a GPU.
+/// Like the driver, the current context is per thread, and allocations and
+/// launches fail on threads without one.
+class HostFunctionManager : public ICudaFunctionManager {
+public:
+    HostFunctionManager() = default;
+    ~HostFunctionManager();
+
+    HostFunctionManager(const HostFunctionManager&) = delete;
+    HostFunctionManager& operator=(const HostFunctionManager&) = delete;
+
+    // Driver Management
+    CUDA_CODES cuDriverGetVersion(int* version) override;
+    CUDA_CODES cuInit(unsigned int flags) override;
+    CUDA_CODES cuGetProcAddress(const char* symbol,
+                                void** pfn,
+                                int cudaVersion,
+                                uint64_t flags) override;
+
+    // Device Management
+    CUDA_CODES cuDeviceGetCount(int* count) override;
+    CUDA_CODES cuDeviceGet(CUdevice* device, int ordinal) override;
+    CUDA_CODES cuDeviceGetName(char* name, int len, CUdevice dev) override;
+    CUDA_CODES cuDeviceGetAttribute(int* pi, int attr, CUdevice dev) override;
+
+    // Context Management
+    CUDA_CODES cuCtxCreate(CUcontext* pctx,
+                           unsigned int flags,
+                           CUdevice dev) override;
+    CUDA_CODES cuCtxGetCurrent(CUcontext* pctx) override;
+    CUDA_CODES cuCtxSynchronize() override;
+    CUDA_CODES cuCtxSetCurrent(CUcontext ctx) override;
+    CUDA_CODES cuDevicePrimaryCtxRetain(CUcontext* pctx, CUdevice dev) override;
+
+    // Memory Management
+    CUDA_CODES cuMemAlloc(CUdeviceptr* dptr, size_t bytesize) override;
+    CUDA_CODES cuMemFree(CUdeviceptr dptr) override;
+    CUDA_CODES cuMemcpyHtoD(CUdeviceptr dstDevice,
+                            const void* srcHost,
+                            size_t ByteCount) override;
+    CUDA_CODES cuMemcpyDtoH(void* dstHost,
+                            CUdeviceptr srcDevice,
+                            size_t ByteCount) override;
+    CUDA_CODES cuMemcpyHtoDAsync(CUdeviceptr dstDevice,
+                                 const void* srcHost,
+                                 size_t ByteCount,
+                                 CUstream hStream) override;
+    CUDA_CODES cuMemcpyDtoHAsync(void* dstHost,
+                                 CUdeviceptr srcDevice,
+                                 size_t ByteCount,
+                                 CUstream hStream) override;
+    CUDA_CODES cuMemcpy2D(const CUDA_MEMCPY2D* pCopy) override;
+
+    // Page-Locked Host Memory
+    CUDA_CODES cuMemHostAlloc(void** pp,
+                              size_t bytesize,
+                              unsigned int Flags) override;
+    CUDA_CODES cuMemFreeHost(void* p) override;
+    CUDA_CODES cuMemHostRegister(void* p,
+                                 size_t bytesize,
+                                 unsigned int Flags) override;
+    CUDA_CODES cuMemHostUnregister(void* p) override;
+
+    // Module and Kernel Control
+    CUDA_CODES cuModuleLoadData(CUmodule* module, const void* image) override;
+    CUDA_CODES cuModuleLoadDataEx(CUmodule* module,
+                                  const void* image,
+                                  unsigned int numOptions,
+                                  CUjit_option* options,
+                                  void** optionValues) override;
+    CUDA_CODES cuModuleGetFunction(CUfunction* hfunc,
+                                   CUmodule hmod,
+                                   const char* name) override;
+    CUDA_CODES cuLinkCreate(unsigned int numOptions,
+                            CUjit_option* options,
+                            void** optionValues,
+                            CUlinkState* stateOut) override;
+    CUDA_CODES cuLinkAddData(CUlinkState state,
+                             CUjitInputType type,
+                             void* data,
+                             size_t size,
+                             const char* name,
+                             unsigned int numOptions,
+                             CUjit_option* options,
+                             void** optionValues) override;
+    CUDA_CODES cuLinkComplete(CUlinkState state,
+                              void** cubinOut,
+                              size_t* sizeOut) override;
+    CUDA_CODES cuLinkDestroy(CUlinkState state) override;
+    CUDA_CODES cuFuncGetAttribute(int* pi,
+                                  CUfunction_attribute attrib,
+                                  CUfunction hfunc) override;
+    CUDA_CODES cuOccupancyMaxPotentialBlockSize(
+            int* minGridSize,
+            int* blockSize,
+            CUfunction func,
+            CUoccupancyB2DSize blockSizeToDynamicSMemSize,
+            size_t dynamicSMemSize,
+            int blockSizeLimit) override;
+    CUDA_CODES cuLaunchKernel(CUfunction f,
+                              unsigned int gridDimX,
+                              unsigned int gridDimY,
+                              unsigned int gridDimZ,
+                              unsigned int blockDimX,
+                              unsigned int blockDimY,
+                              unsigned int blockDimZ,
+                              unsigned int sharedMemBytes,
+                              CUstream hStream,
+                              void** kernelParams,
+                              void** extra) override;
+
+    // Stream and Event Management
+    CUDA_CODES cuStreamCreate(CUstream* stream, unsigned int flags) override;
+    CUDA_CODES cuStreamCreateWithPriority(CUstream* stream,
+                                          unsigned int flags,
+                                          int priority) override;
+    CUDA_CODES cuCtxGetStreamPriorityRange(int* leastPriority,
+                                           int* greatestPriority) override;
+    CUDA_CODES cuStreamDestroy(CUstream stream) override;
+    CUDA_CODES cuStreamSynchronize(CUstream stream) override;
+    CUDA_CODES cuStreamQuery(CUstream stream) override;
+    CUDA_CODES cuEventCreate(CUevent* event, unsigned int flags) override;
+    CUDA_CODES cuStreamWaitEvent(CUstream stream,
+                                 CUevent event,
+                                 unsigned int flags) override;
+    CUDA_CODES cuEventRecord(CUevent event, CUstream stream) override;
+    CUDA_CODES cuEventDestroy(CUevent event) override;
+    CUDA_CODES cuEventSynchronize(CUevent event) override;
+    CUDA_CODES cuEventQuery(CUevent event) override;
+    CUDA_CODES cuEventElapsedTime(float* pMilliseconds,
+                                  CUevent hStart,
+                                  CUevent hEnd) override;
+
+    // Graph Management
+    CUDA_CODES cuStreamBeginCapture(CUstream stream,
+                                    CUstreamCaptureMode mode) override;
+    CUDA_CODES cuStreamEndCapture(CUstream stream, CUgraph* phGraph) override;
+    CUDA_CODES cuStreamGetCaptureInfo(CUstream stream,
+                                      CUstreamCaptureStatus* captureStatus,
+                                      unsigned long long* id,
+                                      CUgraph* graph,
+                                      const CUgraphNode** dependencies,
+                                      size_t* numDependencies) override;
+    CUDA_CODES cuGraphInstantiateWithFlags(CUgraphExec* phGraphExec,
+                                           CUgraph hGraph,
+                                           unsigned long long flags) override;
+    CUDA_CODES cuGraphLaunch(CUgraphExec hGraphExec, CUstream hStream) override;
+    CUDA_CODES cuGraphExecKernelNodeSetParams(
+            CUgraphExec hGraphExec,
+            CUgraphNode hNode,
+            const CUDA_KERNEL_NODE_PARAMS* nodeParams) override;
+    CUDA_CODES cuGraphExecDestroy(CUgraphExec hGraphExec) override;
+    CUDA_CODES cuGraphDestroy(CUgraph hGraph) override;
+
+    // Pointer Attributes
+    CUDA_CODES cuPointerGetAttribute(int* data,
+                                     int attribute,
+                                     CUdeviceptr ptr) override;
+
+    // Error Handling
+    CUDA_CODES cuGetErrorString(CUDA_CODES error, const char** pStr) override;
+
+    // Call counters, used to check what reached the "driver"
+    size_t AllocCount() const { return alloc_count_; }
+    size_t FreeCount() const { return free_count_; }
+    size_t LaunchCount() const { return launch_count_; }
+    size_t CopyCount() const { return copy_count_; }
+    size_t PinnedBytes() const { return pinned_bytes_; }
+    size_t ModuleLoadCount() const { return module_load_count_; }
+    // PTX compilations done by cuLinkComplete
+    size_t LinkCount() const { return link_count_; }
+    size_t BytesAllocated() const { return bytes_allocated_; }
+    size_t GraphLaunchCount() const { return graph_launch_count_; }
+    size_t NodeUpdateCount() const { return node_update_count_; }
+    size_t StreamSyncCount() const { return stream_sync_count_; }
+    // kernel parameters of the last launch or replayed kernel node
+    void** LastKernelParams() const { return last_kernel_params_; }
+    // grid and block dimensions of the last launch
+    const unsigned int* LastGridDim() const { return last_grid_dim_; }
+    const unsigned int* LastBlockDim() const { return last_block_dim_; }
+    // flags and priority a live stream was created with, false if unknown
+    bool GetStreamInfo(CUstream stream, unsigned int* flags, int* priority);
+    // while held, events recorded since act like work still running on the
+    // device: cuEventQuery reports them not ready until they are waited on
+    // or the hold is released
+    void HoldWork(bool hold);
+
+private:
+    // a captured launch (copy_size == 0) or copy, replayed by cuGraphLaunch
+    struct GraphNode {
+        CUgraphNode handle = nullptr;
+        CUfunction func = nullptr;
+        void** params = nullptr;
+        void* dst = nullptr;
+        const void* src = nullptr;
+        size_t copy_size = 0;
+    };
+    using Graph = std::vector<GraphNode>;
+
+    // appends a node if stream is capturing, true if it did
+    bool Capture(CUstream stream, const GraphNode& node);
+
+    template <typename Handle>
+    Handle NewHandle() {
+        return reinterpret_cast<Handle>(++next_handle_);
+    }
+
+    std::mutex mutex_;
+    std::unordered_map<CUdeviceptr, size_t> allocations_;
+    std::unordered_map<void*, size_t> pinned_;  // cuMemHostAlloc'd or registered
+    std::unordered_map<CUstream, Graph> capturing_;
+    std::unordered_map<CUstream, std::pair<unsigned int, int>> streams_;
+    std::unordered_map<CUgraph, Graph> graphs_;
+    std::unordered_map<CUgraphExec, Graph> execs_;
+    // image being linked, cuLinkComplete hands out the finished copy
+    std::unordered_map<CUlinkState, std::vector<char>> links_;
+    // host time of the last cuEventRecord of each event
+    std::unordered_map<CUevent, std::chrono::steady_clock::time_point>
+            event_times_;
+    bool hold_work_ = false;
+    std::unordered_set<CUevent> held_events_;
+    void** last_kernel_params_ = nullptr;
+    unsigned int last_grid_dim_[3] = {0, 0, 0};
+    unsigned int last_block_dim_[3] = {0, 0, 0};
+    uintptr_t next_handle_ = 0x1000;
+    std::unordered_map<std::thread::id, CUcontext> current_contexts_;
+
+    size_t alloc_count_ = 0;
+    size_t free_count_ = 0;
+    size_t launch_count_ = 0;
+    size_t copy_count_ = 0;
+    size_t pinned_bytes_ = 0;
+    size_t module_load_count_ = 0;
+    size_t link_count_ = 0;
+    size_t bytes_allocated_ = 0;
+    size_t graph_launch_count_ = 0;
+    size_t node_update_count_ = 0;
+    size_t stream_sync_count_ = 0;
+};
+
+extern "C" void cudaHostCodesMgr(ICudaFunctionManager** mgr);
+}  // namespace cudamgr
+}  // namespace dexsim
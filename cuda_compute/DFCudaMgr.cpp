@@ -5,18 +5,78 @@
 // ----------------------------------------------------------------------------
 #include "DFCudaMgr.hpp"
 
+#include <cctype>
+#include <thread>
+
 namespace dexsim {
 namespace cudamgr {
 
-CudaManager::CudaManager() {
+namespace {
+// Domain of a launch in x. Warp kernels rebuild their index from the
+// flattened x coordinate alone, so both modes launch 1D grids: shaped
+// launches cover the flattened bounds with one thread per element, flat
+// launches one wave of blocks (see SetLaunchDims). Returns the key of the
+// mode for tuned configurations, 1 for shaped and 0 for flat launches.
+int LaunchDomain(const BoundLaunch& launch, size_t shape[3]) {
+    shape[0] = launch.args.bounds.size;
+    shape[1] = shape[2] = 1;
+    return launch.mode == LAUNCH_FLAT ? 0 : 1;
+}
+
+// device names become part of a file name
+std::string DeviceFileTag(const std::string& name) {
+    std::string tag = name.empty() ? "device" : name;
+    for (char& c : tag) {
+        if (!std::isalnum(static_cast<unsigned char>(c))) c = '_';
+    }
+    return tag;
+}
+}  // namespace
+
+CudaManager::CudaManager() : CudaManager(nullptr) {}
+
+CudaManager::CudaManager(ICudaFunctionManager* cuda) : cuda_(cuda) {
     InitCUDA();
+    if (!initialized_) return;
 
     std::ios::sync_with_stdio(false);
     const char* homePath = std::getenv("HOME");
-    if (homePath) {
-        std::filesystem::path targetPath =
-                std::filesystem::path(homePath) / "dexsim_data" / "kernels";
-        if (std::filesystem::exists(targetPath)) {
+    std::filesystem::path dataPath;
+    if (homePath) dataPath = std::filesystem::path(homePath) / "dexsim_data";
+
+    // DEXSIM_KERNEL_DIR overrides the kernel directory. The one under $HOME,
+    // the module cache and the tuned launch configs stored next to the
+    // kernels are only used when no kernels are embedded, so a binary
+    // carrying its kernels runs without touching the file system; embedded
+    // PTX is JIT-compiled by the driver instead, and tuned configs are only
+    // kept in memory.
+    const char* kernelDir = std::getenv("DEXSIM_KERNEL_DIR");
+    bool overridden = kernelDir != nullptr && *kernelDir != '\0';
+    bool embedded = !overridden &&
+                    EmbeddedKernelRegistry::Instance().KernelCount() > 0;
+    if (!dataPath.empty() && !embedded) {
+        module_cache_.reset(new ModuleCache(cuda_, dataPath / "module_cache",
+                                            cudaDriverVersion_,
+                                            compute_capability_,
+                                            kModuleCacheBytes));
+    }
+    if (embedded) {
+        std::cout << "Using " << EmbeddedKernelRegistry::Instance().KernelCount()
+                  << " embedded kernels" << std::endl;
+        return;
+    }
+    std::filesystem::path targetPath =
+            overridden ? std::filesystem::path(kernelDir)
+                       : (dataPath.empty() ? dataPath : dataPath / "kernels");
+    if (targetPath.empty()) return;
+    launch_config_path_ = targetPath / ("LaunchConfig_" +
+                                        DeviceFileTag(device_name_) + ".txt");
+    if (std::filesystem::exists(targetPath)) {
+        // a prebuilt index is mapped instead of parsing every CoreLUT.txt
+        if (library_index_.Open(targetPath / KernelIndex::kFileName)) {
+            std::cout << "Mapped index of " << library_index_.KernelCount()
+                      << " kernels from " << targetPath << std::endl;
+        } else {
             for (const auto& entry :
                  std::filesystem::recursive_directory_iterator(targetPath)) {
                 if (entry.path().filename() == "CoreLUT.txt") {
@@ -28,6 +88,8 @@ CudaManager::CudaManager() {
 }
 
 void CudaManager::UnInit() {
+    if (!initialized_) return;
+    memory_pool_->Trim();
     auto result = cuda_->cuMemFree(cu_device_);
     if (result != CUDA_SUCCESS) {
         const char* errorStr;
@@ -37,8 +99,22 @@ void CudaManager::UnInit() {
     }
 }
 
+void CudaManager::MakeContextCurrent() {
+    // the driver keeps the current context per thread; code that switches
+    // contexts on a thread is expected to restore ours, as push/pop does
+    thread_local CUcontext current = nullptr;
+    if (current == cu_context_ || cu_context_ == nullptr) return;
+    if (cuda_->cuCtxSetCurrent(cu_context_) == CUDA_SUCCESS) {
+        current = cu_context_;
+    }
+}
+
 void CudaManager::InitCUDA() {
-    cudaCodesMgr(&cuda_);
+    if (cuda_ == nullptr) { cudaCodesMgr(&cuda_); }
+    if (cuda_ == nullptr) {
+        std::cout << "CUDA driver library is not available." << std::endl;
+        return;
+    }
 
     auto result = cuda_->cuInit(0);
     if (result != CUDA_SUCCESS) {
@@ -66,6 +142,31 @@ void CudaManager::InitCUDA() {
         return;
     }
     std::cout << "Using CUDA device: " << deviceName << std::endl;
+    device_name_ = deviceName;
+
+    // keys cached modules, together with the driver version
+    int major = 0;
+    int minor = 0;
+    cuda_->cuDeviceGetAttribute(
+            &major, CU_DEVICE_ATTRIBUTE_COMPUTE_CAPABILITY_MAJOR, cu_device_);
+    cuda_->cuDeviceGetAttribute(
+            &minor, CU_DEVICE_ATTRIBUTE_COMPUTE_CAPABILITY_MINOR, cu_device_);
+    compute_capability_ = major * 10 + minor;
+
+    // sizes the grid of flat launches
+    int value = 0;
+    if (cuda_->cuDeviceGetAttribute(&value,
+                                    CU_DEVICE_ATTRIBUTE_MULTIPROCESSOR_COUNT,
+                                    cu_device_) == CUDA_SUCCESS &&
+        value > 0) {
+        sm_count_ = value;
+    }
+    if (cuda_->cuDeviceGetAttribute(
+                &value, CU_DEVICE_ATTRIBUTE_MAX_THREADS_PER_MULTIPROCESSOR,
+                cu_device_) == CUDA_SUCCESS &&
+        value > 0) {
+        sm_max_threads_ = value;
+    }
 
     result = cuda_->cuCtxCreate(&cu_context_, 0, cu_device_);
     // or result = cuda_->cuCtxCreate(&cu_context_, 0, cu_device_);
@@ -82,53 +183,109 @@ void CudaManager::InitCUDA() {
 
     std::cout << "Using CUcontext: " << cu_context_ << " with address: " << cu_context_ << std::endl;
 
+    // optional entry points of older drivers, checked once
+    stream_priorities_ = cuda_->HasFunction("cuStreamCreateWithPriority") &&
+                         cuda_->HasFunction("cuCtxGetStreamPriorityRange");
+    graphs_supported_ = true;
+    for (const char* name :
+         {"cuStreamBeginCapture", "cuStreamEndCapture",
+          "cuStreamGetCaptureInfo", "cuGraphInstantiateWithFlags",
+          "cuGraphLaunch", "cuGraphExecKernelNodeSetParams",
+          "cuGraphExecDestroy", "cuGraphDestroy"}) {
+        graphs_supported_ = graphs_supported_ && cuda_->HasFunction(name);
+    }
+
+    // stays 0/0 where priorities are not supported
+    if (stream_priorities_) {
+        cuda_->cuCtxGetStreamPriorityRange(&least_stream_priority_,
+                                           &greatest_stream_priority_);
+    }
+
+    memory_pool_.reset(new DeviceMemoryPool(cuda_));
+    pinned_ring_.reset(new PinnedStagingRing(cuda_, 4 << 20, 4));
+    event_pool_.reset(new EventPool(cuda_));
+    initialized_ = true;
     std::cout << "Cuda manager init successful." << std::endl;
 }
 
-void CudaManager::LoadPTXFile(const std::string& type) {
-    std::filesystem::path ptxPath = basePath_ / (type + ".ptx");
+CUmodule CudaManager::LoadPTXFile(const std::string& type) {
+    auto loaded = modules_.find(type);
+    if (loaded != modules_.end()) return loaded->second;
+    // a failed load is remembered as nullptr and not retried
+    CUmodule& module = modules_[type];
+    module = LoadModule(type);
+    return module;
+}
+
+CUmodule CudaManager::LoadModule(const std::string& type) {
+    auto path = module_paths_.find(type);
+    if (path == module_paths_.end()) {
+        const EmbeddedModule* embedded =
+                EmbeddedKernelRegistry::Instance().FindModule(type.c_str());
+        if (embedded == nullptr) return nullptr;
+        return LoadModuleImage(
+                type,
+                std::string_view(reinterpret_cast<const char*>(embedded->image),
+                                 embedded->size),
+                embedded->cubin);
+    }
 
+    const std::filesystem::path& ptxPath = path->second;
     if (!std::filesystem::exists(ptxPath)) {
         std::cerr << "Warning: PTX file not found for type " << type << ": "
                   << ptxPath << std::endl;
-        return;
+        return nullptr;
     }
 
     std::ifstream ptxFile(ptxPath, std::ios::binary);
     if (!ptxFile.is_open()) {
         std::cerr << "Warning: Failed to open PTX file: " << ptxPath
                   << std::endl;
-        return;
+        return nullptr;
     }
 
     std::string content((std::istreambuf_iterator<char>(ptxFile)),
                         std::istreambuf_iterator<char>());
+    return LoadModuleImage(type, content, false);
+}
 
-    modules_[type] = nullptr;
-    // auto result = cuda_->cuModuleLoadData(&modules_[type], content.c_str());
-    auto result = cuda_->cuModuleLoadDataEx(
-            &modules_[type], content.c_str(), 0, nullptr, nullptr);
+CUmodule CudaManager::LoadModuleImage(const std::string& type,
+                                      std::string_view image,
+                                      bool cubin) {
+    // compiled images are reused across runs, only new PTX is JIT-compiled
+    CUmodule module = nullptr;
+    CUDA_CODES result;
+    if (cubin) {
+        result = cuda_->cuModuleLoadData(&module, image.data());
+    } else if (module_cache_) {
+        result = module_cache_->Load(&module, image, type);
+    } else {
+        result = cuda_->cuModuleLoadDataEx(&module, image.data(), 0, nullptr,
+                                           nullptr);
+    }
     if (result != CUDA_SUCCESS) {
         const char* errorStr;
         cuda_->cuGetErrorString(result, &errorStr);
-        std::cerr << "Failed to load PTX file: " << ptxPath
+        std::cerr << "Failed to load module: " << type
                   << ", Error: " << errorStr << ", Result Code: " << result
                   << std::endl;
-        return;
+        return nullptr;
     }
-    std::cout << "Loaded PTX for type: " << type << " (" << content.size()
+    std::cout << "Loaded module for type: " << type << " (" << image.size()
               << " bytes)" << std::endl;
+    return module;
 }
 
 void CudaManager::ProcessFile(const std::filesystem::path& filePath) {
-    basePath_ = filePath.parent_path();
+    // only the index is read here, modules are loaded by the first launch of
+    // one of their kernels
+    std::filesystem::path basePath = filePath.parent_path();
     std::ifstream file(filePath);
     if (!file.is_open()) return;
 
     std::string line;
     std::string currentType;
-    int expectedCount = 0;
-    int processedCount = 0;
+    int indexedCount = 0;
 
     while (std::getline(file, line)) {
         line.erase(line.begin(),
@@ -143,141 +300,320 @@ void CudaManager::ProcessFile(const std::filesystem::path& filePath) {
 
         size_t spacePos = line.find(' ');
         if (spacePos != std::string::npos) {
-            std::string type = line.substr(0, spacePos);
-            std::string countStr = line.substr(spacePos + 1);
-
-            int count = std::stoi(countStr);
-            currentType = type;
-            expectedCount = count;
-            processedCount = 0;
-
-            LoadPTXFile(currentType);
+            currentType = line.substr(0, spacePos);
+            module_paths_[currentType] = basePath / (currentType + ".ptx");
         }
 
         size_t colonPos = line.find(':');
         if (colonPos != std::string::npos) {
             if (currentType.empty()) continue;
 
-            std::string originalName = line.substr(0, colonPos);
-            std::string implementation = line.substr(colonPos + 1);
-
-            CUfunction tempFunction;
-            auto result = cuda_->cuModuleGetFunction(&tempFunction,
-                                                     modules_[currentType],
-                                                     implementation.c_str());
-            functions_[originalName] = tempFunction;
-
-            if (result != CUDA_SUCCESS) {
-                const char* errorStr;
-                cuda_->cuGetErrorString(result, &errorStr);
-                std::cerr << "Failed to get function: " << originalName
-                          << ", Error: " << errorStr
-                          << ", Result Code: " << result << std::endl;
-                continue;
-            }
-            std::cout << "Loaded function: " << originalName
-                      << " from module: " << currentType << std::endl;
-            processedCount++;
+            KernelEntry& entry = kernels_[line.substr(0, colonPos)];
+            entry.module = currentType;
+            entry.symbol = line.substr(colonPos + 1);
+            entry.function = nullptr;
+            indexedCount++;
         }
     }
 
     file.close();
+    std::cout << "Indexed " << indexedCount << " kernels from " << filePath
+              << std::endl;
 }
 
-std::vector<CUstream>* CudaManager::GetStreamFamily(int stream_type) {
-    switch (stream_type) {
-        case RENDERING_STREAM:
-            return &rendering_stream_;
-        case CALCULATE_STREAM:
-            return &calculate_stream_;
-        case GEOMETRY_STREAM:
-            return &geometry_stream_;
-        case PHYSICS_STREAM:
-            return &physics_stream_;
-        case CUSTOM_STREAM:
-            return &custom_stream_;
-        default:
-            std::cerr << "Invalid stream type: " << stream_type << std::endl;
-            return nullptr;
+CudaManager::KernelEntry* CudaManager::FindKernelEntry(const char* name) {
+    auto it = kernels_.find(name);
+    if (it != kernels_.end()) return &it->second;
+
+    uint32_t module = 0;
+    const char* symbol = nullptr;
+    if (library_index_.Find(name, &module, &symbol)) {
+        KernelEntry& entry = kernels_[name];
+        entry.module = library_index_.ModuleName(module);
+        entry.symbol = symbol;
+        module_paths_.emplace(entry.module, library_index_.ModulePath(module));
+        return &entry;
     }
+
+    // kernels linked into the binary come last, the directory overrides them
+    const EmbeddedKernel* embedded =
+            EmbeddedKernelRegistry::Instance().FindKernel(name);
+    if (embedded == nullptr) return nullptr;
+    KernelEntry& entry = kernels_[name];
+    entry.module = embedded->module;
+    entry.symbol = embedded->symbol;
+    return &entry;
 }
 
-int CudaManager::CreateStreamInFamily(int stream_type) {
-    // get target stream family
-    std::vector<CUstream>* targetStreamFamily = GetStreamFamily(stream_type);
-
-    // check if a null ptr is present, if so create a stream at that position
-    for (size_t i = 0; i < targetStreamFamily->size(); ++i) {
-        if ((*targetStreamFamily)[i] == nullptr) {
-            CUDA_CODES result =
-                    cuda_->cuStreamCreate(&(*targetStreamFamily)[i], 0);
-            if (result != CUDA_SUCCESS) {
-                std::cerr << "Failed to create stream at index " << i
-                          << std::endl;
-                return -1;
-            }
-            return i;  // return the index of the new stream
-        }
-    }
+CUfunction CudaManager::ResolveKernel(const char* name) {
+    std::lock_guard<std::mutex> lock(module_mutex_);
+    KernelEntry* found = FindKernelEntry(name);
+    if (found == nullptr) return nullptr;
+    KernelEntry& entry = *found;
+    if (entry.function != nullptr) return entry.function;
 
-    // if no null ptr is found, create a new stream and add it to the family
-    CUstream newStream;
-    CUDA_CODES result = cuda_->cuStreamCreate(&newStream, 0);
+    CUmodule module = LoadPTXFile(entry.module);
+    if (module == nullptr) return nullptr;
+    CUfunction function = nullptr;
+    auto result = cuda_->cuModuleGetFunction(&function, module,
+                                             entry.symbol.c_str());
     if (result != CUDA_SUCCESS) {
-        std::cerr << "Failed to create new stream." << std::endl;
-        return -1;
+        const char* errorStr;
+        cuda_->cuGetErrorString(result, &errorStr);
+        std::cerr << "Failed to get function: " << name
+                  << ", Error: " << errorStr << ", Result Code: " << result
+                  << std::endl;
+        return nullptr;
     }
+    entry.function = function;
+    std::cout << "Loaded function: " << name
+              << " from module: " << entry.module << std::endl;
+    return function;
+}
 
-    targetStreamFamily->push_back(newStream);
-    return targetStreamFamily->size() - 1;
+namespace {
+// chunk of a stream id and its index in there, chunk k starting at id
+// kFirstChunk * (2^k - 1)
+void LocateStreamSlot(int id, int first_chunk, int* chunk, int* index) {
+    unsigned int n = static_cast<unsigned int>(id / first_chunk) + 1;
+    *chunk = 0;
+    while (n >>= 1) ++*chunk;
+    *index = id - first_chunk * ((1 << *chunk) - 1);
 }
+}  // namespace
 
-CUstream CudaManager::GetStream(int stream_type, int stream_id) {
-    if (stream_id < GetStreamFamily(stream_type)->size()) {
-        return GetStreamFamily(stream_type)->at(stream_id);
-    } else {
-        std::cout << "Warning: stream type" << stream_type << " with id "
-                  << stream_id
-                  << " is not exist, use default stream instead.\n";
+CudaManager::StreamFamily::~StreamFamily() {
+    for (auto& chunk : chunks) { delete[] chunk.load(); }
+}
+
+CudaManager::StreamSlot* CudaManager::StreamFamily::Slot(int id) const {
+    int chunk = 0;
+    int index = 0;
+    LocateStreamSlot(id, kFirstChunk, &chunk, &index);
+    if (chunk >= kMaxChunks) return nullptr;
+    StreamSlot* slots = chunks[chunk].load(std::memory_order_acquire);
+    return slots != nullptr ? slots + index : nullptr;
+}
+
+CudaManager::StreamSlot* CudaManager::StreamFamily::GrowTo(int id) {
+    int chunk = 0;
+    int index = 0;
+    LocateStreamSlot(id, kFirstChunk, &chunk, &index);
+    if (chunk >= kMaxChunks) return nullptr;
+    StreamSlot* slots = chunks[chunk].load(std::memory_order_relaxed);
+    if (slots == nullptr) {
+        slots = new StreamSlot[static_cast<size_t>(kFirstChunk) << chunk];
+        chunks[chunk].store(slots, std::memory_order_release);
+    }
+    return slots + index;
+}
+
+CudaManager::StreamFamily* CudaManager::GetStreamFamily(int stream_type) {
+    if (stream_type < RENDERING_STREAM || stream_type > CUSTOM_STREAM) {
+        std::cerr << "Invalid stream type: " << stream_type << std::endl;
         return nullptr;
     }
+    return &stream_families_[stream_type];
 }
 
-void CudaManager::DeleteStreamFromFamily(int stream_type, int stream_id) {
-    // get target stream family
-    std::vector<CUstream>* targetStreamFamily = GetStreamFamily(stream_type);
+int CudaManager::CreateStreamInFamily(int stream_type) {
+    StreamFamily* family = GetStreamFamily(stream_type);
+    if (family == nullptr) return -1;
+    MakeContextCurrent();
+    std::lock_guard<std::mutex> lock(stream_mutex_);
+    return CreateStreamLocked(family, stream_type);
+}
 
-    // check if the stream_id is valid
-    if (stream_id < 0 || stream_id >= targetStreamFamily->size()) {
-        std::cerr << "Invalid stream ID: " << stream_id << std::endl;
-        return;
+int CudaManager::CreateStreamLocked(StreamFamily* family, int stream_type) {
+    // reuse the slot of a deleted stream, otherwise append one
+    int size = family->size.load(std::memory_order_relaxed);
+    int id = 0;
+    StreamSlot* slot = nullptr;
+    for (; id < size; ++id) {
+        slot = family->Slot(id);
+        if (slot->stream.load(std::memory_order_relaxed) == nullptr &&
+            !slot->deleting) {
+            break;
+        }
+    }
+    if (id == size) slot = family->GrowTo(id);
+    if (slot == nullptr) {
+        std::cerr << "Failed to create stream, stream family " << stream_type
+                  << " already holds " << size << " streams." << std::endl;
+        return -1;
+    }
+    CUstream stream = nullptr;
+    CUDA_CODES result =
+            stream_priorities_
+                    ? cuda_->cuStreamCreateWithPriority(
+                              &stream, family->flags, family->priority)
+                    : cuda_->cuStreamCreate(&stream, family->flags);
+    if (result != CUDA_SUCCESS) {
+        std::cerr << "Failed to create stream at index " << id << std::endl;
+        return -1;
+    }
+    slot->stream.store(stream, std::memory_order_release);
+    if (id == size) family->size.store(size + 1, std::memory_order_release);
+    return id;
+}
+
+CudaManager::StreamRef CudaManager::GetStream(int stream_type,
+                                              int stream_id) {
+    if (stream_type == -1) return StreamRef();
+    StreamFamily* family = GetStreamFamily(stream_type);
+    if (family != nullptr && stream_id >= 0 &&
+        stream_id < family->size.load(std::memory_order_acquire)) {
+        // registers as a user before reading the slot, pairs with the
+        // exchange in DeleteStreamFromFamily: either the stream is still
+        // there and the deletion waits for us, or we read nullptr
+        StreamSlot* slot = family->Slot(stream_id);
+        std::atomic<int>* users = &slot->users;
+        users->fetch_add(1, std::memory_order_seq_cst);
+        CUstream stream = slot->stream.load(std::memory_order_seq_cst);
+        if (stream == nullptr) {
+            // deleted, nothing to hold on to
+            users->fetch_sub(1, std::memory_order_release);
+            return StreamRef();
+        }
+        return StreamRef(users, stream);
     }
+    std::cout << "Warning: stream type" << stream_type << " with id "
+              << stream_id << " is not exist, use default stream instead.\n";
+    return StreamRef();
+}
 
-    // get the stream to delete
-    CUstream streamToDelete = (*targetStreamFamily)[stream_id];
+void CudaManager::DeleteStreamFromFamily(int stream_type, int stream_id) {
+    StreamFamily* family = GetStreamFamily(stream_type);
+    if (family == nullptr) return;
+    MakeContextCurrent();
+    StreamSlot* slot = nullptr;
+    CUstream streamToDelete = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(stream_mutex_);
 
-    // if the stream is not null, destroy it
-    if (streamToDelete != nullptr) {
-        CUDA_CODES result = cuda_->cuStreamDestroy(streamToDelete);
-        if (result != CUDA_SUCCESS) {
-            std::cerr << "Failed to destroy stream with ID " << stream_id
-                      << " in stream family " << stream_type << std::endl;
+        // check if the stream_id is valid
+        if (stream_id < 0 ||
+            stream_id >= family->size.load(std::memory_order_relaxed)) {
+            std::cerr << "Invalid stream ID: " << stream_id << std::endl;
+            return;
+        }
+        if (stream_id < family->pool_size.load(std::memory_order_relaxed)) {
+            std::cerr << "Warning: stream " << stream_id
+                      << " of stream family " << stream_type
+                      << " belongs to its pool, it is not deleted."
+                      << std::endl;
             return;
         }
 
-        // set the stream pointer to null
-        (*targetStreamFamily)[stream_id] = nullptr;
-    } else {
-        std::cerr << "Stream with ID " << stream_id << " in stream family "
-                  << stream_type << " is already null, cannot destroy."
+        // lookups see the slot empty before the stream is destroyed
+        slot = family->Slot(stream_id);
+        streamToDelete = slot->stream.exchange(nullptr,
+                                               std::memory_order_seq_cst);
+        if (streamToDelete == nullptr) {
+            std::cerr << "Stream with ID " << stream_id << " in stream family "
+                      << stream_type << " is already null, cannot destroy."
+                      << std::endl;
+            return;
+        }
+        slot->deleting = true;
+    }
+    // calls that read the stream before the exchange may still be enqueueing
+    // work on it, they only hold it for the length of the call. Other
+    // streams are created and deleted meanwhile, only this slot stays taken.
+    while (slot->users.load(std::memory_order_acquire) != 0) {
+        std::this_thread::yield();
+    }
+    // device memory freed later may have been used on the stream, and its
+    // free only waits for a stream that still exists
+    if (family->flags & CU_STREAM_NON_BLOCKING) {
+        cuda_->cuStreamSynchronize(streamToDelete);
+    }
+    CUDA_CODES result = cuda_->cuStreamDestroy(streamToDelete);
+    if (result != CUDA_SUCCESS) {
+        std::cerr << "Failed to destroy stream with ID " << stream_id
+                  << " in stream family " << stream_type << std::endl;
+    }
+    std::lock_guard<std::mutex> lock(stream_mutex_);
+    slot->deleting = false;
+}
+
+bool CudaManager::ConfigureStreamPool(int stream_type,
+                                      const StreamPoolConfig& config) {
+    StreamFamily* family = GetStreamFamily(stream_type);
+    if (family == nullptr) return false;
+    if (config.num_streams < 1) {
+        std::cerr << "Warning: Failed to create the stream pool of family "
+                  << stream_type << ", it needs at least 1 stream."
+                  << std::endl;
+        return false;
+    }
+    MakeContextCurrent();
+    std::lock_guard<std::mutex> lock(stream_mutex_);
+    if (family->size.load(std::memory_order_relaxed) != 0) {
+        std::cerr << "Warning: Failed to create the stream pool of family "
+                  << stream_type << ", the family already has streams."
                   << std::endl;
+        return false;
+    }
+
+    switch (config.priority) {
+        case STREAM_PRIORITY_LOW:
+            family->priority = least_stream_priority_;
+            break;
+        case STREAM_PRIORITY_HIGH:
+            family->priority = greatest_stream_priority_;
+            break;
+        default:
+            // 0 is the priority of streams created without one
+            family->priority = std::min(
+                    std::max(0, greatest_stream_priority_),
+                    least_stream_priority_);
+            break;
+    }
+    family->flags =
+            config.non_blocking ? CU_STREAM_NON_BLOCKING : CU_STREAM_DEFAULT;
+
+    int created = 0;
+    while (created < config.num_streams &&
+           CreateStreamLocked(family, stream_type) != -1) {
+        ++created;
+    }
+    family->pool_size.store(created, std::memory_order_release);
+    if (created < config.num_streams) {
+        std::cerr << "Warning: stream pool of family " << stream_type
+                  << " holds " << created << " of " << config.num_streams
+                  << " streams." << std::endl;
     }
+    return created > 0;
+}
+
+int CudaManager::AcquireStream(int stream_type) {
+    StreamFamily* family = GetStreamFamily(stream_type);
+    if (family == nullptr) return -1;
+    int pool = family->pool_size.load(std::memory_order_acquire);
+    if (pool == 0) {
+        std::cerr << "Warning: stream family " << stream_type
+                  << " has no stream pool, see ConfigureStreamPool."
+                  << std::endl;
+        return -1;
+    }
+    MakeContextCurrent();
+    unsigned int start =
+            family->next_pool_stream.fetch_add(1, std::memory_order_relaxed);
+    // an idle stream starts the work at once, otherwise round-robin spreads
+    // it over the pool
+    for (int i = 0; i < pool; ++i) {
+        int id = static_cast<int>((start + i) % pool);
+        CUstream stream =
+                family->Slot(id)->stream.load(std::memory_order_acquire);
+        if (cuda_->cuStreamQuery(stream) == CUDA_SUCCESS) return id;
+    }
+    return static_cast<int>(start % pool);
 }
 
 void CudaManager::AllocateDeviceMemoryImpl(CUdeviceptr* arr, size_t size) {
-    // get primary context
-    cuda_->cuDevicePrimaryCtxRetain(&cu_context_, cu_device_);
-    auto result = cuda_->cuMemAlloc(arr, size);
+    MakeContextCurrent();
+    auto result = memory_pool_->Allocate(arr, size);
     if (result != CUDA_SUCCESS) {
         const char* errorStr;
         cuda_->cuGetErrorString(result, &errorStr);
@@ -288,10 +624,15 @@ void CudaManager::AllocateDeviceMemoryImpl(CUdeviceptr* arr, size_t size) {
 }
 
 void CudaManager::ReleaseArrayDataDeviceImpl(SharedDataGPU* gpuData) {
-    gpuData->semaphore_ -= 1;
-    if (gpuData->semaphore_ == 0) {
+    MakeContextCurrent();
+    if (--gpuData->semaphore_ == 0) {
         gpuData->is_allocated_ = false;
-        auto result = cuda_->cuMemFree(gpuData->value_);
+        if (gpuData->is_external_) {
+            SlabDelete(gpuData);
+            return;
+        }
+        StreamRef stream = NonBlockingStreamOf(gpuData);
+        auto result = memory_pool_->Free(gpuData->value_, stream);
         if (result != CUDA_SUCCESS) {
             const char* errorStr;
             cuda_->cuGetErrorString(result, &errorStr);
@@ -299,12 +640,136 @@ void CudaManager::ReleaseArrayDataDeviceImpl(SharedDataGPU* gpuData) {
                       << ", Result Code: " << result << std::endl;
             return;
         }
-        delete gpuData;
+        SlabDelete(gpuData);
+    }
+}
+
+void CudaManager::WaitStreamUseImpl(const SharedDataGPU* gpuData) {
+    StreamRef stream = NonBlockingStreamOf(gpuData);
+    if (stream == nullptr) return;
+    MakeContextCurrent();
+    auto result = cuda_->cuStreamSynchronize(stream);
+    if (result != CUDA_SUCCESS) {
+        std::cerr << "Failed to wait for the stream using device memory. "
+                     "Result Code: "
+                  << result << std::endl;
+    }
+}
+
+CudaManager::StreamRef CudaManager::NonBlockingStreamOf(
+        const SharedDataGPU* gpuData) {
+    int use = gpuData->stream_use_.load(std::memory_order_relaxed);
+    if (use == kNoStreamUse) return StreamRef();
+    if (use == kManyStreamUse) {
+        SynchronizeNonBlockingStreams();
+        return StreamRef();
+    }
+    StreamFamily* family = GetStreamFamily(StreamUseType(use));
+    if (family == nullptr || (family->flags & CU_STREAM_NON_BLOCKING) == 0) {
+        // the legacy default stream waits for blocking streams
+        return StreamRef();
+    }
+    return GetStream(StreamUseType(use), StreamUseId(use));
+}
+
+void CudaManager::SynchronizeNonBlockingStreams() {
+    for (int type = 0; type <= CUSTOM_STREAM; ++type) {
+        StreamFamily* family = &stream_families_[type];
+        if ((family->flags & CU_STREAM_NON_BLOCKING) == 0) continue;
+        int size = family->size.load(std::memory_order_acquire);
+        for (int id = 0; id < size; ++id) {
+            StreamRef stream = GetStream(type, id);
+            if (stream == nullptr) continue;
+            auto result = cuda_->cuStreamSynchronize(stream);
+            if (result != CUDA_SUCCESS) {
+                std::cerr << "Failed to wait for stream " << id
+                          << " of stream family " << type
+                          << ". Result Code: " << result << std::endl;
+            }
+        }
+    }
+}
+
+void* CudaManager::AllocateHostMemoryImpl(size_t size, bool& pinned) {
+    MakeContextCurrent();
+    if (pinned) {
+        void* ptr = nullptr;
+        auto result =
+                cuda_->cuMemHostAlloc(&ptr, size, CU_MEMHOSTALLOC_PORTABLE);
+        if (result == CUDA_SUCCESS) {
+            std::lock_guard<std::mutex> lock(pinned_mutex_);
+            pinned_ranges_[reinterpret_cast<uintptr_t>(ptr)] = size;
+            return ptr;
+        }
+        std::cerr << "Warning: Failed to allocate pinned host memory, using "
+                     "pageable memory instead. Result Code: "
+                  << result << std::endl;
+        pinned = false;
+    }
+    return host_arena_.Allocate(size);
+}
+
+void CudaManager::ReleaseHostMemoryImpl(void* ptr, bool pinned) {
+    MakeContextCurrent();
+    if (!pinned) {
+        host_arena_.Free(ptr);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(pinned_mutex_);
+        pinned_ranges_.erase(reinterpret_cast<uintptr_t>(ptr));
+    }
+    cuda_->cuMemFreeHost(ptr);
+}
+
+bool CudaManager::RegisterHostMemory(void* ptr, size_t size) {
+    if (!cuda_->HasFunction("cuMemHostRegister")) {
+        std::cerr << "Warning: the CUDA driver cannot register host memory."
+                  << std::endl;
+        return false;
+    }
+    MakeContextCurrent();
+    auto result = cuda_->cuMemHostRegister(ptr, size,
+                                           CU_MEMHOSTREGISTER_PORTABLE);
+    if (result != CUDA_SUCCESS) {
+        const char* errorStr;
+        cuda_->cuGetErrorString(result, &errorStr);
+        std::cerr << "Failed to register host memory. Error: " << errorStr
+                  << ", Result Code: " << result << std::endl;
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(pinned_mutex_);
+    pinned_ranges_[reinterpret_cast<uintptr_t>(ptr)] = size;
+    return true;
+}
+
+void CudaManager::UnregisterHostMemory(void* ptr) {
+    MakeContextCurrent();
+    {
+        std::lock_guard<std::mutex> lock(pinned_mutex_);
+        if (pinned_ranges_.erase(reinterpret_cast<uintptr_t>(ptr)) == 0) {
+            std::cerr << "Warning: Failed to unregister host memory, the "
+                         "buffer is not registered.\n";
+            return;
+        }
     }
+    cuda_->cuMemHostUnregister(ptr);
+}
+
+bool CudaManager::IsPinnedHost(const void* ptr, size_t size) const {
+    uintptr_t begin = reinterpret_cast<uintptr_t>(ptr);
+    std::lock_guard<std::mutex> lock(pinned_mutex_);
+    auto it = pinned_ranges_.upper_bound(begin);
+    if (it == pinned_ranges_.begin()) return false;
+    --it;
+    return begin + size <= it->first + it->second;
 }
 
 void CudaManager::SyncToHostImpl(CUdeviceptr src, void* dst, size_t size) {
-    auto result = cuda_->cuMemcpyDtoH(dst, src, size);
+    MakeContextCurrent();
+    auto result = size >= kStagingThreshold && !IsPinnedHost(dst, size)
+                          ? pinned_ring_->CopyToHost(dst, src, size)
+                          : cuda_->cuMemcpyDtoH(dst, src, size);
     if (result != CUDA_SUCCESS) {
         const char* errorStr;
         cuda_->cuGetErrorString(result, &errorStr);
@@ -315,7 +780,10 @@ void CudaManager::SyncToHostImpl(CUdeviceptr src, void* dst, size_t size) {
 }
 
 void CudaManager::SyncToDeviceImpl(void* src, CUdeviceptr dst, size_t size) {
-    auto result = cuda_->cuMemcpyHtoD(dst, src, size);
+    MakeContextCurrent();
+    auto result = size >= kStagingThreshold && !IsPinnedHost(src, size)
+                          ? pinned_ring_->CopyToDevice(dst, src, size)
+                          : cuda_->cuMemcpyHtoD(dst, src, size);
     if (result != CUDA_SUCCESS) {
         const char* errorStr;
         cuda_->cuGetErrorString(result, &errorStr);
@@ -325,18 +793,576 @@ void CudaManager::SyncToDeviceImpl(void* src, CUdeviceptr dst, size_t size) {
     }
 }
 
-void CudaManager::ReleaseWarpArgs(void** args) {
-    if (!args) return;
-    delete static_cast<CudaBounds*>(args[0]); 
-    delete[] args;
+void CudaManager::Copy2DToHostImpl(CUdeviceptr src,
+                                   size_t src_pitch,
+                                   void* dst,
+                                   size_t dst_pitch,
+                                   size_t width,
+                                   size_t height) {
+    MakeContextCurrent();
+    CUDA_MEMCPY2D copy = {};
+    copy.srcMemoryType = CU_MEMORYTYPE_DEVICE;
+    copy.srcDevice = src;
+    copy.srcPitch = src_pitch;
+    copy.dstMemoryType = CU_MEMORYTYPE_HOST;
+    copy.dstHost = dst;
+    copy.dstPitch = dst_pitch;
+    copy.WidthInBytes = width;
+    copy.Height = height;
+    auto result = cuda_->cuMemcpy2D(&copy);
+    if (result != CUDA_SUCCESS) {
+        const char* errorStr;
+        cuda_->cuGetErrorString(result, &errorStr);
+        std::cerr << "Failed to copy strided data from device to host. Error: "
+                  << errorStr << ", Result Code: " << result << std::endl;
+    }
+}
+
+void CudaManager::Copy2DToDeviceImpl(const void* src,
+                                     size_t src_pitch,
+                                     CUdeviceptr dst,
+                                     size_t dst_pitch,
+                                     size_t width,
+                                     size_t height) {
+    MakeContextCurrent();
+    CUDA_MEMCPY2D copy = {};
+    copy.srcMemoryType = CU_MEMORYTYPE_HOST;
+    copy.srcHost = src;
+    copy.srcPitch = src_pitch;
+    copy.dstMemoryType = CU_MEMORYTYPE_DEVICE;
+    copy.dstDevice = dst;
+    copy.dstPitch = dst_pitch;
+    copy.WidthInBytes = width;
+    copy.Height = height;
+    auto result = cuda_->cuMemcpy2D(&copy);
+    if (result != CUDA_SUCCESS) {
+        const char* errorStr;
+        cuda_->cuGetErrorString(result, &errorStr);
+        std::cerr << "Failed to copy strided data from host to device. Error: "
+                  << errorStr << ", Result Code: " << result << std::endl;
+    }
+}
+
+EventHandle CudaManager::RecordEvent(CUstream stream) {
+    CUevent event = event_pool_->Acquire();
+    if (event == nullptr) return nullptr;
+    auto result = cuda_->cuEventRecord(event, stream);
+    if (result != CUDA_SUCCESS) {
+        std::cerr << "Failed to record event. Result Code: " << result
+                  << std::endl;
+        ReleaseEvent(event);
+        return nullptr;
+    }
+    return event;
+}
+
+EventHandle CudaManager::RecordCopyEvent(CUstream stream) {
+    EventHandle event = RecordEvent(stream);
+    if (event != nullptr) return event;
+    auto result = cuda_->cuStreamSynchronize(stream);
+    if (result != CUDA_SUCCESS) {
+        std::cerr << "Failed to wait for an untracked copy. Result Code: "
+                  << result << std::endl;
+    }
+    return nullptr;
+}
+
+bool CudaManager::SyncToHostAsyncImpl(CUdeviceptr src,
+                                      void* dst,
+                                      size_t size,
+                                      int stream_type,
+                                      int stream_id,
+                                      EventHandle* event) {
+    MakeContextCurrent();
+    StreamRef stream = GetStream(stream_type, stream_id);
+    auto result = cuda_->cuMemcpyDtoHAsync(dst, src, size, stream);
+    if (result != CUDA_SUCCESS) {
+        const char* errorStr;
+        cuda_->cuGetErrorString(result, &errorStr);
+        std::cerr << "Failed to enqueue copy from device to host. Error: "
+                  << errorStr << ", Result Code: " << result << std::endl;
+        return false;
+    }
+    *event = RecordCopyEvent(stream);
+    return true;
+}
+
+bool CudaManager::SyncToDeviceAsyncImpl(const void* src,
+                                        CUdeviceptr dst,
+                                        size_t size,
+                                        int stream_type,
+                                        int stream_id,
+                                        EventHandle* event) {
+    MakeContextCurrent();
+    StreamRef stream = GetStream(stream_type, stream_id);
+    auto result = cuda_->cuMemcpyHtoDAsync(dst, src, size, stream);
+    if (result != CUDA_SUCCESS) {
+        const char* errorStr;
+        cuda_->cuGetErrorString(result, &errorStr);
+        std::cerr << "Failed to enqueue copy from host to device. Error: "
+                  << errorStr << ", Result Code: " << result << std::endl;
+        return false;
+    }
+    *event = RecordCopyEvent(stream);
+    return true;
+}
+
+void CudaManager::WaitEvent(EventHandle event) {
+    MakeContextCurrent();
+    if (event == nullptr) return;
+    auto result = cuda_->cuEventSynchronize(event);
+    if (result != CUDA_SUCCESS) {
+        std::cerr << "Failed to wait for event. Result Code: " << result
+                  << std::endl;
+    }
+}
+
+void CudaManager::StreamWaitEvent(int stream_type,
+                                  int stream_id,
+                                  EventHandle event) {
+    MakeContextCurrent();
+    if (event == nullptr) return;
+    StreamRef stream = GetStream(stream_type, stream_id);
+    auto result = cuda_->cuStreamWaitEvent(stream, event, 0);
+    if (result != CUDA_SUCCESS) {
+        std::cerr << "Failed to make stream wait for event. Result Code: "
+                  << result << std::endl;
+    }
+}
+
+bool CudaManager::QueryEvent(EventHandle event) {
+    MakeContextCurrent();
+    if (event == nullptr) return true;
+    return cuda_->cuEventQuery(event) == CUDA_SUCCESS;
+}
+
+void CudaManager::ReleaseEvent(EventHandle event) {
+    MakeContextCurrent();
+    if (event == nullptr) return;
+    event_pool_->Release(event);
+}
+
+SignalToken CudaManager::Signal(int stream_type, int stream_id) {
+    // cross-stream waits of a capture would reach outside the graph
+    if (RejectWhileCapturing("Signal")) return kNoSignal;
+    MakeContextCurrent();
+    StreamRef stream = GetStream(stream_type, stream_id);
+    return event_pool_->Signal(stream);
+}
+
+void CudaManager::Wait(int stream_type, int stream_id, SignalToken token) {
+    if (token == kNoSignal) return;
+    if (RejectWhileCapturing("Wait")) return;
+    MakeContextCurrent();
+    StreamRef stream = GetStream(stream_type, stream_id);
+    auto result = event_pool_->Wait(stream, token);
+    if (result != CUDA_SUCCESS) {
+        std::cerr << "Failed to make stream wait for signal. Result Code: "
+                  << result << std::endl;
+    }
+}
+
+bool CudaManager::QuerySignal(SignalToken token) {
+    if (token == kNoSignal) return true;
+    MakeContextCurrent();
+    return event_pool_->Query(token);
+}
+
+void CudaManager::WaitSignal(SignalToken token) {
+    if (token == kNoSignal) return;
+    MakeContextCurrent();
+    auto result = event_pool_->Synchronize(token);
+    if (result != CUDA_SUCCESS) {
+        std::cerr << "Failed to wait for signal. Result Code: " << result
+                  << std::endl;
+    }
+}
+
+ModuleCacheStats CudaManager::GetModuleCacheStats() const {
+    return module_cache_ ? module_cache_->GetStats() : ModuleCacheStats();
+}
+
+void* CudaManager::FindKernelImpl(const char* name) {
+    MakeContextCurrent();
+    return ResolveKernel(name);
+}
+
+void CudaManager::PreloadImpl(const char* const* funcs, int count) {
+    MakeContextCurrent();
+    std::lock_guard<std::mutex> lock(module_mutex_);
+    std::vector<std::string> types;
+    for (int i = 0; i < count; ++i) {
+        KernelEntry* entry = FindKernelEntry(funcs[i]);
+        if (entry == nullptr || entry->function != nullptr) continue;
+        if (modules_.count(entry->module) != 0) continue;
+        if (std::find(types.begin(), types.end(), entry->module) !=
+            types.end()) {
+            continue;
+        }
+        types.push_back(entry->module);
+    }
+    // a single module gains nothing from the pool, GetKernel loads it
+    if (types.size() < 2) return;
+
+    if (!load_pool_) load_pool_.reset(new ThreadPool());
+    std::vector<CUmodule> loaded(types.size(), nullptr);
+    load_pool_->ParallelFor(
+            types.size(), 1, [&](size_t begin, size_t end) {
+                // the workers only read the tables, this thread holds
+                // module_mutex_ meanwhile
+                MakeContextCurrent();
+                for (size_t i = begin; i < end; ++i) {
+                    loaded[i] = LoadModule(types[i]);
+                }
+            });
+    for (size_t i = 0; i < types.size(); ++i) {
+        modules_[types[i]] = loaded[i];
+    }
+}
+
+const CudaManager::KernelOccupancy& CudaManager::Occupancy(
+        CUfunction function) {
+    {
+        std::shared_lock<std::shared_mutex> lock(occupancy_mutex_);
+        auto it = occupancy_.find(function);
+        if (it != occupancy_.end()) return it->second;
+    }
+
+    KernelOccupancy occupancy;
+    int min_grid_size = 0;
+    int block_size = 0;
+    auto result = cuda_->cuOccupancyMaxPotentialBlockSize(
+            &min_grid_size, &block_size, function, nullptr, 0, 0);
+    if (result == CUDA_SUCCESS && block_size > 0 && min_grid_size > 0) {
+        occupancy.block_size = block_size;
+        occupancy.resident_threads =
+                static_cast<size_t>(min_grid_size) * block_size;
+    } else {
+        // fall back to the default, within what the kernel can take
+        int max_threads = 0;
+        if (cuda_->cuFuncGetAttribute(&max_threads,
+                                      CU_FUNC_ATTRIBUTE_MAX_THREADS_PER_BLOCK,
+                                      function) == CUDA_SUCCESS &&
+            max_threads > 0 &&
+            static_cast<unsigned int>(max_threads) < occupancy.block_size) {
+            occupancy.block_size = max_threads;
+        }
+        occupancy.resident_threads =
+                static_cast<size_t>(sm_count_) * sm_max_threads_;
+    }
+    // references stay valid when the map grows
+    std::lock_guard<std::shared_mutex> lock(occupancy_mutex_);
+    return occupancy_.emplace(function, occupancy).first->second;
+}
+
+void CudaManager::SetLaunchDims(BoundLaunch* launch,
+                                const size_t shape[3],
+                                const unsigned int block[3]) {
+    for (int i = 0; i < 3; ++i) {
+        launch->block[i] = block[i];
+        launch->grid[i] =
+                static_cast<unsigned int>((shape[i] + block[i] - 1) / block[i]);
+    }
+    if (launch->mode != LAUNCH_FLAT) return;
+
+    // one wave of resident blocks, the kernel strides over the remainder
+    const KernelOccupancy& occupancy =
+            Occupancy(static_cast<CUfunction>(launch->kernel));
+    size_t wave = occupancy.resident_threads / block[0];
+    if (wave < static_cast<size_t>(sm_count_)) wave = sm_count_;
+    if (launch->grid[0] > wave) {
+        launch->grid[0] = static_cast<unsigned int>(wave);
+    }
+    if (launch->grid[0] == 0) launch->grid[0] = 1;
+}
+
+void CudaManager::LoadLaunchConfigs() {
+    // read on first use, so startup does no file I/O for them
+    std::call_once(launch_configs_once_, [this]() {
+        if (!launch_config_path_.empty()) {
+            launch_configs_.Load(launch_config_path_);
+        }
+    });
+}
+
+void CudaManager::ConfigureLaunchImpl(BoundLaunch* launch) {
+    MakeContextCurrent();
+    LoadLaunchConfigs();
+    size_t shape[3];
+    int ndim = LaunchDomain(*launch, shape);
+
+    // a tuned shape for this kernel and size wins over the occupancy guess
+    unsigned int block[3];
+    if (!launch_configs_.Find(GetKernelName(launch->kernel_id), ndim,
+                              LaunchSizeBucket(shape[0]), block)) {
+        ShapeLaunchBlock(
+                Occupancy(static_cast<CUfunction>(launch->kernel)).block_size,
+                shape[0], block);
+    }
+    SetLaunchDims(launch, shape, block);
+}
+
+void CudaManager::SubmitLaunchImpl(BoundLaunch* launch) {
+    MakeContextCurrent();
+    StreamRef stream =
+            GetStream(launch->stream_type, launch->stream_id);
+    auto res = cuda_->cuLaunchKernel(
+            static_cast<CUfunction>(launch->kernel), launch->grid[0],
+            launch->grid[1], launch->grid[2],                  // grid dim
+            launch->block[0], launch->block[1], launch->block[2],  // block dim
+            0,                                                 // shared mem
+            stream,                                            // stream
+            launch->args.argv,                                 // kernel args
+            nullptr);
+
+    if (res != CUDA_SUCCESS) {
+        const char* errorStr;
+        cuda_->cuGetErrorString(res, &errorStr);
+        std::cerr << "Kernel launch failed ("
+                  << GetKernelName(launch->kernel_id) << "): " << errorStr
+                  << std::endl;
+    }
+}
+
+bool CudaManager::SubmitBatchImpl(BoundLaunch* launches, int count) {
+    MakeContextCurrent();
+    // records of a batch share the stream, look it up once
+    StreamRef stream =
+            GetStream(launches[0].stream_type, launches[0].stream_id);
+    int failed = 0;
+    CUDA_CODES first_error = CUDA_SUCCESS;
+    for (int i = 0; i < count; ++i) {
+        const BoundLaunch& launch = launches[i];
+        auto res = cuda_->cuLaunchKernel(
+                static_cast<CUfunction>(launch.kernel), launch.grid[0],
+                launch.grid[1], launch.grid[2], launch.block[0],
+                launch.block[1], launch.block[2], 0, stream,
+                const_cast<void**>(launch.args.argv), nullptr);
+        if (res != CUDA_SUCCESS && failed++ == 0) first_error = res;
+    }
+    if (failed == 0) return true;
+
+    const char* errorStr;
+    cuda_->cuGetErrorString(first_error, &errorStr);
+    std::cerr << "Batch launch failed ("
+              << GetKernelName(launches[0].kernel_id) << "): " << failed
+              << " of " << count << " launches, first error: " << errorStr
+              << std::endl;
+    return false;
+}
+
+bool CudaManager::AutotuneLaunchImpl(BoundLaunch* launch, int repeats) {
+    MakeContextCurrent();
+    LoadLaunchConfigs();
+    auto function = static_cast<CUfunction>(launch->kernel);
+    const char* name = GetKernelName(launch->kernel_id);
+    int max_threads = 0;
+    if (cuda_->cuFuncGetAttribute(&max_threads,
+                                  CU_FUNC_ATTRIBUTE_MAX_THREADS_PER_BLOCK,
+                                  function) != CUDA_SUCCESS ||
+        max_threads <= 0) {
+        max_threads = kDefaultBlockSize;
+    }
+
+    StreamRef stream =
+            GetStream(launch->stream_type, launch->stream_id);
+    CUevent start = nullptr;
+    CUevent stop = nullptr;
+    if (cuda_->cuEventCreate(&start, CU_EVENT_DEFAULT) != CUDA_SUCCESS ||
+        cuda_->cuEventCreate(&stop, CU_EVENT_DEFAULT) != CUDA_SUCCESS) {
+        std::cerr << "Warning: Failed to autotune " << name
+                  << ", timing events could not be created.\n";
+        if (start != nullptr) cuda_->cuEventDestroy(start);
+        return false;
+    }
+
+    size_t shape[3];
+    int ndim = LaunchDomain(*launch, shape);
+    unsigned int best[3] = {0, 0, 0};
+    float best_ms = -1.0f;
+    unsigned int previous[3] = {0, 0, 0};
+    for (unsigned int threads = 32;
+         threads <= static_cast<unsigned int>(max_threads); threads *= 2) {
+        unsigned int block[3];
+        ShapeLaunchBlock(threads, shape[0], block);
+        // small domains stop growing, the same shape needs no second run
+        if (block[0] == previous[0] && block[1] == previous[1] &&
+            block[2] == previous[2]) {
+            continue;
+        }
+        for (int i = 0; i < 3; ++i) { previous[i] = block[i]; }
+
+        SetLaunchDims(launch, shape, block);
+        SubmitLaunchImpl(launch);  // warm-up
+        cuda_->cuEventRecord(start, stream);
+        for (int i = 0; i < repeats; ++i) { SubmitLaunchImpl(launch); }
+        cuda_->cuEventRecord(stop, stream);
+        float ms = 0.0f;
+        if (cuda_->cuEventSynchronize(stop) != CUDA_SUCCESS ||
+            cuda_->cuEventElapsedTime(&ms, start, stop) != CUDA_SUCCESS) {
+            continue;
+        }
+        if (best_ms < 0.0f || ms < best_ms) {
+            best_ms = ms;
+            for (int i = 0; i < 3; ++i) { best[i] = block[i]; }
+        }
+    }
+    cuda_->cuEventDestroy(start);
+    cuda_->cuEventDestroy(stop);
+
+    if (best_ms < 0.0f) {
+        std::cerr << "Warning: Failed to autotune " << name
+                  << ", no candidate could be timed.\n";
+        ConfigureLaunchImpl(launch);
+        return false;
+    }
+    launch_configs_.Store(name, ndim,
+                          LaunchSizeBucket(shape[0]),
+                          best);
+    launch_configs_.Save();
+    SetLaunchDims(launch, shape, best);
+    return true;
+}
+
+bool CudaManager::BeginCaptureImpl(LaunchGraph* graph) {
+    MakeContextCurrent();
+    if (!graphs_supported_) {
+        std::cerr << "Warning: the CUDA driver does not support graphs, "
+                     "nothing is captured."
+                  << std::endl;
+        return false;
+    }
+    StreamRef stream = GetStream(graph->stream_type, graph->stream_id);
+    if (stream == nullptr) return false;
+    // thread local: work issued by other threads is not pulled into the graph
+    auto result = cuda_->cuStreamBeginCapture(
+            stream, CU_STREAM_CAPTURE_MODE_THREAD_LOCAL);
+    if (result != CUDA_SUCCESS) {
+        std::cerr << "Failed to begin stream capture. Result Code: " << result
+                  << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool CudaManager::CaptureOpImpl(LaunchGraph* graph, GraphOp* op) {
+    MakeContextCurrent();
+    StreamRef stream = GetStream(graph->stream_type, graph->stream_id);
+    CUDA_CODES result = CUDA_SUCCESS;
+    switch (op->kind) {
+        case GraphOp::KERNEL: {
+            SubmitLaunchImpl(op->launch.get());
+            // the captured launch is now the only dependency of the stream
+            CUstreamCaptureStatus status;
+            const CUgraphNode* nodes = nullptr;
+            size_t num_nodes = 0;
+            result = cuda_->cuStreamGetCaptureInfo(stream, &status, nullptr,
+                                                   nullptr, &nodes,
+                                                   &num_nodes);
+            if (result != CUDA_SUCCESS ||
+                status != CU_STREAM_CAPTURE_STATUS_ACTIVE || num_nodes != 1) {
+                return false;
+            }
+            op->node = nodes[0];
+            return true;
+        }
+        case GraphOp::COPY_TO_DEVICE:
+            result = cuda_->cuMemcpyHtoDAsync(op->device, op->host, op->size,
+                                              stream);
+            break;
+        case GraphOp::COPY_TO_HOST:
+            result = cuda_->cuMemcpyDtoHAsync(op->host, op->device, op->size,
+                                              stream);
+            break;
+    }
+    if (result != CUDA_SUCCESS) {
+        std::cerr << "Failed to capture a transfer. Result Code: " << result
+                  << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool CudaManager::EndCaptureImpl(LaunchGraph* graph) {
+    MakeContextCurrent();
+    StreamRef stream = GetStream(graph->stream_type, graph->stream_id);
+    CUgraph cu_graph = nullptr;
+    auto result = cuda_->cuStreamEndCapture(stream, &cu_graph);
+    if (result != CUDA_SUCCESS) {
+        std::cerr << "Failed to end stream capture. Result Code: " << result
+                  << std::endl;
+        return false;
+    }
+    graph->graph = cu_graph;
+    if (graph->failed) return false;
+
+    CUgraphExec exec = nullptr;
+    result = cuda_->cuGraphInstantiateWithFlags(&exec, cu_graph, 0);
+    if (result != CUDA_SUCCESS) {
+        std::cerr << "Failed to instantiate graph. Result Code: " << result
+                  << std::endl;
+        return false;
+    }
+    graph->exec = exec;
+    return true;
+}
+
+bool CudaManager::ReplayGraphImpl(LaunchGraph* graph) {
+    MakeContextCurrent();
+    auto exec = static_cast<CUgraphExec>(graph->exec);
+    for (auto& op : graph->ops) {
+        if (!op.dirty) continue;
+        const BoundLaunch* launch = op.launch.get();
+        CUDA_KERNEL_NODE_PARAMS params;
+        params.func = static_cast<CUfunction>(launch->kernel);
+        params.gridDimX = launch->grid[0];
+        params.gridDimY = launch->grid[1];
+        params.gridDimZ = launch->grid[2];
+        params.blockDimX = launch->block[0];
+        params.blockDimY = launch->block[1];
+        params.blockDimZ = launch->block[2];
+        params.sharedMemBytes = 0;
+        params.kernelParams = const_cast<void**>(launch->args.argv);
+        params.extra = nullptr;
+        auto result = cuda_->cuGraphExecKernelNodeSetParams(
+                exec, static_cast<CUgraphNode>(op.node), &params);
+        if (result != CUDA_SUCCESS) {
+            std::cerr << "Failed to update graph kernel node ("
+                      << GetKernelName(launch->kernel_id)
+                      << "). Result Code: " << result << std::endl;
+            return false;
+        }
+    }
+
+    auto result = cuda_->cuGraphLaunch(
+            exec, GetStream(graph->stream_type, graph->stream_id));
+    if (result != CUDA_SUCCESS) {
+        std::cerr << "Failed to launch graph. Result Code: " << result
+                  << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void CudaManager::ReleaseGraphImpl(LaunchGraph* graph) {
+    MakeContextCurrent();
+    if (graph->exec != nullptr) {
+        cuda_->cuGraphExecDestroy(static_cast<CUgraphExec>(graph->exec));
+    }
+    if (graph->graph != nullptr) {
+        cuda_->cuGraphDestroy(static_cast<CUgraph>(graph->graph));
+    }
+    graph->exec = nullptr;
+    graph->graph = nullptr;
+}
+
+size_t CudaManager::TrimDeviceMemory() {
+    MakeContextCurrent();
+    return memory_pool_->Trim();
 }
 
-void CudaManager::LaunchImpl(const char* func,
-                             int num_arrays,
-                             HyperArray<float>** arrays,
-                             int stream_type,
-                             int stream_id) {
-    LaunchImplT<float>(func, num_arrays, arrays, stream_type, stream_id);
+MemoryPoolStats CudaManager::GetDeviceMemoryStats() const {
+    return memory_pool_->GetStats();
 }
 
 CUcontext* CudaManager::GetCudaContext() { return &cu_context_; }
@@ -5,17 +5,29 @@
 // ----------------------------------------------------------------------------
 #pragma once
 
+#include <cstring>
 #include <iostream>
 #include <fstream>
 #include <filesystem>
 #include <vector>
 #include <map>
+#include <memory>
 #include <string>
 #include <utility>
 #include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
 
 #include "DFCudaCodes.h"
+#include "DFEventPool.h"
+#include "DFHostArena.h"
 #include "DFHyperArray.h"
+#include "DFKernelTable.h"
+#include "DFSlabAllocator.h"
+#include "DFLaunchGraph.h"
+#include "DFWarpArgs.h"
+#include "DFMemoryPool.h"
 
 #define RENDERING_STREAM 0
 #define CALCULATE_STREAM 1
@@ -25,8 +37,55 @@
 
 namespace dexsim {
 namespace cudamgr {
+// Bytes moved and bytes saved by coherence tracking, see GetTransferStats.
+struct TransferStats {
+    size_t bytes_to_device = 0;
+    size_t bytes_to_host = 0;
+    size_t bytes_skipped_to_device = 0;
+    size_t bytes_skipped_to_host = 0;
+    size_t syncs_skipped = 0;
+};
+
+// Completion marker of stream ordered work, returned by the *Async calls.
+// nullptr means the work has already completed.
+using EventHandle = CUevent;
+
+// Launch bound once with BindLaunch and resubmitted with SubmitLaunch.
+using LaunchHook = void*;
+
+// Launch sequence recorded with BeginCapture/EndCapture.
+using GraphHook = void*;
+
+// Scheduling priority of the streams of a family, see ConfigureStreamPool.
+enum StreamPriority {
+    STREAM_PRIORITY_LOW,
+    STREAM_PRIORITY_NORMAL,
+    STREAM_PRIORITY_HIGH,
+};
+
+// Streams a family creates up front, see ConfigureStreamPool.
+struct StreamPoolConfig {
+    int num_streams = 4;
+    StreamPriority priority = STREAM_PRIORITY_NORMAL;
+    // streams that do not synchronize with the default stream. Default
+    // stream launches do not wait for their work, order it with Signal/Wait
+    // or events; blocking transfers of an array first synchronize the stream
+    // it was used on. false makes the pool streams block on the default
+    // stream like created ones.
+    bool non_blocking = true;
+};
+
+// Index of a kernel in the manager's kernel table, see GetKernel.
+using KernelHandle = int;
+constexpr KernelHandle kInvalidKernel = -1;
+
+template <typename T>
+class HyperArrayRef;
+
 class ICudaManager {
 public:
+    virtual ~ICudaManager() = default;
+
     /// \brief Create a HyperArray with the specified dimensions and shape.
     ///
     /// \param arr Pointer to CUdeviceptr that will store the allocated memory
@@ -36,30 +95,33 @@ public:
     /// \param use_gpu Flag indicating whether to use GPU. If dose, the data
     /// will be copy to device, but not copy to host. \warning After a
     /// HyperArray is created, the data will be allocated on the device, and the
-    /// shape will be freeze.
+    /// shape will be freeze. Reshape, Permute and Slice create views with
+    /// another layout of the same storage.
     template <typename T>
     void CreateArray(
             HyperArrayHook* arr, int dims, int* shape, T* data, bool use_gpu) {
         switch (dims) {
             case 1:
-                *arr = new HyperArray<T>(shape[0]);
+                *arr = SlabNew<HyperArray<T>>(shape[0]);
                 break;
             case 2:
-                *arr = new HyperArray<T>(shape[0], shape[1]);
+                *arr = SlabNew<HyperArray<T>>(shape[0], shape[1]);
                 break;
             case 3:
-                *arr = new HyperArray<T>(shape[0], shape[1], shape[2]);
+                *arr = SlabNew<HyperArray<T>>(shape[0], shape[1], shape[2]);
                 break;
             case 4:
-                *arr = new HyperArray<T>(shape[0], shape[1], shape[2],
-                                         shape[3]);
+                *arr = SlabNew<HyperArray<T>>(shape[0], shape[1], shape[2],
+                                              shape[3]);
                 break;
             default:
                 // Error handling for unsupported dimensions
                 std::cerr << "Error: Unsupported number of dimensions: " << dims
                           << std::endl;
+                *arr = nullptr;
                 break;
         }
+        if (*arr == nullptr) return;
         if (use_gpu) {
             AllocateDevice<T>(*arr);
             WriteArrayDataDevice(*arr, data);
@@ -69,6 +131,247 @@ public:
         }
     }
 
+    /// \brief Creates an array owned by the returned reference, see
+    /// CreateArray
+    ///
+    /// \return Reference releasing the array with its last copy, empty on
+    /// failure
+    template <typename T>
+    HyperArrayRef<T> MakeArray(int dims, int* shape, T* data, bool use_gpu) {
+        HyperArrayHook arr = nullptr;
+        CreateArray<T>(&arr, dims, shape, data, use_gpu);
+        return HyperArrayRef<T>(this, arr);
+    }
+
+    /// \brief Releases a reference to an array or view
+    ///
+    /// The last reference releases the host and device storage held by the
+    /// header and the header itself. An array stays alive as long as views of
+    /// it exist, so releasing it before its views is fine.
+    ///
+    /// \param arr Handle from CreateArray, a view creator or
+    /// HyperArrayRef::Release
+    template <typename T>
+    void ReleaseArray(HyperArrayHook arr) {
+        auto* array = static_cast<HyperArray<T>*>(arr);
+        while (array != nullptr && --array->refs_ == 0) {
+            if (array->gpu_data_ != nullptr &&
+                array->gpu_data_->is_allocated_) {
+                ReleaseArrayDataDevice<T>(array);
+            }
+            if (array->cpu_data_ != nullptr &&
+                array->cpu_data_->is_allocated_) {
+                ReleaseArrayDataHost<T>(array);
+            }
+            // a view holds a reference to its root
+            auto* root = static_cast<HyperArray<T>*>(array->root_);
+            SlabDelete(array);
+            array = root;
+        }
+    }
+
+    /// \brief Creates an array holding num_envs environments of one shape
+    ///
+    /// All environments live in a single allocation whose leading dimension
+    /// is the environment. CreateView hands out a handle per environment.
+    ///
+    /// \param arr Receives the batched array
+    /// \param num_envs Number of environments
+    /// \param dims Number of dimensions of one environment, at most 3
+    /// \param shape Shape of one environment
+    /// \param data num_envs environments stored one after another
+    /// \param use_gpu Same as for CreateArray
+    template <typename T>
+    void CreateBatchedArray(HyperArrayHook* arr,
+                            int num_envs,
+                            int dims,
+                            int* shape,
+                            T* data,
+                            bool use_gpu) {
+        if (num_envs < 1 || dims < 1 || dims >= HYPER_ARRAY_MAX_DIMS) {
+            std::cerr << "Error: Unsupported batched array of " << num_envs
+                      << " environments with " << dims << " dimensions."
+                      << std::endl;
+            *arr = nullptr;
+            return;
+        }
+        int batched[HYPER_ARRAY_MAX_DIMS];
+        batched[0] = num_envs;
+        for (int i = 0; i < dims; ++i) { batched[i + 1] = shape[i]; }
+        CreateArray<T>(arr, dims + 1, batched, data, use_gpu);
+    }
+
+    /// \brief Creates a view of arr[index] along the leading dimension, e.g.
+    /// one environment of a batched array
+    ///
+    /// The view aliases the host and device storage of arr at an offset, no
+    /// memory is allocated or copied. It can be launched and synced like any
+    /// array and shares the host/device validity of arr, tracked for the
+    /// storage as a whole.
+    ///
+    /// \param arr Array with at least two dimensions, or a view of one
+    /// \param index Position along the leading dimension
+    /// \return The view, nullptr on invalid arguments. Must be released with
+    /// ReleaseView; the storage lives until arr and all views are released.
+    template <typename T>
+    HyperArrayHook CreateView(HyperArrayHook arr, int index) {
+        auto* src = static_cast<HyperArray<T>*>(arr);
+        if (src->ndim_ < 2 || index < 0 ||
+            static_cast<size_t>(index) >= src->shape_[0]) {
+            std::cerr << "Warning: Failed to create a view of element " << index
+                      << " of an array with " << src->ndim_
+                      << " dimensions.\n";
+            return nullptr;
+        }
+        auto* view = NewView(src);
+        view->ndim_ = src->ndim_ - 1;
+        for (size_t i = 0; i < HYPER_ARRAY_MAX_DIMS; ++i) {
+            bool kept = i < view->ndim_;
+            view->shape_[i] = kept ? src->shape_[i + 1] : 0;
+            view->strides_[i] = kept ? src->strides_[i + 1] : 0;
+        }
+        view->size_ = src->size_ / src->shape_[0];
+        view->offset_ = src->offset_ + index * src->strides_[0];
+        return view;
+    }
+
+    /// \brief Creates a view of arr with another shape of the same size
+    ///
+    /// Like CreateView, the view aliases the storage of arr without copying.
+    ///
+    /// \param arr Contiguous array or view, i.e. not transposed or sliced
+    /// with a step
+    /// \param dims Number of dimensions of the view
+    /// \param shape Shape of the view, holding as many elements as arr
+    /// \return The view, nullptr on invalid arguments. Must be released with
+    /// ReleaseView.
+    template <typename T>
+    HyperArrayHook Reshape(HyperArrayHook arr, int dims, const int* shape) {
+        auto* src = static_cast<HyperArray<T>*>(arr);
+        size_t size = 1;
+        for (int i = 0; i < dims && i < HYPER_ARRAY_MAX_DIMS; ++i) {
+            size *= shape[i] > 0 ? static_cast<size_t>(shape[i]) : 0;
+        }
+        if (dims < 1 || dims > HYPER_ARRAY_MAX_DIMS || size != src->size_) {
+            std::cerr << "Warning: Failed to reshape an array of " << src->size_
+                      << " elements to " << dims << " dimensions of "
+                      << size << " elements.\n";
+            return nullptr;
+        }
+        if (!IsContiguous(src, sizeof(T))) {
+            std::cerr << "Warning: Failed to reshape a non-contiguous view, "
+                         "copy it into a new array first.\n";
+            return nullptr;
+        }
+        auto* view = NewView(src);
+        view->ndim_ = dims;
+        size_t stride = sizeof(T);
+        for (int i = HYPER_ARRAY_MAX_DIMS - 1; i >= 0; --i) {
+            view->shape_[i] = i < dims ? shape[i] : 0;
+            view->strides_[i] = i < dims ? stride : 0;
+            if (i < dims) stride *= shape[i];
+        }
+        return view;
+    }
+
+    /// \brief Creates a view of arr with its dimensions reordered
+    ///
+    /// Only the strides of the view change, nothing is copied. The view is
+    /// usually not contiguous: kernels index it through its strides and syncs
+    /// fall back to strided copies.
+    ///
+    /// \param arr Array or view
+    /// \param perm For each dimension of the view, the dimension of arr it
+    /// takes, a permutation of 0 .. ndim - 1
+    /// \return The view, nullptr on invalid arguments. Must be released with
+    /// ReleaseView.
+    template <typename T>
+    HyperArrayHook Permute(HyperArrayHook arr, const int* perm) {
+        auto* src = static_cast<HyperArray<T>*>(arr);
+        unsigned int seen = 0;
+        for (size_t i = 0; i < src->ndim_; ++i) {
+            if (perm[i] < 0 || static_cast<size_t>(perm[i]) >= src->ndim_ ||
+                (seen & (1u << perm[i]))) {
+                std::cerr << "Warning: Failed to permute an array with "
+                          << src->ndim_ << " dimensions, the order is not a "
+                          << "permutation.\n";
+                return nullptr;
+            }
+            seen |= 1u << perm[i];
+        }
+        auto* view = NewView(src);
+        for (size_t i = 0; i < src->ndim_; ++i) {
+            view->shape_[i] = src->shape_[perm[i]];
+            view->strides_[i] = src->strides_[perm[i]];
+        }
+        return view;
+    }
+
+    /// \brief Creates a view of arr with two dimensions swapped, see Permute
+    template <typename T>
+    HyperArrayHook Transpose(HyperArrayHook arr, int dim0, int dim1) {
+        auto* src = static_cast<HyperArray<T>*>(arr);
+        int perm[HYPER_ARRAY_MAX_DIMS] = {0, 1, 2, 3};
+        if (dim0 < 0 || dim1 < 0 || static_cast<size_t>(dim0) >= src->ndim_ ||
+            static_cast<size_t>(dim1) >= src->ndim_) {
+            std::cerr << "Warning: Failed to transpose dimensions " << dim0
+                      << " and " << dim1 << " of an array with " << src->ndim_
+                      << " dimensions.\n";
+            return nullptr;
+        }
+        std::swap(perm[dim0], perm[dim1]);
+        return Permute<T>(arr, perm);
+    }
+
+    /// \brief Creates a view of the elements begin, begin + step, ... before
+    /// end along one dimension of arr
+    ///
+    /// The view keeps the number of dimensions of arr. Slicing the leading
+    /// dimension with step 1 keeps it contiguous, anything else results in a
+    /// strided view, see Permute.
+    ///
+    /// \param arr Array or view
+    /// \param dim Dimension to slice
+    /// \param begin First element, inclusive
+    /// \param end Last element, exclusive, begin < end <= shape[dim]
+    /// \param step Distance between the elements, at least 1
+    /// \return The view, nullptr on invalid arguments. Must be released with
+    /// ReleaseView.
+    template <typename T>
+    HyperArrayHook Slice(
+            HyperArrayHook arr, int dim, int begin, int end, int step = 1) {
+        auto* src = static_cast<HyperArray<T>*>(arr);
+        if (dim < 0 || static_cast<size_t>(dim) >= src->ndim_ || begin < 0 ||
+            begin >= end || static_cast<size_t>(end) > src->shape_[dim] ||
+            step < 1) {
+            std::cerr << "Warning: Failed to slice [" << begin << ", " << end
+                      << ") with step " << step << " from dimension " << dim
+                      << " of an array with " << src->ndim_
+                      << " dimensions.\n";
+            return nullptr;
+        }
+        auto* view = NewView(src);
+        view->shape_[dim] = (end - begin + step - 1) / step;
+        view->strides_[dim] = src->strides_[dim] * step;
+        view->size_ = src->size_ / src->shape_[dim] * view->shape_[dim];
+        view->offset_ = src->offset_ + begin * src->strides_[dim];
+        return view;
+    }
+
+    /// \brief Releases a view created with CreateView, Reshape, Permute,
+    /// Transpose or Slice
+    template <typename T>
+    void ReleaseView(HyperArrayHook view) {
+        auto* array = static_cast<HyperArray<T>*>(view);
+        if (array == nullptr) return;
+        if (array->root_ == nullptr) {
+            std::cerr << "Warning: Failed to release view, the array was not "
+                         "created by CreateView.\n";
+            return;
+        }
+        ReleaseArray<T>(view);
+    }
+
     /// \brief Allocates device memory for a HyperArray
     ///
     /// \tparam T Type of data stored in the array
@@ -84,10 +387,11 @@ public:
             return;
         }
 
-        array->gpu_data_ = new SharedDataGPU;
+        array->gpu_data_ = SlabNew<SharedDataGPU>();
         AllocateDeviceMemoryImpl(&(array->gpu_data_->value_),
-                                 array->strides_[0] * array->shape_[0]);
+                                 sizeof(T) * array->size_);
         array->gpu_data_->is_allocated_ = true;
+        array->valid_ &= ~ARRAY_DEVICE_VALID;
     }
 
     /// \brief Allocates host memory for a HyperArray
@@ -104,18 +408,77 @@ public:
                          "data has been allocated.\n";
             return;
         }
-        array->cpu_data_ = new SharedDataCPU<T>;
-        array->cpu_data_->value_ = new T[array->size_];
+        bool pinned = pinned_host_memory_;
+        T* value = static_cast<T*>(
+                AllocateHostMemoryImpl(sizeof(T) * array->size_, pinned));
+        if (value == nullptr) {
+            std::cerr << "Warning: Failed to allocate host memory.\n";
+            return;
+        }
+        array->cpu_data_ = SlabNew<SharedDataCPU<T>>();
+        array->cpu_data_->value_ = value;
+        array->cpu_data_->is_pinned_ = pinned;
         array->cpu_data_->is_allocated_ = true;
+        array->valid_ &= ~ARRAY_HOST_VALID;
+    }
+
+    /// \brief Selects page-locked memory for host storage allocated by
+    /// AllocateHost from now on
+    ///
+    /// \param enable true to allocate pinned host memory
+    /// \note Pinned transfers run at full bus bandwidth and can overlap with
+    /// kernels, but page-locked memory is a scarce system resource.
+    void SetPinnedHostMemory(bool enable) { pinned_host_memory_ = enable; }
+
+    /// \brief Declares that the host copy was modified outside the manager,
+    /// e.g. through a pointer obtained with ShareFromArrayDataHost
+    ///
+    /// \tparam T Type of data stored in the array
+    /// \param arr HyperArray handle created with CreateArray
+    template <typename T>
+    void MarkHostModified(HyperArrayHook arr) {
+        SetValidity(ToArrayBase(arr), ARRAY_HOST_VALID);
+    }
+
+    /// \brief Declares that the device copy was modified outside the manager,
+    /// e.g. by PhysX or a kernel launched directly through the driver
+    ///
+    /// \tparam T Type of data stored in the array
+    /// \param arr HyperArray handle created with CreateArray
+    template <typename T>
+    void MarkDeviceModified(HyperArrayHook arr) {
+        SetValidity(ToArrayBase(arr), ARRAY_DEVICE_VALID);
+    }
+
+    /// \brief Bytes transferred and bytes saved by skipping clean syncs
+    TransferStats GetTransferStats() const {
+        TransferStats stats;
+        stats.bytes_to_device = transfer_stats_.bytes_to_device;
+        stats.bytes_to_host = transfer_stats_.bytes_to_host;
+        stats.bytes_skipped_to_device = transfer_stats_.bytes_skipped_to_device;
+        stats.bytes_skipped_to_host = transfer_stats_.bytes_skipped_to_host;
+        stats.syncs_skipped = transfer_stats_.syncs_skipped;
+        return stats;
+    }
+
+    /// \brief Resets the counters returned by GetTransferStats
+    void ResetTransferStats() {
+        transfer_stats_.bytes_to_device = 0;
+        transfer_stats_.bytes_to_host = 0;
+        transfer_stats_.bytes_skipped_to_device = 0;
+        transfer_stats_.bytes_skipped_to_host = 0;
+        transfer_stats_.syncs_skipped = 0;
     }
 
     /// \brief Synchronizes data from the host to the device
     ///
     /// \tparam T Type of data stored in the array
     /// \param arr HyperArray handle created with CreateArray
+    /// \note Does nothing when the device copy is already current.
     template <typename T>
     void SyncToDevice(HyperArrayHook arr) {
         auto* array = static_cast<HyperArray<T>*>(arr);
+        if (RejectWhileCapturing("SyncToDevice")) return;
 
         if (array->gpu_data_ == nullptr ||
             array->gpu_data_->is_allocated_ == false) {
@@ -128,9 +491,12 @@ public:
                          "has not been allocated.\n";
             return;
         }
+        FinishPendingCopy(array);
+        size_t bytes = sizeof(T) * array->size_;
+        if (SkipSyncToDevice(ValidityOf(array), bytes)) return;
         // Transfer data from host to device
-        SyncToDeviceImpl(array->cpu_data_->value_, array->gpu_data_->value_,
-                         array->strides_[0] * array->shape_[0]);
+        CopyToDevice(array, sizeof(T), HostPtrOf(array), false);
+        SetValidity(array, ARRAY_BOTH_VALID);
     }
 
     /// \brief Synchronizes data from the device to the host
@@ -139,9 +505,11 @@ public:
     /// \param arr HyperArray handle created with CreateArray
     /// \warning This function should be called only after the HyperArray has
     /// been created
+    /// \note Does nothing when the host copy is already current.
     template <typename T>
     void SyncToHost(HyperArrayHook arr) {
         auto* array = reinterpret_cast<HyperArray<T>*>(arr);
+        if (RejectWhileCapturing("SyncToHost")) return;
         if (array->gpu_data_->is_allocated_ == false) {
             std::cerr << "Warning: Failed to sync host memory, GPU memory "
                          "has not been allocated.\n";
@@ -152,9 +520,12 @@ public:
                          "has not been allocated.\n";
             return;
         }
+        FinishPendingCopy(array);
+        size_t bytes = sizeof(T) * array->size_;
+        if (SkipSyncToHost(ValidityOf(array), bytes)) return;
         // Transfer data from device to host
-        SyncToHostImpl(array->gpu_data_->value_, array->cpu_data_->value_,
-                       array->strides_[0] * array->shape_[0]);
+        CopyToHost(array, sizeof(T), HostPtrOf(array), false);
+        SetValidity(array, ARRAY_BOTH_VALID);
     }
 
     /// \brief Retrieves host data from a HyperArray
@@ -165,9 +536,9 @@ public:
     template <typename T>
     void GetArrayDataHost(HyperArrayHook arr, T* data) {
         auto* array = reinterpret_cast<HyperArray<T>*>(arr);
+        FinishPendingCopy(array);
         // Copy data from HyperArray's host storage to output buffer
-        std::copy(array->cpu_data_->value_,
-                  array->cpu_data_->value_ + array->size_, data);
+        PackHost(array, data);
     }
 
     /// \brief Retrieves device data from a HyperArray
@@ -178,9 +549,20 @@ public:
     template <typename T>
     void GetArrayDataDevice(HyperArrayHook arr, T* data) {
         auto* array = reinterpret_cast<HyperArray<T>*>(arr);
+        if (RejectWhileCapturing("GetArrayDataDevice")) return;
+        FinishPendingCopy(array);
+        size_t bytes = sizeof(T) * array->size_;
+        // an up to date host copy is read without touching the bus
+        if (ValidityOf(array) == ARRAY_BOTH_VALID &&
+            array->cpu_data_ != nullptr && array->cpu_data_->is_allocated_) {
+            PackHost(array, data);
+            transfer_stats_.bytes_skipped_to_host += bytes;
+            transfer_stats_.syncs_skipped += 1;
+            return;
+        }
         // Transfer data from device directly to output buffer
-        SyncToHostImpl(array->gpu_data_->value_, data,
-                       array->strides_[0] * array->shape_[0]);
+        CopyToHost(array, sizeof(T), data, true);
+        transfer_stats_.bytes_to_host += bytes;
     }
 
     /// \brief Writes data to a HyperArray on the host
@@ -196,7 +578,9 @@ public:
                          "has not been allocated.\n";
             return;
         }
-        std::copy(data, data + array->size_, array->cpu_data_->value_);
+        FinishPendingCopy(array);
+        UnpackHost(array, data);
+        SetValidity(array, ARRAY_HOST_VALID);
     }
 
     /// \brief Writes data to a HyperArray on the device
@@ -207,15 +591,285 @@ public:
     template <typename T>
     void WriteArrayDataDevice(HyperArrayHook arr, T* data) {
         auto* array = reinterpret_cast<HyperArray<T>*>(arr);
+        if (RejectWhileCapturing("WriteArrayDataDevice")) return;
         if (array->gpu_data_ == nullptr || !array->gpu_data_->is_allocated_) {
             std::cerr << "Warning: Failed to write device memory, GPU memory "
                          "has not been allocated.\n";
             return;
         }
-        SyncToDeviceImpl(data, array->gpu_data_->value_,
-                         array->strides_[0] * array->shape_[0]);
+        FinishPendingCopy(array);
+        size_t bytes = sizeof(T) * array->size_;
+        CopyToDevice(array, sizeof(T), data, true);
+        transfer_stats_.bytes_to_device += bytes;
+        SetValidity(array, ARRAY_DEVICE_VALID);
+    }
+
+    /// \brief Enqueues a host to device copy of a HyperArray on a stream
+    ///
+    /// \tparam T Type of data stored in the array
+    /// \param arr HyperArray handle created with CreateArray
+    /// \param stream_type The type of the stream family, -1 for the default
+    /// stream
+    /// \param stream_id The ID of the stream in the family
+    /// \return Event completed once the copy is done, release it with
+    /// ReleaseEvent. nullptr means there is nothing to wait for: the copy
+    /// already finished, was not needed, was captured, or failed with a
+    /// warning and left the array untouched. The same holds for the other
+    /// *Async transfers.
+    /// \warning The host data must stay untouched until the event completes.
+    /// Copies only overlap with the host when the host memory is pinned.
+    /// \note A non-contiguous view is copied with blocking 2D copies before
+    /// returning nullptr, such copies cannot be captured either. The same
+    /// holds for the other *Async transfers.
+    /// \note The blocking calls on the array, e.g. SyncToHost,
+    /// GetArrayDataDevice or WriteArrayDataHost, wait for the copy first, and
+    /// later *Async copies of the array start after it. The same holds for
+    /// the other *Async transfers.
+    template <typename T>
+    EventHandle SyncToDeviceAsync(HyperArrayHook arr,
+                                  int stream_type,
+                                  int stream_id) {
+        auto* array = static_cast<HyperArray<T>*>(arr);
+        if (array->gpu_data_ == nullptr || !array->gpu_data_->is_allocated_) {
+            std::cerr << "Warning: Failed to sync device memory, GPU memory "
+                         "has not been allocated.\n";
+            return nullptr;
+        }
+        if (array->cpu_data_ == nullptr || !array->cpu_data_->is_allocated_) {
+            std::cerr << "Warning: Failed to sync device memory, CPU memory "
+                         "has not been allocated.\n";
+            return nullptr;
+        }
+        size_t bytes = sizeof(T) * array->size_;
+        if (!IsContiguous(array, sizeof(T))) {
+            if (RejectStridedCapture("SyncToDeviceAsync")) return nullptr;
+            SyncToDevice<T>(arr);
+            return nullptr;
+        }
+        if (Capturing() != nullptr) {
+            CaptureCopy(GraphOp::COPY_TO_DEVICE, array, true,
+                        HostPtrOf(array), bytes, ARRAY_BOTH_VALID);
+            return nullptr;
+        }
+        if (SkipSyncToDevice(ValidityOf(array), bytes)) {
+            // the copy that made it current may still be running
+            FinishPendingCopy(array);
+            return nullptr;
+        }
+        OrderAfterPendingCopy(array, stream_type, stream_id);
+        EventHandle event = nullptr;
+        if (!SyncToDeviceAsyncImpl(HostPtrOf(array), DeviceDataOf(array),
+                                   bytes, stream_type, stream_id, &event)) {
+            return nullptr;
+        }
+        // blocking calls wait for the copy before trusting the bits
+        NoteStreamUse(array, stream_type, stream_id);
+        SetPendingCopy(array, stream_type, stream_id, event);
+        SetValidity(array, ARRAY_BOTH_VALID);
+        return event;
+    }
+
+    /// \brief Enqueues a device to host copy of a HyperArray on a stream
+    ///
+    /// \tparam T Type of data stored in the array
+    /// \param arr HyperArray handle created with CreateArray
+    /// \param stream_type The type of the stream family, -1 for the default
+    /// stream
+    /// \param stream_id The ID of the stream in the family
+    /// \return Event completed once the host data is valid, nullptr if there
+    /// is nothing to wait for. Release it with ReleaseEvent.
+    template <typename T>
+    EventHandle SyncToHostAsync(HyperArrayHook arr,
+                                int stream_type,
+                                int stream_id) {
+        auto* array = static_cast<HyperArray<T>*>(arr);
+        if (array->gpu_data_ == nullptr || !array->gpu_data_->is_allocated_) {
+            std::cerr << "Warning: Failed to sync host memory, GPU memory "
+                         "has not been allocated.\n";
+            return nullptr;
+        }
+        if (array->cpu_data_ == nullptr || !array->cpu_data_->is_allocated_) {
+            std::cerr << "Warning: Failed to sync host memory, CPU memory "
+                         "has not been allocated.\n";
+            return nullptr;
+        }
+        size_t bytes = sizeof(T) * array->size_;
+        if (!IsContiguous(array, sizeof(T))) {
+            if (RejectStridedCapture("SyncToHostAsync")) return nullptr;
+            SyncToHost<T>(arr);
+            return nullptr;
+        }
+        if (Capturing() != nullptr) {
+            CaptureCopy(GraphOp::COPY_TO_HOST, array, true,
+                        HostPtrOf(array), bytes, ARRAY_BOTH_VALID);
+            return nullptr;
+        }
+        if (SkipSyncToHost(ValidityOf(array), bytes)) {
+            // the copy that made it current may still be running
+            FinishPendingCopy(array);
+            return nullptr;
+        }
+        OrderAfterPendingCopy(array, stream_type, stream_id);
+        EventHandle event = nullptr;
+        if (!SyncToHostAsyncImpl(DeviceDataOf(array), HostPtrOf(array), bytes,
+                                 stream_type, stream_id, &event)) {
+            return nullptr;
+        }
+        // the host copy may only be read after the returned event completes,
+        // blocking calls wait for it before trusting the bits
+        NoteStreamUse(array, stream_type, stream_id);
+        SetPendingCopy(array, stream_type, stream_id, event);
+        SetValidity(array, ARRAY_BOTH_VALID);
+        return event;
     }
 
+    /// \brief Enqueues a copy of the device data of a HyperArray into a
+    /// caller buffer
+    ///
+    /// \tparam T Type of data stored in the array
+    /// \param arr HyperArray handle created with CreateArray
+    /// \param data Output buffer, valid once the returned event completes
+    /// \param stream_type The type of the stream family, -1 for the default
+    /// stream
+    /// \param stream_id The ID of the stream in the family
+    /// \return Event to wait on, nullptr if there is nothing to wait for
+    template <typename T>
+    EventHandle GetArrayDataDeviceAsync(HyperArrayHook arr,
+                                        T* data,
+                                        int stream_type,
+                                        int stream_id) {
+        auto* array = reinterpret_cast<HyperArray<T>*>(arr);
+        if (array->gpu_data_ == nullptr || !array->gpu_data_->is_allocated_) {
+            std::cerr << "Warning: Failed to read device memory, GPU memory "
+                         "has not been allocated.\n";
+            return nullptr;
+        }
+        size_t bytes = sizeof(T) * array->size_;
+        if (!IsContiguous(array, sizeof(T))) {
+            if (RejectStridedCapture("GetArrayDataDeviceAsync")) {
+                return nullptr;
+            }
+            GetArrayDataDevice<T>(arr, data);
+            return nullptr;
+        }
+        if (Capturing() != nullptr) {
+            CaptureCopy(GraphOp::COPY_TO_HOST, array, false, data, bytes, -1);
+            return nullptr;
+        }
+        OrderAfterPendingCopy(array, stream_type, stream_id);
+        EventHandle event = nullptr;
+        if (!SyncToHostAsyncImpl(DeviceDataOf(array), data, bytes, stream_type,
+                                 stream_id, &event)) {
+            return nullptr;
+        }
+        transfer_stats_.bytes_to_host += bytes;
+        NoteStreamUse(array, stream_type, stream_id);
+        return event;
+    }
+
+    /// \brief Enqueues a copy of a caller buffer into the device data of a
+    /// HyperArray
+    ///
+    /// \tparam T Type of data stored in the array
+    /// \param arr HyperArray handle created with CreateArray
+    /// \param data Host data, must stay untouched until the event completes
+    /// \param stream_type The type of the stream family, -1 for the default
+    /// stream
+    /// \param stream_id The ID of the stream in the family
+    /// \return Event to wait on, nullptr if there is nothing to wait for
+    template <typename T>
+    EventHandle WriteArrayDataDeviceAsync(HyperArrayHook arr,
+                                          T* data,
+                                          int stream_type,
+                                          int stream_id) {
+        auto* array = reinterpret_cast<HyperArray<T>*>(arr);
+        if (array->gpu_data_ == nullptr || !array->gpu_data_->is_allocated_) {
+            std::cerr << "Warning: Failed to write device memory, GPU memory "
+                         "has not been allocated.\n";
+            return nullptr;
+        }
+        size_t bytes = sizeof(T) * array->size_;
+        if (!IsContiguous(array, sizeof(T))) {
+            if (RejectStridedCapture("WriteArrayDataDeviceAsync")) {
+                return nullptr;
+            }
+            WriteArrayDataDevice<T>(arr, data);
+            return nullptr;
+        }
+        if (Capturing() != nullptr) {
+            CaptureCopy(GraphOp::COPY_TO_DEVICE, array, false, data, bytes,
+                        ARRAY_DEVICE_VALID);
+            return nullptr;
+        }
+        OrderAfterPendingCopy(array, stream_type, stream_id);
+        EventHandle event = nullptr;
+        if (!SyncToDeviceAsyncImpl(data, DeviceDataOf(array), bytes,
+                                   stream_type, stream_id, &event)) {
+            return nullptr;
+        }
+        transfer_stats_.bytes_to_device += bytes;
+        NoteStreamUse(array, stream_type, stream_id);
+        SetPendingCopy(array, stream_type, stream_id, event);
+        SetValidity(array, ARRAY_DEVICE_VALID);
+        return event;
+    }
+
+    /// \brief Blocks the calling thread until the event has completed
+    ///
+    /// \param event Event returned by one of the *Async calls, nullptr
+    /// returns at once
+    virtual void WaitEvent(EventHandle event) = 0;
+
+    /// \brief Makes all future work on a stream wait for the event, without
+    /// blocking the host
+    ///
+    /// \param stream_type The type of the stream family, -1 for the default
+    /// stream
+    /// \param stream_id The ID of the stream in the family
+    /// \param event Event returned by one of the *Async calls
+    virtual void StreamWaitEvent(int stream_type,
+                                 int stream_id,
+                                 EventHandle event) = 0;
+
+    /// \brief Checks whether the event has completed
+    ///
+    /// \param event Event returned by one of the *Async calls
+    /// \return true once the work before the event has finished
+    virtual bool QueryEvent(EventHandle event) = 0;
+
+    /// \brief Gives an event back, the handle must not be used afterwards
+    ///
+    /// \param event Event returned by one of the *Async calls
+    virtual void ReleaseEvent(EventHandle event) = 0;
+
+    /// \brief Marks the work queued on a stream so far, so that other
+    /// streams can wait for it
+    ///
+    /// Tokens are backed by recycled events and need no release.
+    ///
+    /// \param stream_type The type of the stream family, -1 for the default
+    /// stream
+    /// \param stream_id The ID of the stream in the family
+    /// \return Token for Wait, kNoSignal on failure
+    virtual SignalToken Signal(int stream_type, int stream_id) = 0;
+
+    /// \brief Makes all future work on a stream wait for a token, without
+    /// blocking the host
+    ///
+    /// \param stream_type The type of the stream family, -1 for the default
+    /// stream
+    /// \param stream_id The ID of the stream in the family
+    /// \param token Token returned by Signal
+    virtual void Wait(int stream_type, int stream_id, SignalToken token) = 0;
+
+    /// \brief Checks whether the work before a token has finished, never
+    /// blocks
+    virtual bool QuerySignal(SignalToken token) = 0;
+
+    /// \brief Blocks the calling thread until the work before a token has
+    /// finished
+    virtual void WaitSignal(SignalToken token) = 0;
+
     /// \brief Releases GPU data for a HyperArray
     ///
     /// \tparam T Type of data stored in the array
@@ -230,6 +884,7 @@ public:
         }
         ReleaseArrayDataDeviceImpl(array->gpu_data_);
         array->gpu_data_ = nullptr;
+        array->valid_ &= ~ARRAY_DEVICE_VALID;
     }
 
     /// \brief Releases CPU data for a HyperArray
@@ -244,9 +899,15 @@ public:
                          "has not been allocated.\n";
             return;
         }
-        array->cpu_data_->semaphore_ -= 1;
-        if (array->cpu_data_->semaphore_ == 0) { delete array->cpu_data_; }
+        // a pending copy may still read or write the storage
+        FinishPendingCopy(array);
+        if (--array->cpu_data_->semaphore_ == 0) {
+            ReleaseHostMemoryImpl(array->cpu_data_->value_,
+                                  array->cpu_data_->is_pinned_);
+            SlabDelete(array->cpu_data_);
+        }
         array->cpu_data_ = nullptr;
+        array->valid_ &= ~ARRAY_HOST_VALID;
     }
 
     /// \brief Shares CPU data between two HyperArrays
@@ -272,17 +933,22 @@ public:
                          "memory has not been allocated.\n";
             return;
         }
+        if (dstArray->cpu_data_ == srcArray->cpu_data_) return;
+        ReleaseArrayDataHost<T>(dstArray);
         dstArray->cpu_data_ = srcArray->cpu_data_;
         dstArray->cpu_data_->semaphore_ += 1;
+        dstArray->valid_ = (dstArray->valid_ & ~ARRAY_HOST_VALID) |
+                           (srcArray->valid_ & ARRAY_HOST_VALID);
     }
 
     /// \brief Shares CPU data from a HyperArray to a pointer
     ///
     /// \param src Source HyperArray handle
-    /// \param dst Destination pointer
+    /// \param dst Receives the first element of src, valid while src holds
+    /// its host storage. Writes through it need MarkHostModified.
     /// \tparam T Type of data stored in the array
     template <typename T>
-    void ShareFromArrayDataHost(HyperArrayHook src, T* dst) {
+    void ShareFromArrayDataHost(HyperArrayHook src, T** dst) {
         auto* srcArray = reinterpret_cast<HyperArray<T>*>(src);
         if (srcArray->cpu_data_ == nullptr ||
             !srcArray->cpu_data_->is_allocated_) {
@@ -291,7 +957,7 @@ public:
                          "memory has not been allocated.\n";
             return;
         }
-        dst = srcArray->cpu_data_->value_;
+        *dst = HostPtrOf(srcArray);
     }
 
     /// \brief Shares GPU data between two HyperArrays
@@ -317,9 +983,12 @@ public:
                          "memory has not been allocated.\n";
             return;
         }
+        if (dstArray->gpu_data_ == srcArray->gpu_data_) return;
         ReleaseArrayDataDevice<T>(dstArray);
         dstArray->gpu_data_ = srcArray->gpu_data_;
         dstArray->gpu_data_->semaphore_ += 1;
+        dstArray->valid_ = (dstArray->valid_ & ~ARRAY_DEVICE_VALID) |
+                           (srcArray->valid_ & ARRAY_DEVICE_VALID);
     }
 
     /// \brief Shares GPU data from a pointer to a HyperArray
@@ -337,19 +1006,22 @@ public:
             return;
         }
         ReleaseArrayDataDevice<T>(dstArray);
-        dstArray->gpu_data_ = new SharedDataGPU;
+        dstArray->gpu_data_ = SlabNew<SharedDataGPU>();
         dstArray->gpu_data_->value_ = (CUdeviceptr)src;
         dstArray->gpu_data_->is_allocated_ = true;
+        dstArray->gpu_data_->is_external_ = true;
+        dstArray->valid_ = ARRAY_DEVICE_VALID;
         dstArray->gpu_data_->semaphore_ = 1;
     }
 
     /// \brief Shares GPU data from a HyperArray to a pointer
     ///
     /// \param src Source HyperArray handle
-    /// \param dst Destination pointer
+    /// \param dst Receives the device address of the first element of src,
+    /// valid while src holds its device storage
     /// \tparam T Type of data stored in the array
     template <typename T>
-    void ShareFromArrayDataDevice(HyperArrayHook src, T* dst) {
+    void ShareFromArrayDataDevice(HyperArrayHook src, T** dst) {
         auto* srcArray = reinterpret_cast<HyperArray<T>*>(src);
         if (srcArray->gpu_data_ == nullptr ||
             srcArray->gpu_data_->is_allocated_ == false) {
@@ -358,30 +1030,491 @@ public:
                          "memory has not been allocated.\n";
             return;
         }
-        dst = (T*)srcArray->gpu_data_->value_;
+        *dst = reinterpret_cast<T*>(DeviceDataOf(srcArray));
+    }
+
+    /// \brief Looks up a kernel once so that launches can skip the name
+    /// lookup
+    ///
+    /// \param func Name of the kernel function
+    /// \return Handle for Launch and BindLaunch, kInvalidKernel if no kernel
+    /// of that name exists
+    KernelHandle GetKernel(const char* func) {
+        KernelHandle handle = kernel_table_.Find(func);
+        if (handle != kInvalidKernel) return handle;
+        void* kernel = FindKernelImpl(func);
+        if (kernel == nullptr) return kInvalidKernel;
+        // a thread racing on the same name gets the handle added first
+        return kernel_table_.Add(func, kernel);
+    }
+
+    /// \brief Loads the given kernels ahead of their first launch
+    ///
+    /// Kernel modules are otherwise loaded by the first launch of one of their
+    /// kernels. Preloading moves that cost out of latency-critical code, and
+    /// the modules of all given kernels are read and loaded in parallel.
+    ///
+    /// \param funcs Names of the kernels
+    /// \param count Number of names
+    /// \return Number of kernels that are ready to launch
+    int Preload(const char* const* funcs, int count) {
+        // lets the backend fetch the modules of all kernels at once
+        PreloadImpl(funcs, count);
+        int loaded = 0;
+        for (int i = 0; i < count; ++i) {
+            if (GetKernel(funcs[i]) != kInvalidKernel) {
+                ++loaded;
+            } else {
+                std::cerr << "Warning: Failed to preload kernel " << funcs[i]
+                          << ".\n";
+            }
+        }
+        return loaded;
+    }
+
+    /// \brief Name of a kernel returned by GetKernel
+    const char* GetKernelName(KernelHandle kernel) const {
+        const char* name = kernel_table_.Name(kernel);
+        return name != nullptr ? name : "invalid kernel";
     }
 
     /// \brief Launches a custom Warp kernel
     ///
+    /// Arguments may have different element types, each one is passed as the
+    /// wp::array_t of its own dtype.
+    ///
     /// \param func Name of the kernel function to launch
     /// \param num_arrays Number of arrays to pass to the kernel
     /// \param arrays Array of HyperArrayHook pointers representing the arrays
     /// \param stream_type Type of the stream to use for the kernel launch
     /// \param stream_id ID of the stream to use for the kernel launch
+    /// \param write_mask Bit i set means the kernel writes arrays[i], which
+    /// makes its host copy stale. Defaults to every array.
+    void Launch(const char* func,
+                int num_arrays,
+                HyperArrayHook* arrays,
+                int stream_type,
+                int stream_id,
+                uint32_t write_mask = ~0u) {
+        KernelHandle kernel = GetKernel(func);
+        if (kernel == kInvalidKernel) {
+            std::cerr << "Kernel launch failed (" << func
+                      << "): kernel not found." << std::endl;
+            return;
+        }
+        Launch(kernel, num_arrays, arrays, stream_type, stream_id, write_mask);
+    }
+
+    /// \brief Launches a kernel looked up with GetKernel
+    ///
+    /// \param kernel Handle returned by GetKernel
+    /// \param num_arrays Number of arrays to pass to the kernel
+    /// \param arrays Array of HyperArrayHook pointers representing the arrays
+    /// \param stream_type Type of the stream to use for the kernel launch
+    /// \param stream_id ID of the stream to use for the kernel launch
+    /// \param write_mask Bit i set means the kernel writes arrays[i]
+    void Launch(KernelHandle kernel,
+                int num_arrays,
+                HyperArrayHook* arrays,
+                int stream_type,
+                int stream_id,
+                uint32_t write_mask = ~0u) {
+        // a one-off launch binds on the stack, nothing touches the heap
+        BoundLaunch launch;
+        if (!BindKernel(&launch, kernel, num_arrays, arrays, stream_type,
+                        stream_id, write_mask)) {
+            return;
+        }
+        SubmitLaunch(&launch);
+    }
+
+    /// \brief Launch for arrays that all store T, same as the untyped Launch
     /// \tparam T Type of data stored in the arrays
     template <typename T>
     void Launch(const char* func,
                 int num_arrays,
                 HyperArrayHook* arrays,
                 int stream_type,
-                int stream_id) {
-        std::vector<HyperArray<T>*> converted_arrays(num_arrays);
-        for (int i = 0; i < num_arrays; ++i) {
-            converted_arrays[i] = reinterpret_cast<HyperArray<T>*>(arrays[i]);
+                int stream_id,
+                uint32_t write_mask = ~0u) {
+        Launch(func, num_arrays, arrays, stream_type, stream_id, write_mask);
+    }
+
+    /// \brief Launch for arrays that all store T, same as the untyped Launch
+    /// \tparam T Type of data stored in the arrays
+    template <typename T>
+    void Launch(KernelHandle kernel,
+                int num_arrays,
+                HyperArrayHook* arrays,
+                int stream_type,
+                int stream_id,
+                uint32_t write_mask = ~0u) {
+        Launch(kernel, num_arrays, arrays, stream_type, stream_id, write_mask);
+    }
+
+    /// \brief Binds a kernel to its arrays so that it can be submitted every
+    /// frame without repeating the kernel lookup and argument packing
+    ///
+    /// \param func Name of the kernel function to launch
+    /// \param num_arrays Number of arrays to pass to the kernel
+    /// \param arrays Array of HyperArrayHook pointers representing the arrays
+    /// \param stream_type Type of the stream to use for the kernel launch
+    /// \param stream_id ID of the stream to use for the kernel launch
+    /// \param write_mask Bit i set means the kernel writes arrays[i]
+    /// \return Handle for SubmitLaunch, nullptr if the kernel does not exist.
+    /// Must be released with ReleaseLaunch.
+    LaunchHook BindLaunch(const char* func,
+                          int num_arrays,
+                          HyperArrayHook* arrays,
+                          int stream_type,
+                          int stream_id,
+                          uint32_t write_mask = ~0u) {
+        KernelHandle kernel = GetKernel(func);
+        if (kernel == kInvalidKernel) {
+            std::cerr << "Kernel launch failed (" << func
+                      << "): kernel not found." << std::endl;
+            return nullptr;
+        }
+        return BindLaunch(kernel, num_arrays, arrays, stream_type, stream_id,
+                          write_mask);
+    }
+
+    /// \brief Binds a kernel looked up with GetKernel to its arrays
+    ///
+    /// \return Handle for SubmitLaunch, nullptr on invalid arguments
+    LaunchHook BindLaunch(KernelHandle kernel,
+                          int num_arrays,
+                          HyperArrayHook* arrays,
+                          int stream_type,
+                          int stream_id,
+                          uint32_t write_mask = ~0u) {
+        auto* launch = new BoundLaunch;
+        if (!BindKernel(launch, kernel, num_arrays, arrays, stream_type,
+                        stream_id, write_mask)) {
+            delete launch;
+            return nullptr;
+        }
+        return launch;
+    }
+
+    /// \brief BindLaunch for arrays that all store T
+    /// \tparam T Type of data stored in the arrays
+    template <typename T>
+    LaunchHook BindLaunch(const char* func,
+                          int num_arrays,
+                          HyperArrayHook* arrays,
+                          int stream_type,
+                          int stream_id,
+                          uint32_t write_mask = ~0u) {
+        return BindLaunch(func, num_arrays, arrays, stream_type, stream_id,
+                          write_mask);
+    }
+
+    /// \brief BindLaunch for arrays that all store T
+    /// \tparam T Type of data stored in the arrays
+    template <typename T>
+    LaunchHook BindLaunch(KernelHandle kernel,
+                          int num_arrays,
+                          HyperArrayHook* arrays,
+                          int stream_type,
+                          int stream_id,
+                          uint32_t write_mask = ~0u) {
+        return BindLaunch(kernel, num_arrays, arrays, stream_type, stream_id,
+                          write_mask);
+    }
+
+    /// \brief Submits a launch created with BindLaunch
+    ///
+    /// The arguments are only repacked when the device memory or the shape of
+    /// one of the bound arrays changed since the previous submission.
+    void SubmitLaunch(LaunchHook handle) {
+        auto* launch = static_cast<BoundLaunch*>(handle);
+        if (Capturing() != nullptr) {
+            CaptureLaunch(*launch);
+            return;
         }
+        if (!launch->packed || WarpArgsStale(*launch)) {
+            if (!PackWarpArgs(launch)) {
+                std::cerr << "Kernel launch failed ("
+                          << GetKernelName(launch->kernel_id)
+                          << "): an argument has no device memory allocated."
+                          << std::endl;
+                launch->packed = false;
+                return;
+            }
+            ConfigureLaunchImpl(launch);
+            launch->packed = true;
+        }
+        SubmitLaunchImpl(launch);
+        MarkSubmitted(*launch);
+    }
+
+    /// \brief Launches one kernel over many independent argument sets
+    ///
+    /// All records are validated and packed first, in one pass over a reused
+    /// contiguous buffer; consecutive records with the same shapes share their
+    /// launch dimensions. They are then submitted back-to-back on the stream.
+    /// An invalid record fails the whole batch with a single error message
+    /// and nothing is submitted.
+    ///
+    /// \param kernel Handle returned by GetKernel
+    /// \param records Argument sets, one launch each
+    /// \param count Number of records
+    /// \param stream_type Type of the stream to use for all launches
+    /// \param stream_id ID of the stream to use for all launches
+    /// \return true if every record was submitted
+    bool LaunchBatch(KernelHandle kernel,
+                     const LaunchRecord* records,
+                     int count,
+                     int stream_type,
+                     int stream_id) {
+        if (kernel_table_.Kernel(kernel) == nullptr) {
+            std::cerr << "Batch launch failed: invalid kernel handle "
+                      << kernel << "." << std::endl;
+            return false;
+        }
+        if (count <= 0) return count == 0;
+        BoundLaunch* batch = BatchBuffer(count);
+        LaunchGraph* capture = Capturing();
 
-        LaunchImpl(func, num_arrays, converted_arrays.data(), stream_type,
-                   stream_id);
+        int failed = 0;
+        int first_failed = -1;
+        const char* reason = nullptr;
+        for (int i = 0; i < count; ++i) {
+            BoundLaunch* launch = &batch[i];
+            const char* error = BindRecord(launch, kernel, records[i],
+                                           stream_type, stream_id);
+            if (error != nullptr) {
+                if (failed++ == 0) {
+                    first_failed = i;
+                    reason = error;
+                }
+                continue;
+            }
+            if (failed != 0 || capture != nullptr) continue;
+            const BoundLaunch* previous = i > 0 ? &batch[i - 1] : nullptr;
+            if (previous != nullptr && previous->packed &&
+                SameLaunchDomain(*previous, *launch)) {
+                for (int d = 0; d < 3; ++d) {
+                    launch->grid[d] = previous->grid[d];
+                    launch->block[d] = previous->block[d];
+                }
+            } else {
+                ConfigureLaunchImpl(launch);
+            }
+            launch->packed = true;
+        }
+        if (failed != 0) {
+            std::cerr << "Batch launch failed (" << GetKernelName(kernel)
+                      << "): " << failed << " of " << count
+                      << " records are invalid, first is record "
+                      << first_failed << ": " << reason << "." << std::endl;
+            return false;
+        }
+
+        if (capture != nullptr) {
+            for (int i = 0; i < count; ++i) { CaptureLaunch(batch[i]); }
+            return true;
+        }
+        bool submitted = SubmitBatchImpl(batch, count);
+        for (int i = 0; i < count; ++i) { MarkSubmitted(batch[i]); }
+        return submitted;
+    }
+
+    /// \brief LaunchBatch by kernel name
+    bool LaunchBatch(const char* func,
+                     const LaunchRecord* records,
+                     int count,
+                     int stream_type,
+                     int stream_id) {
+        KernelHandle kernel = GetKernel(func);
+        if (kernel == kInvalidKernel) {
+            std::cerr << "Batch launch failed (" << func
+                      << "): kernel not found." << std::endl;
+            return false;
+        }
+        return LaunchBatch(kernel, records, count, stream_type, stream_id);
+    }
+
+    /// \brief Selects how launches created from now on map their domain onto
+    /// the grid
+    ///
+    /// \param mode LAUNCH_SHAPED launches one thread per element, LAUNCH_FLAT
+    /// launches a fixed grid that fills the device and lets every thread
+    /// stride over the flattened domain. Warp kernels loop over
+    /// CudaBounds::size either way, so both modes run the same kernels.
+    void SetLaunchMode(LaunchMode mode) { launch_mode_ = mode; }
+
+    /// \brief Changes the launch mode of a launch created with BindLaunch
+    ///
+    /// \param handle Launch returned by BindLaunch
+    /// \param mode LAUNCH_SHAPED or LAUNCH_FLAT
+    void SetLaunchMode(LaunchHook handle, LaunchMode mode) {
+        auto* launch = static_cast<BoundLaunch*>(handle);
+        if (launch->mode == mode) return;
+        launch->mode = mode;
+        // the grid is recomputed by the next submission
+        launch->packed = false;
+    }
+
+    /// \brief Releases a launch created with BindLaunch
+    void ReleaseLaunch(LaunchHook handle) {
+        delete static_cast<BoundLaunch*>(handle);
+    }
+
+    /// \brief Times the candidate block shapes of a bound launch and keeps
+    /// the fastest one
+    ///
+    /// The launch is submitted several times per candidate, so it must be safe
+    /// to repeat, e.g. its outputs are overwritten rather than accumulated.
+    /// The result is stored for the kernel and the size bucket of its arrays
+    /// and persisted next to the kernels, so later runs start tuned.
+    ///
+    /// \param handle Launch returned by BindLaunch
+    /// \param repeats Number of timed submissions per candidate
+    /// \return true if a block shape was chosen
+    bool AutotuneLaunch(LaunchHook handle, int repeats = 10) {
+        auto* launch = static_cast<BoundLaunch*>(handle);
+        if (Capturing() != nullptr) {
+            std::cerr << "Warning: Failed to autotune "
+                      << GetKernelName(launch->kernel_id)
+                      << ", a capture is in progress.\n";
+            return false;
+        }
+        if (!launch->packed || WarpArgsStale(*launch)) {
+            if (!PackWarpArgs(launch)) {
+                std::cerr << "Warning: Failed to autotune "
+                          << GetKernelName(launch->kernel_id)
+                          << ", an argument has no device memory allocated.\n";
+                launch->packed = false;
+                return false;
+            }
+            ConfigureLaunchImpl(launch);
+            launch->packed = true;
+        }
+        bool tuned = AutotuneLaunchImpl(launch, repeats < 1 ? 1 : repeats);
+        MarkSubmitted(*launch);
+        return tuned;
+    }
+
+    /// \brief Starts recording launches and async transfers into a graph
+    ///
+    /// Until EndCapture, every Launch/SubmitLaunch and every *Async transfer
+    /// of the calling thread is recorded on the capture stream instead of
+    /// being executed, whatever stream it names. Blocking transfers are
+    /// rejected while capturing. Other threads keep executing their work, one
+    /// thread at a time can capture.
+    ///
+    /// \param stream_type The type of the stream family, the default stream
+    /// cannot be captured
+    /// \param stream_id The ID of the stream in the family
+    /// \return true if capturing started
+    bool BeginCapture(int stream_type, int stream_id) {
+        std::lock_guard<std::mutex> lock(capture_mutex_);
+        if (capture_graph_.load() != nullptr) {
+            std::cerr << "Warning: Failed to begin capture, a capture is "
+                         "already in progress.\n";
+            return false;
+        }
+        if (stream_type == -1) {
+            std::cerr << "Warning: Failed to begin capture, the default "
+                         "stream cannot be captured.\n";
+            return false;
+        }
+        auto* graph = new LaunchGraph;
+        graph->stream_type = stream_type;
+        graph->stream_id = stream_id;
+        if (!BeginCaptureImpl(graph)) {
+            delete graph;
+            return false;
+        }
+        capture_graph_.store(graph);
+        capture_thread_.store(std::this_thread::get_id());
+        return true;
+    }
+
+    /// \brief Stops recording and turns the recorded sequence into a graph
+    ///
+    /// \return Graph for ReplayGraph, nullptr if nothing usable was captured.
+    /// Must be released with ReleaseGraph.
+    GraphHook EndCapture() {
+        LaunchGraph* graph = Capturing();
+        if (graph == nullptr) {
+            std::cerr << "Warning: Failed to end capture, no capture is in "
+                         "progress on this thread.\n";
+            return nullptr;
+        }
+        {
+            std::lock_guard<std::mutex> lock(capture_mutex_);
+            capture_thread_.store(std::thread::id());
+            capture_graph_.store(nullptr);
+        }
+        if (!EndCaptureImpl(graph) || graph->failed) {
+            std::cerr << "Warning: Capture failed, the graph is discarded.\n";
+            ReleaseGraphImpl(graph);
+            delete graph;
+            return nullptr;
+        }
+        return graph;
+    }
+
+    /// \brief Replays a captured graph on its capture stream
+    ///
+    /// Launch arguments follow the current device memory of the bound arrays,
+    /// so arrays may be reallocated or re-shared between replays. Transfers
+    /// are recorded with fixed addresses and require a new capture instead.
+    ///
+    /// \param handle Graph returned by EndCapture
+    /// \return true if the graph was submitted
+    bool ReplayGraph(GraphHook handle) {
+        auto* graph = static_cast<LaunchGraph*>(handle);
+        for (auto& op : graph->ops) {
+            if (op.kind == GraphOp::KERNEL) {
+                BoundLaunch* launch = op.launch.get();
+                if (!WarpArgsStale(*launch)) continue;
+                if (!PackWarpArgs(launch)) {
+                    std::cerr << "Graph replay failed ("
+                              << GetKernelName(launch->kernel_id)
+                              << "): an argument has no device memory "
+                                 "allocated."
+                              << std::endl;
+                    return false;
+                }
+                ConfigureLaunchImpl(launch);
+                op.dirty = true;
+            } else if (op.array->gpu_data_ == nullptr ||
+                       DeviceDataOf(op.array) != op.device ||
+                       (op.host_data != nullptr &&
+                        op.host_data(op.array) != op.host)) {
+                std::cerr << "Graph replay failed: a captured transfer uses "
+                             "memory that was released, capture again."
+                          << std::endl;
+                return false;
+            }
+        }
+        if (!ReplayGraphImpl(graph)) return false;
+
+        for (auto& op : graph->ops) {
+            op.dirty = false;
+            if (op.kind == GraphOp::KERNEL) {
+                MarkSubmitted(*op.launch);
+                continue;
+            }
+            NoteStreamUse(op.array, graph->stream_type, graph->stream_id);
+            if (op.valid_after != -1) {
+                SetValidity(op.array,
+                            static_cast<unsigned char>(op.valid_after));
+            }
+        }
+        return true;
+    }
+
+    /// \brief Releases a graph returned by EndCapture
+    void ReleaseGraph(GraphHook handle) {
+        auto* graph = static_cast<LaunchGraph*>(handle);
+        if (graph == nullptr) return;
+        ReleaseGraphImpl(graph);
+        delete graph;
     }
 
     /// \brief Creates a stream in a specific stream family
@@ -392,29 +1525,572 @@ public:
 
     /// \brief Deletes a stream from a specific stream family
     ///
+    /// Calls racing with the deletion either finish enqueueing on the stream
+    /// before it is destroyed, or find it gone and use the default stream.
+    ///
     /// \param stream_type The type/category of the stream family
     /// \param stream_id The ID of the stream to delete
     virtual void DeleteStreamFromFamily(int stream_type, int stream_id) = 0;
 
+    /// \brief Creates the stream pool of a family
+    ///
+    /// The pool streams take the IDs 0 .. num_streams - 1 and live as long as
+    /// the manager. Streams created later in the family get the priority and
+    /// flags of the pool as well.
+    ///
+    /// \param stream_type The type/category of the stream family, which must
+    /// not have streams yet
+    /// \param config Size, priority and blocking behaviour of the streams
+    /// \return true if the pool was created
+    virtual bool ConfigureStreamPool(int stream_type,
+                                     const StreamPoolConfig& config) = 0;
+
+    /// \brief Picks a stream of a family's pool for independent work
+    ///
+    /// Idle streams are preferred, otherwise the pool is used round-robin.
+    /// Work that depends on earlier work has to stay on its stream or wait
+    /// for it with Signal/Wait.
+    ///
+    /// \param stream_type The type/category of the stream family
+    /// \return The ID of a pool stream, -1 if the family has no pool
+    virtual int AcquireStream(int stream_type) = 0;
+
+    /// \brief Page-locks a caller owned host buffer, e.g. one that receives
+    /// GetArrayDataDevice every frame, so copies to and from it skip staging
+    ///
+    /// \param ptr Start of the buffer
+    /// \param size Size of the buffer in bytes
+    /// \return true if the buffer is registered
+    virtual bool RegisterHostMemory(void* ptr, size_t size) = 0;
+
+    /// \brief Undoes RegisterHostMemory
+    ///
+    /// \param ptr Start of the buffer passed to RegisterHostMemory
+    virtual void UnregisterHostMemory(void* ptr) = 0;
+
+    /// \brief Returns cached device memory that is not in use to the driver
+    ///
+    /// \return Number of bytes released
+    virtual size_t TrimDeviceMemory() = 0;
+
+    /// \brief Statistics of the device memory pool
+    virtual MemoryPoolStats GetDeviceMemoryStats() const = 0;
+
+    /// \brief Host memory for temporaries of the current frame, aligned to
+    /// 64 bytes
+    ///
+    /// \param size Number of bytes
+    /// \return Memory valid until the next ResetScratch, nullptr on failure
+    void* AllocateScratch(size_t size) {
+        return host_arena_.AllocateScratch(size);
+    }
+
+    /// \brief Hands all scratch memory out again, in O(1)
+    void ResetScratch() { host_arena_.ResetScratch(); }
+
+    /// \brief Returns cached pageable host memory that no array uses, and
+    /// unused scratch memory, to the system
+    ///
+    /// \return Number of bytes released
+    size_t TrimHostMemory() { return host_arena_.Trim(); }
+
+    /// \brief Statistics of the host arena behind pageable host storage
+    HostArenaStats GetHostArenaStats() const {
+        return host_arena_.GetStats();
+    }
+
     virtual CUdevice* GetCudaDevice()  = 0;
     virtual CUcontext* GetCudaContext()  = 0;
     virtual ICudaFunctionManager* GetCuda() const = 0;
     virtual void UnInit() = 0;
 
 protected:
+    // pinned: requested on input, what was actually allocated on output
+    virtual void* AllocateHostMemoryImpl(size_t size, bool& pinned) = 0;
+    virtual void ReleaseHostMemoryImpl(void* ptr, bool pinned) = 0;
     virtual void ReleaseArrayDataDeviceImpl(SharedDataGPU* gpuData) = 0;
+    // waits for the work on device memory that blocking copies, which run on
+    // the legacy default stream, are not ordered after
+    virtual void WaitStreamUseImpl(const SharedDataGPU* gpuData) = 0;
     virtual void AllocateDeviceMemoryImpl(CUdeviceptr* arr, size_t size) = 0;
     virtual void SyncToHostImpl(CUdeviceptr src, void* dst, size_t size) = 0;
     virtual void SyncToDeviceImpl(void* src, CUdeviceptr dst, size_t size) = 0;
+    // false if the copy could not be enqueued, event is left nullptr when
+    // there is nothing to wait for
+    virtual bool SyncToHostAsyncImpl(CUdeviceptr src,
+                                     void* dst,
+                                     size_t size,
+                                     int stream_type,
+                                     int stream_id,
+                                     EventHandle* event) = 0;
+    virtual bool SyncToDeviceAsyncImpl(const void* src,
+                                       CUdeviceptr dst,
+                                       size_t size,
+                                       int stream_type,
+                                       int stream_id,
+                                       EventHandle* event) = 0;
+    // blocking copies of height rows of width bytes, the rows src_pitch and
+    // dst_pitch bytes apart; used for non-contiguous views
+    virtual void Copy2DToHostImpl(CUdeviceptr src,
+                                  size_t src_pitch,
+                                  void* dst,
+                                  size_t dst_pitch,
+                                  size_t width,
+                                  size_t height) = 0;
+    virtual void Copy2DToDeviceImpl(const void* src,
+                                    size_t src_pitch,
+                                    CUdeviceptr dst,
+                                    size_t dst_pitch,
+                                    size_t width,
+                                    size_t height) = 0;
+
+    // pipeline: GetKernel->FindKernelImpl (once per name), then
+    // Launch/BindLaunch->SubmitLaunch->ConfigureLaunchImpl (after repacking)
+    // ->SubmitLaunchImpl.
+    // Arrays are passed as HyperArrayBase, each carries its own dtype.
+
+    // the backend's kernel of that name, nullptr if there is none
+    virtual void* FindKernelImpl(const char* name) = 0;
+    // prepares the kernels named by Preload before they are looked up
+    virtual void PreloadImpl(const char* const* funcs, int count) = 0;
+    // computes the launch dimensions from freshly packed arguments
+    virtual void ConfigureLaunchImpl(BoundLaunch* launch) = 0;
+    virtual void SubmitLaunchImpl(BoundLaunch* launch) = 0;
+    // submits packed launches of one kernel and stream in order, reporting
+    // failures once for the whole batch
+    virtual bool SubmitBatchImpl(BoundLaunch* launches, int count) = 0;
+    // picks and records the fastest launch dimensions of a packed launch
+    virtual bool AutotuneLaunchImpl(BoundLaunch* launch, int repeats) = 0;
+
+    // capture: BeginCapture->BeginCaptureImpl, every recorded op is handed to
+    // CaptureOpImpl, EndCapture->EndCaptureImpl builds the backend graph.
+    // Kernel ops arrive packed and with their stream set to the capture
+    // stream. ReplayGraphImpl must push the parameters of dirty kernel ops.
+    virtual bool BeginCaptureImpl(LaunchGraph* graph) = 0;
+    virtual bool CaptureOpImpl(LaunchGraph* graph, GraphOp* op) = 0;
+    virtual bool EndCaptureImpl(LaunchGraph* graph) = 0;
+    virtual bool ReplayGraphImpl(LaunchGraph* graph) = 0;
+    virtual void ReleaseGraphImpl(LaunchGraph* graph) = 0;
+
+    // the host copy of every array a launch writes becomes stale, and the
+    // device memory of all its arrays is in use on the launch stream
+    void MarkSubmitted(const BoundLaunch& launch) {
+        for (int i = 0; i < launch.num_arrays; ++i) {
+            NoteStreamUse(launch.arrays[i], launch.stream_type,
+                          launch.stream_id);
+            if (i < 32 && (launch.write_mask & (1u << i))) {
+                SetValidity(launch.arrays[i], ARRAY_DEVICE_VALID);
+            }
+        }
+    }
+
+    // blocking transfers would run during capture instead of being recorded
+    bool RejectWhileCapturing(const char* call) const {
+        if (Capturing() == nullptr) return false;
+        std::cerr << "Warning: " << call
+                  << " is not allowed while capturing, use the Async variant "
+                     "on the capture stream.\n";
+        return true;
+    }
+
+    // strided transfers are blocking 2D copies, they cannot be recorded
+    bool RejectStridedCapture(const char* call) {
+        LaunchGraph* capture = Capturing();
+        if (capture == nullptr) return false;
+        std::cerr << "Warning: " << call
+                  << " of a non-contiguous view cannot be captured.\n";
+        capture->failed = true;
+        return true;
+    }
+
+    // header of a view sharing the storage of src, its layout is that of src
+    // until the caller changes it
+    template <typename T>
+    HyperArray<T>* NewView(HyperArray<T>* src) {
+        auto* view = SlabNew<HyperArray<T>>(*src);
+        view->root_ = src->root_ != nullptr ? src->root_ : src;
+        view->root_->refs_ += 1;
+        view->valid_ = ARRAY_INVALID;
+        if (view->gpu_data_ != nullptr) view->gpu_data_->semaphore_ += 1;
+        if (view->cpu_data_ != nullptr) view->cpu_data_->semaphore_ += 1;
+        return view;
+    }
+
+    // Copies the elements of an array from host memory to its device storage.
+    // The host memory is either laid out like the array (its own host
+    // storage) or packed (a caller buffer); both are the same for contiguous
+    // arrays, which take a single copy.
+    void CopyToDevice(const HyperArrayBase* array,
+                      size_t element_size,
+                      void* host,
+                      bool packed) {
+        WaitStreamUseImpl(array->gpu_data_);
+        if (IsContiguous(array, element_size)) {
+            SyncToDeviceImpl(host, DeviceDataOf(array),
+                             element_size * array->size_);
+            return;
+        }
+        auto* src = static_cast<const char*>(host);
+        CUdeviceptr dst = DeviceDataOf(array);
+        ForEachCopyBlock(array, element_size,
+                         [&](size_t offset, size_t packed_offset, size_t width,
+                             size_t height, size_t pitch) {
+                             if (packed) {
+                                 Copy2DToDeviceImpl(src + packed_offset, width,
+                                                    dst + offset, pitch, width,
+                                                    height);
+                             } else {
+                                 Copy2DToDeviceImpl(src + offset, pitch,
+                                                    dst + offset, pitch, width,
+                                                    height);
+                             }
+                         });
+    }
+
+    // the other direction of CopyToDevice
+    void CopyToHost(const HyperArrayBase* array,
+                    size_t element_size,
+                    void* host,
+                    bool packed) {
+        WaitStreamUseImpl(array->gpu_data_);
+        if (IsContiguous(array, element_size)) {
+            SyncToHostImpl(DeviceDataOf(array), host,
+                           element_size * array->size_);
+            return;
+        }
+        auto* dst = static_cast<char*>(host);
+        CUdeviceptr src = DeviceDataOf(array);
+        ForEachCopyBlock(array, element_size,
+                         [&](size_t offset, size_t packed_offset, size_t width,
+                             size_t height, size_t pitch) {
+                             if (packed) {
+                                 Copy2DToHostImpl(src + offset, pitch,
+                                                  dst + packed_offset, width,
+                                                  width, height);
+                             } else {
+                                 Copy2DToHostImpl(src + offset, pitch,
+                                                  dst + offset, pitch, width,
+                                                  height);
+                             }
+                         });
+    }
+
+    // copies the host storage of an array into a packed buffer and back
+    template <typename T>
+    static void PackHost(HyperArray<T>* array, T* data) {
+        CopyHostBlocks(array, reinterpret_cast<char*>(HostPtrOf(array)),
+                       reinterpret_cast<char*>(data), true);
+    }
+    template <typename T>
+    static void UnpackHost(HyperArray<T>* array, const T* data) {
+        CopyHostBlocks(array, reinterpret_cast<char*>(HostPtrOf(array)),
+                       reinterpret_cast<char*>(const_cast<T*>(data)), false);
+    }
+    template <typename T>
+    static void CopyHostBlocks(HyperArray<T>* array,
+                               char* storage,
+                               char* packed,
+                               bool pack) {
+        ForEachCopyBlock(array, sizeof(T),
+                         [&](size_t offset, size_t packed_offset, size_t width,
+                             size_t height, size_t pitch) {
+                             for (size_t row = 0; row < height; ++row) {
+                                 char* strided = storage + offset + row * pitch;
+                                 char* dense = packed + packed_offset +
+                                               row * width;
+                                 if (pack) {
+                                     std::memcpy(dense, strided, width);
+                                 } else {
+                                     std::memcpy(strided, dense, width);
+                                 }
+                             }
+                         });
+    }
+
+    void CaptureLaunch(const BoundLaunch& launch) {
+        LaunchGraph* capture = Capturing();
+        GraphOp op;
+        op.kind = GraphOp::KERNEL;
+        op.launch.reset(new BoundLaunch);
+        BoundLaunch* copy = op.launch.get();
+        copy->kernel = launch.kernel;
+        copy->kernel_id = launch.kernel_id;
+        copy->num_arrays = launch.num_arrays;
+        for (int i = 0; i < launch.num_arrays; ++i) {
+            copy->arrays[i] = launch.arrays[i];
+        }
+        copy->stream_type = capture->stream_type;
+        copy->stream_id = capture->stream_id;
+        copy->write_mask = launch.write_mask;
+        copy->mode = launch.mode;
+        if (!PackWarpArgs(copy)) {
+            std::cerr << "Kernel capture failed ("
+                      << GetKernelName(launch.kernel_id)
+                      << "): an argument has no device memory allocated."
+                      << std::endl;
+            capture->failed = true;
+            return;
+        }
+        ConfigureLaunchImpl(copy);
+        copy->packed = true;
+        if (!CaptureOpImpl(capture, &op)) capture->failed = true;
+        capture->ops.push_back(std::move(op));
+    }
+
+    template <typename T>
+    void CaptureCopy(GraphOp::Kind kind,
+                     HyperArray<T>* array,
+                     bool array_host,
+                     void* host,
+                     size_t size,
+                     int valid_after) {
+        LaunchGraph* capture = Capturing();
+        GraphOp op;
+        op.kind = kind;
+        op.array = array;
+        op.host_data = array_host ? &HostDataOf<T> : nullptr;
+        op.host = host;
+        op.device = DeviceDataOf(array);
+        op.size = size;
+        op.valid_after = valid_after;
+        if (!CaptureOpImpl(capture, &op)) capture->failed = true;
+        capture->ops.push_back(std::move(op));
+    }
+
+    bool BindKernel(BoundLaunch* launch,
+                    KernelHandle kernel,
+                    int num_arrays,
+                    HyperArrayHook* arrays,
+                    int stream_type,
+                    int stream_id,
+                    uint32_t write_mask) {
+        void* function = kernel_table_.Kernel(kernel);
+        if (function == nullptr) {
+            std::cerr << "Kernel launch failed: invalid kernel handle "
+                      << kernel << "." << std::endl;
+            return false;
+        }
+        if (num_arrays < 1 || num_arrays > kMaxLaunchArrays) {
+            std::cerr << "Kernel launch failed (" << GetKernelName(kernel)
+                      << "): "
+                      << num_arrays << " arguments, at most "
+                      << kMaxLaunchArrays << " are supported." << std::endl;
+            return false;
+        }
+        launch->kernel_id = kernel;
+        launch->kernel = function;
+        launch->num_arrays = num_arrays;
+        for (int i = 0; i < num_arrays; ++i) {
+            launch->arrays[i] = ToArrayBase(arrays[i]);
+            if (launch->arrays[i]->dtype_ == DTYPE_UNKNOWN) {
+                std::cerr << "Kernel launch failed (" << GetKernelName(kernel)
+                          << "): argument " << i
+                          << " has no supported element type." << std::endl;
+                return false;
+            }
+        }
+        launch->stream_type = stream_type;
+        launch->stream_id = stream_id;
+        launch->write_mask = write_mask;
+        launch->mode = launch_mode_;
+        return true;
+    }
+
+    // binds and packs one record of a batch without printing, returns why it
+    // is invalid or nullptr
+    const char* BindRecord(BoundLaunch* launch,
+                           KernelHandle kernel,
+                           const LaunchRecord& record,
+                           int stream_type,
+                           int stream_id) {
+        launch->packed = false;
+        if (record.num_arrays < 1 || record.num_arrays > kMaxLaunchArrays) {
+            return "unsupported number of arguments";
+        }
+        if (record.arrays == nullptr) return "no arguments";
+        launch->kernel_id = kernel;
+        launch->kernel = kernel_table_.Kernel(kernel);
+        launch->num_arrays = record.num_arrays;
+        for (int i = 0; i < record.num_arrays; ++i) {
+            if (record.arrays[i] == nullptr) return "null argument";
+            launch->arrays[i] = ToArrayBase(record.arrays[i]);
+            if (launch->arrays[i]->dtype_ == DTYPE_UNKNOWN) {
+                return "an argument has no supported element type";
+            }
+        }
+        launch->stream_type = stream_type;
+        launch->stream_id = stream_id;
+        launch->write_mask = record.write_mask;
+        launch->mode = launch_mode_;
+        if (!PackWarpArgs(launch)) {
+            return "an argument has no device memory allocated";
+        }
+        return nullptr;
+    }
+
+    // true if the device copy is current, counts the copy that was saved
+    bool SkipSyncToDevice(unsigned char valid, size_t bytes) {
+        if (valid & ARRAY_DEVICE_VALID) {
+            transfer_stats_.bytes_skipped_to_device += bytes;
+            transfer_stats_.syncs_skipped += 1;
+            return true;
+        }
+        transfer_stats_.bytes_to_device += bytes;
+        return false;
+    }
+
+    // true if the host copy is current, counts the copy that was saved
+    bool SkipSyncToHost(unsigned char valid, size_t bytes) {
+        if (valid & ARRAY_HOST_VALID) {
+            transfer_stats_.bytes_skipped_to_host += bytes;
+            transfer_stats_.syncs_skipped += 1;
+            return true;
+        }
+        transfer_stats_.bytes_to_host += bytes;
+        return false;
+    }
+
+    // blocks until the last *Async copy of the storage of an array has
+    // finished, so that its validity bits and host storage can be trusted
+    void FinishPendingCopy(HyperArrayBase* array) {
+        AtomicSignal& pending = PendingCopyOf(array);
+        SignalToken token = pending.load();
+        if (token == kNoSignal) return;
+        WaitSignal(token);
+        // a newer copy may have replaced the token meanwhile, keep that one
+        pending.compare_exchange_strong(token, kNoSignal);
+    }
+
+    // makes an *Async copy about to be enqueued on a stream start after the
+    // pending one, which may run on another stream
+    void OrderAfterPendingCopy(HyperArrayBase* array,
+                               int stream_type,
+                               int stream_id) {
+        SignalToken token = PendingCopyOf(array).load();
+        if (token == kNoSignal || QuerySignal(token)) return;
+        Wait(stream_type, stream_id, token);
+    }
+
+    // records the *Async copy just enqueued on a stream as the pending copy
+    // of the storage; the copy waited for the previous one, so waiting for
+    // the new token covers both. A copy without event has already finished,
+    // one that cannot be signalled is finished here.
+    void SetPendingCopy(HyperArrayBase* array,
+                        int stream_type,
+                        int stream_id,
+                        EventHandle event) {
+        SignalToken token = kNoSignal;
+        if (event != nullptr) {
+            token = Signal(stream_type, stream_id);
+            if (token == kNoSignal) WaitEvent(event);
+        }
+        PendingCopyOf(array) = token;
+    }
+
+    // the graph the calling thread records into, nullptr when it is not
+    // capturing; only the thread that called BeginCapture sees its graph
+    LaunchGraph* Capturing() const {
+        // no other thread stores our id, a relaxed load suffices
+        if (capture_thread_.load(std::memory_order_relaxed) !=
+            std::this_thread::get_id()) {
+            return nullptr;
+        }
+        return capture_graph_.load(std::memory_order_relaxed);
+    }
+
+    // packed launches of the calling thread's LaunchBatch, grown to its
+    // largest batch, so concurrent batches never share a buffer
+    static BoundLaunch* BatchBuffer(int count) {
+        thread_local std::unique_ptr<BoundLaunch[]> buffer;
+        thread_local int capacity = 0;
+        if (capacity < count) {
+            buffer.reset(new BoundLaunch[count]);
+            capacity = count;
+        }
+        return buffer.get();
+    }
+
+    std::atomic<bool> pinned_host_memory_{false};
+    std::atomic<LaunchMode> launch_mode_{LAUNCH_SHAPED};
+    // TransferStats as counted by syncs on any thread
+    struct AtomicTransferStats {
+        std::atomic<size_t> bytes_to_device{0};
+        std::atomic<size_t> bytes_to_host{0};
+        std::atomic<size_t> bytes_skipped_to_device{0};
+        std::atomic<size_t> bytes_skipped_to_host{0};
+        std::atomic<size_t> syncs_skipped{0};
+    };
+    AtomicTransferStats transfer_stats_;
+
+    // graph being recorded and the thread recording it
+    std::atomic<LaunchGraph*> capture_graph_{nullptr};
+    std::atomic<std::thread::id> capture_thread_{};
+    std::mutex capture_mutex_;
+
+    // KernelHandle -> backend kernel and name, read without locking
+    KernelTable kernel_table_;
+
+    // pageable host storage of arrays and scratch memory; the CPU backend
+    // keeps its device storage here as well
+    HostArena host_arena_;
+};
+
+/// \brief Owning, reference counted handle of a HyperArray or view.
+///
+/// Copies share the array through the intrusive count of its header, nothing
+/// is copied; moves transfer the reference. The last reference releases the
+/// array with ICudaManager::ReleaseArray. Get() yields the plain handle for
+/// the rest of the API, it stays valid as long as a reference exists.
+template <typename T>
+class HyperArrayRef {
+public:
+    HyperArrayRef() = default;
+
+    /// \brief Takes over the reference held by a handle from CreateArray or
+    /// a view creator
+    HyperArrayRef(ICudaManager* manager, HyperArrayHook arr)
+        : manager_(manager), array_(static_cast<HyperArray<T>*>(arr)) {}
+
+    HyperArrayRef(const HyperArrayRef& other)
+        : manager_(other.manager_), array_(other.array_) {
+        if (array_ != nullptr) array_->refs_ += 1;
+    }
+
+    HyperArrayRef(HyperArrayRef&& other) noexcept
+        : manager_(other.manager_), array_(other.array_) {
+        other.array_ = nullptr;
+    }
+
+    HyperArrayRef& operator=(HyperArrayRef other) noexcept {
+        std::swap(manager_, other.manager_);
+        std::swap(array_, other.array_);
+        return *this;
+    }
+
+    ~HyperArrayRef() { Reset(); }
+
+    /// \brief Drops the reference, the array is released with the last one
+    void Reset() {
+        if (array_ != nullptr) manager_->ReleaseArray<T>(array_);
+        array_ = nullptr;
+    }
+
+    /// \brief Gives up the reference without dropping it
+    ///
+    /// \return Handle to be released with ReleaseArray
+    HyperArrayHook Release() {
+        HyperArrayHook arr = array_;
+        array_ = nullptr;
+        return arr;
+    }
+
+    HyperArrayHook Get() const { return array_; }
+    HyperArray<T>* operator->() const { return array_; }
+    explicit operator bool() const { return array_ != nullptr; }
 
-    // virtual function do not support template, so we need to use
-    // non-template function to call the template function.
-    // pipeline: Launch->LaunchImpl->LaunchImplT
-    virtual void LaunchImpl(const char* func,
-                            int num_arrays,
-                            HyperArray<float>** arrays,
-                            int stream_type,
-                            int stream_id) = 0;
+private:
+    ICudaManager* manager_ = nullptr;
+    HyperArray<T>* array_ = nullptr;
 };
 
 }  // namespace cudamgr
@@ -3,199 +3,299 @@
 //
 // All rights reserved.
 // ----------------------------------------------------------------------------
-#include <native/builtin.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string_view>
+#include <unordered_map>
 
 #include "DFCudaMgr.h"
+#include "DFEmbeddedKernels.h"
+#include "DFKernelIndex.h"
+#include "DFLaunchConfig.h"
+#include "DFMemoryPool.h"
+#include "DFModuleCache.h"
+#include "DFStagingRing.h"
+#include "DFThreadPool.h"
+#include "DFWarpArgs.h"
 
 namespace dexsim {
 namespace cudamgr {
 
-struct CudaBounds {
-    int shape[4];
-    int ndim;
-    size_t size;
-};
-
-struct CudaThread {
-    int numBlocks[3];
-    int numThreadsPerBlock[3];
-};
-
 class CudaManager : public ICudaManager {
 public:
     CudaManager();
 
+    /// \brief Creates the manager on top of a given driver implementation
+    ///
+    /// \param cuda Driver entry points, nullptr loads the CUDA driver library.
+    /// Passing a HostFunctionManager runs the manager without a GPU.
+    explicit CudaManager(ICudaFunctionManager* cuda);
+
     int CreateStreamInFamily(int stream_type) override;
     void DeleteStreamFromFamily(int stream_type, int stream_id) override;
+    bool ConfigureStreamPool(int stream_type,
+                             const StreamPoolConfig& config) override;
+    int AcquireStream(int stream_type) override;
     void AllocateDeviceMemoryImpl(CUdeviceptr* arr, size_t size) override;
     void SyncToHostImpl(CUdeviceptr src, void* dst, size_t size) override;
     void SyncToDeviceImpl(void* src, CUdeviceptr dst, size_t size) override;
 
+    void WaitEvent(EventHandle event) override;
+    void StreamWaitEvent(int stream_type,
+                         int stream_id,
+                         EventHandle event) override;
+    bool QueryEvent(EventHandle event) override;
+    void ReleaseEvent(EventHandle event) override;
+    SignalToken Signal(int stream_type, int stream_id) override;
+    void Wait(int stream_type, int stream_id, SignalToken token) override;
+    bool QuerySignal(SignalToken token) override;
+    void WaitSignal(SignalToken token) override;
+
+    bool RegisterHostMemory(void* ptr, size_t size) override;
+    void UnregisterHostMemory(void* ptr) override;
+
+    size_t TrimDeviceMemory() override;
+    MemoryPoolStats GetDeviceMemoryStats() const override;
+
     CUdevice* GetCudaDevice()  override;
     CUcontext* GetCudaContext()  override;
     ICudaFunctionManager* GetCuda() const override;
     void UnInit() override;
 
+    /// \brief Whether the driver, device and context were set up successfully
+    bool IsInitialized() const { return initialized_; }
+
+    /// \brief Hits and misses of the compiled module cache
+    ModuleCacheStats GetModuleCacheStats() const;
+
 private:
     void InitCUDA();
+    // makes the context of the manager current on the calling thread, once
+    // per thread; every entry point that calls the driver starts with it
+    void MakeContextCurrent();
 
     void ProcessFile(const std::filesystem::path& filePath);
-    void LoadPTXFile(const std::string& type);
+    // loads a module on first use, nullptr if it cannot be loaded
+    CUmodule LoadPTXFile(const std::string& type);
+    // loads the module of a type from the kernel directory or, failing that,
+    // from the embedded kernels; only reads shared state, safe from any thread
+    CUmodule LoadModule(const std::string& type);
+    CUmodule LoadModuleImage(const std::string& type,
+                             std::string_view image,
+                             bool cubin);
+    // where a kernel lives, taken from the prebuilt index on first use;
+    // nullptr if the name is unknown. Requires module_mutex_.
+    struct KernelEntry;
+    KernelEntry* FindKernelEntry(const char* name);
+    // the function behind a kernel name, loading its module if needed
+    CUfunction ResolveKernel(const char* name);
 
-    std::vector<CUstream>* GetStreamFamily(int stream_type);
-    CUstream GetStream(int stream_type, int stream_id);
+    // streams of a family live in slots that never move, the id of a stream
+    // is its slot, so lookups read them without locking. Creating and
+    // deleting streams takes stream_mutex_.
+    struct StreamSlot {
+        std::atomic<CUstream> stream{nullptr};
+        // calls holding the stream through a StreamRef, a deleted stream is
+        // only destroyed once the count is back to zero
+        std::atomic<int> users{0};
+        // the deleted stream is still waited for, the slot is not reused
+        // meanwhile. Requires stream_mutex_.
+        bool deleting = false;
+    };
+    struct StreamFamily {
+        // slots are allocated in chunks as the family grows, chunk k holds
+        // kFirstChunk << k of them and is published before size covers it
+        static constexpr int kFirstChunk = 8;
+        static constexpr int kMaxChunks = 24;
+        std::atomic<StreamSlot*> chunks[kMaxChunks] = {};
+        std::atomic<int> size{0};
+        // the first pool_size slots are the pool, they are never deleted
+        std::atomic<int> pool_size{0};
+        std::atomic<unsigned int> next_pool_stream{0};
+        // used for every stream of the family, set by ConfigureStreamPool
+        unsigned int flags = CU_STREAM_DEFAULT;
+        int priority = 0;
 
-    void ReleaseArrayDataDeviceImpl(SharedDataGPU* gpuData) override;
+        StreamFamily() = default;
+        StreamFamily(const StreamFamily&) = delete;
+        StreamFamily& operator=(const StreamFamily&) = delete;
+        ~StreamFamily();
 
-    void LaunchImpl(const char* func,
-                    int num_arrays,
-                    HyperArray<float>** arrays,
-                    int stream_type,
-                    int stream_id) override;
-
-    // Generates warp arguments for Warp kernel launch automatically
-    template <typename T>
-    void** GetWarpArgs(int num_arrays,
-                       int ndim,
-                       ArrayShape shape,
-                       size_t strides[4],
-                       const std::vector<CUdeviceptr>& gpu_data) {
-        CudaBounds* bounds = new CudaBounds;
-        std::vector<wp::array_t<T>>* arrays =
-                new std::vector<wp::array_t<T>>(num_arrays);
-        void** args = new void*[num_arrays + 1];  // bounds + arrays
-
-        bounds->ndim = ndim;
-        bounds->size = 1;
-        for (int i = 0; i < ndim; ++i) {
-            bounds->shape[i] = shape[i];
-            bounds->size *= shape[i];
-        }
+        // slot of a stream id, nullptr if its chunk has not been allocated
+        StreamSlot* Slot(int id) const;
+        // slot of a stream id, allocating its chunk if needed; nullptr past
+        // the last chunk. Requires stream_mutex_.
+        StreamSlot* GrowTo(int id);
+    };
+    StreamFamily* GetStreamFamily(int stream_type);
 
-        for (int arr_idx = 0; arr_idx < num_arrays; ++arr_idx) {
-            for (int dim = 0; dim < ndim; ++dim) {
-                (*arrays)[arr_idx].shape[dim] = shape[dim];
-                (*arrays)[arr_idx].strides[dim] = strides[dim];
+    // A stream held for the duration of one call, so that
+    // DeleteStreamFromFamily cannot destroy it while work is enqueued on it.
+    // Converts to nullptr, the legacy default stream, if there is no stream.
+    class StreamRef {
+    public:
+        StreamRef() = default;
+        StreamRef(std::atomic<int>* users, CUstream stream)
+            : users_(users), stream_(stream) {}
+        StreamRef(const StreamRef&) = delete;
+        StreamRef& operator=(const StreamRef&) = delete;
+        ~StreamRef() {
+            if (users_ != nullptr) {
+                users_->fetch_sub(1, std::memory_order_release);
             }
-            (*arrays)[arr_idx].data = reinterpret_cast<T*>(gpu_data[arr_idx]);
         }
 
-        args[0] = bounds;
-        for (int i = 0; i < num_arrays; ++i) { args[i + 1] = &(*arrays)[i]; }
-
-        return args;
-    }
-
-    CudaThread GetCudaThread(int dim, ArrayShape shape) {
-        CudaThread thread;
-        if (dim == 1) {
-            thread.numThreadsPerBlock[0] = shape[0] < 256 ? shape[0] : 256;
-            thread.numThreadsPerBlock[1] = 1;
-            thread.numThreadsPerBlock[2] = 1;
-            thread.numBlocks[0] =
-                    (shape[0] + thread.numThreadsPerBlock[0] - 1) /
-                    thread.numThreadsPerBlock[0];
-            thread.numBlocks[1] = 1;
-            thread.numBlocks[2] = 1;
-        } else if (dim == 2) {
-            thread.numThreadsPerBlock[0] = shape[0] < 16 ? shape[0] : 16;
-            thread.numThreadsPerBlock[1] = shape[1] < 16 ? shape[1] : 16;
-            thread.numThreadsPerBlock[2] = 1;
-            thread.numBlocks[0] =
-                    (shape[0] + thread.numThreadsPerBlock[0] - 1) /
-                    thread.numThreadsPerBlock[0];
-            thread.numBlocks[1] =
-                    (shape[1] + thread.numThreadsPerBlock[1] - 1) /
-                    thread.numThreadsPerBlock[1];
-            thread.numBlocks[2] = 1;
-        } else {
-            thread.numThreadsPerBlock[0] = shape[0] < 8 ? shape[0] : 8;
-            thread.numThreadsPerBlock[1] = shape[1] < 8 ? shape[1] : 8;
-            thread.numThreadsPerBlock[2] = shape[2] < 8 ? shape[2] : 8;
-            thread.numBlocks[0] =
-                    (shape[0] + thread.numThreadsPerBlock[0] - 1) /
-                    thread.numThreadsPerBlock[0];
-            thread.numBlocks[1] =
-                    (shape[1] + thread.numThreadsPerBlock[1] - 1) /
-                    thread.numThreadsPerBlock[1];
-            thread.numBlocks[2] =
-                    (shape[2] + thread.numThreadsPerBlock[2] - 1) /
-                    thread.numThreadsPerBlock[2];
-        }
-        return thread;
-    }
-
-    template <typename T>
-    void LaunchImplT(const char* kernel_name,
-                     int num_arrays,
-                     HyperArray<T>** arrays,
-                     int stream_type,
-                     int stream_id) {
-        int threadNum = 1;
-        ArrayShape threadShape;
-        std::vector<CUdeviceptr> gpu_data(num_arrays);
-
-        for (int i = 0; i < 4; ++i) { threadShape[i] = 1; }
-        for (int i = 0; i < num_arrays; ++i) {
-            gpu_data[i] = arrays[i]->gpu_data_->value_;
-            threadNum =
-                    arrays[i]->ndim_ > threadNum ? arrays[i]->ndim_ : threadNum;
-            auto currentShape = arrays[i]->shape_;
-            for (int j = 0; j < arrays[i]->ndim_; ++j) {
-                threadShape[j] = currentShape[j] > threadShape[j]
-                                         ? currentShape[j]
-                                         : threadShape[j];
-            }
-        }
+        operator CUstream() const { return stream_; }
 
-        auto warpArgs =
-                GetWarpArgs<T>(num_arrays, arrays[0]->ndim_, arrays[0]->shape_,
-                               arrays[0]->strides_, gpu_data);
-        auto thread = GetCudaThread(threadNum, threadShape);
-        CUstream stream =
-                stream_type == -1 ? nullptr : GetStream(stream_type, stream_id);
-        // 4. Launch the kernel
-        auto res = cuda_->cuLaunchKernel(
-                functions_[kernel_name], thread.numBlocks[0],
-                thread.numBlocks[1], thread.numBlocks[2],  // grid dim
-                thread.numThreadsPerBlock[0], thread.numThreadsPerBlock[1],
-                thread.numThreadsPerBlock[2],  // block dim
-                0,                             // shared mem
-                stream,                        // stream
-                warpArgs,                      // kernel args
-                nullptr);
-
-        // 5. Release resources
-        ReleaseWarpArgs(warpArgs);
-
-        // 6. Error checking
-        if (res != CUDA_SUCCESS) {
-            const char* errorStr;
-            cuda_->cuGetErrorString(res, &errorStr);
-            std::cerr << "Kernel launch failed (" << kernel_name
-                      << "): " << errorStr << std::endl;
-        }
-    }
+    private:
+        std::atomic<int>* users_ = nullptr;
+        CUstream stream_ = nullptr;
+    };
+    // stream_type -1 is the default stream
+    StreamRef GetStream(int stream_type, int stream_id);
+    // creates a stream in the first free slot, -1 on failure. Requires
+    // stream_mutex_.
+    int CreateStreamLocked(StreamFamily* family, int stream_type);
+
+    void ReleaseArrayDataDeviceImpl(SharedDataGPU* gpuData) override;
+    void WaitStreamUseImpl(const SharedDataGPU* gpuData) override;
+    // the non-blocking stream device memory was used on, whose work the
+    // legacy default stream does not wait for. Memory used on several
+    // streams waits for all non-blocking streams here instead.
+    StreamRef NonBlockingStreamOf(const SharedDataGPU* gpuData);
+    void SynchronizeNonBlockingStreams();
+    void* AllocateHostMemoryImpl(size_t size, bool& pinned) override;
+    void ReleaseHostMemoryImpl(void* ptr, bool pinned) override;
+
+    bool SyncToHostAsyncImpl(CUdeviceptr src,
+                             void* dst,
+                             size_t size,
+                             int stream_type,
+                             int stream_id,
+                             EventHandle* event) override;
+    bool SyncToDeviceAsyncImpl(const void* src,
+                               CUdeviceptr dst,
+                               size_t size,
+                               int stream_type,
+                               int stream_id,
+                               EventHandle* event) override;
+    void Copy2DToHostImpl(CUdeviceptr src,
+                          size_t src_pitch,
+                          void* dst,
+                          size_t dst_pitch,
+                          size_t width,
+                          size_t height) override;
+    void Copy2DToDeviceImpl(const void* src,
+                            size_t src_pitch,
+                            CUdeviceptr dst,
+                            size_t dst_pitch,
+                            size_t width,
+                            size_t height) override;
+
+    // records an event on the stream, nullptr if that fails
+    EventHandle RecordEvent(CUstream stream);
+    // event marking the end of a copy just enqueued on the stream; if none
+    // can be recorded, waits for the stream so that nullptr still means the
+    // copy is done
+    EventHandle RecordCopyEvent(CUstream stream);
+
+    // true if [ptr, ptr + size) lies in page-locked memory known to us
+    bool IsPinnedHost(const void* ptr, size_t size) const;
 
-    // Releases warp arguments after kernel launch
-    void ReleaseWarpArgs(void** args);
+    void* FindKernelImpl(const char* name) override;
+    void PreloadImpl(const char* const* funcs, int count) override;
+    void ConfigureLaunchImpl(BoundLaunch* launch) override;
+    void SubmitLaunchImpl(BoundLaunch* launch) override;
+    bool SubmitBatchImpl(BoundLaunch* launches, int count) override;
+    bool AutotuneLaunchImpl(BoundLaunch* launch, int repeats) override;
 
-    ICudaFunctionManager* cuda_;
+    bool BeginCaptureImpl(LaunchGraph* graph) override;
+    bool CaptureOpImpl(LaunchGraph* graph, GraphOp* op) override;
+    bool EndCaptureImpl(LaunchGraph* graph) override;
+    bool ReplayGraphImpl(LaunchGraph* graph) override;
+    void ReleaseGraphImpl(LaunchGraph* graph) override;
+
+    // block size used when a kernel has no tuned entry and the driver cannot
+    // report its occupancy
+    static constexpr unsigned int kDefaultBlockSize = 256;
+    struct KernelOccupancy {
+        // threads per block with the best occupancy
+        unsigned int block_size = kDefaultBlockSize;
+        // threads the device keeps resident at that occupancy
+        size_t resident_threads = 0;
+    };
+    // occupancy of a kernel, queried once per function
+    const KernelOccupancy& Occupancy(CUfunction function);
+
+    // grid and block of a launch covering shape, flat launches are capped to
+    // one wave of resident blocks
+    void SetLaunchDims(BoundLaunch* launch,
+                       const size_t shape[3],
+                       const unsigned int block[3]);
+
+    ICudaFunctionManager* cuda_ = nullptr;
+    bool initialized_ = false;
     CUdevice cu_device_ = 0;
     CUcontext cu_context_ = nullptr;
+    std::string device_name_;
+
+    // every device allocation of the manager goes through this cache
+    std::unique_ptr<DeviceMemoryPool> memory_pool_;
 
-    // only use default stream now, stream family will be used in the next PR
-    std::vector<CUstream> rendering_stream_;
-    std::vector<CUstream> calculate_stream_;
-    std::vector<CUstream> geometry_stream_;
-    std::vector<CUstream> physics_stream_;
-    std::vector<CUstream> custom_stream_;
+    // events of the *Async calls and of Signal, recycled
+    std::unique_ptr<EventPool> event_pool_;
 
+    // pageable transfers at least this large are staged through pinned_ring_
+    static constexpr size_t kStagingThreshold = 256 << 10;
+    std::unique_ptr<PinnedStagingRing> pinned_ring_;
+    // start -> size of every pinned allocation and registered buffer
+    std::map<uintptr_t, size_t> pinned_ranges_;
+    mutable std::mutex pinned_mutex_;
+
+    // indexed by RENDERING_STREAM .. CUSTOM_STREAM
+    StreamFamily stream_families_[CUSTOM_STREAM + 1];
+    std::mutex stream_mutex_;
+    // priorities the device supports, lower numbers are scheduled first
+    int least_stream_priority_ = 0;
+    int greatest_stream_priority_ = 0;
+    // whether the driver has the optional entry points of stream priorities
+    // and of graphs
+    bool stream_priorities_ = false;
+    bool graphs_supported_ = false;
+
+    // compiled modules of previous runs, under $HOME/dexsim_data
+    static constexpr size_t kModuleCacheBytes = size_t(256) << 20;
+    std::unique_ptr<ModuleCache> module_cache_;
+    // KernelIndex.bin of the kernel directory, replaces ProcessFile
+    KernelIndex library_index_;
+    // kernel name -> where to find it, filled by ProcessFile or on lookup
+    struct KernelEntry {
+        std::string module;
+        std::string symbol;
+        CUfunction function = nullptr;  // set once resolved
+    };
+    std::map<std::string, KernelEntry, std::less<>> kernels_;
+    std::map<std::string, std::filesystem::path> module_paths_;
     std::map<std::string, CUmodule> modules_;
-    std::map<std::string, CUfunction> functions_;
-    std::filesystem::path basePath_;
+    // serializes lazy loading, launches may resolve kernels from any thread
+    std::mutex module_mutex_;
+    // reads and loads modules in parallel for Preload, created on first use
+    std::unique_ptr<ThreadPool> load_pool_;
+
+    std::unordered_map<CUfunction, KernelOccupancy> occupancy_;
+    std::shared_mutex occupancy_mutex_;
+    int sm_count_ = 1;
+    int sm_max_threads_ = 2048;
+    // tuned block shapes of this device, stored next to the kernels
+    LaunchConfigCache launch_configs_;
+    std::filesystem::path launch_config_path_;
+    std::once_flag launch_configs_once_;
+    void LoadLaunchConfigs();
 
-    int cudaDriverVersion_;
+    int cudaDriverVersion_ = 0;
+    int compute_capability_ = 0;
     int deviceCount_ = 0;
 };
 }  // namespace cudamgr
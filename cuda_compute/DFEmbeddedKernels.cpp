@@ -0,0 +1,49 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) 2021-2025 DexForce Technology Co., Ltd.
+//
+// All rights reserved.
+// ----------------------------------------------------------------------------
+#include "DFEmbeddedKernels.h"
+
+namespace dexsim {
+namespace cudamgr {
+
+EmbeddedKernelRegistry& EmbeddedKernelRegistry::Instance() {
+    static EmbeddedKernelRegistry instance;
+    return instance;
+}
+
+void EmbeddedKernelRegistry::Register(const EmbeddedModule* modules,
+                                      size_t num_modules,
+                                      const EmbeddedKernel* kernels,
+                                      size_t num_kernels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < num_modules; ++i) {
+        modules_[modules[i].type] = &modules[i];
+    }
+    for (size_t i = 0; i < num_kernels; ++i) {
+        kernels_[kernels[i].name] = &kernels[i];
+    }
+}
+
+const EmbeddedModule* EmbeddedKernelRegistry::FindModule(
+        const char* type) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = modules_.find(type);
+    return it == modules_.end() ? nullptr : it->second;
+}
+
+const EmbeddedKernel* EmbeddedKernelRegistry::FindKernel(
+        const char* name) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = kernels_.find(name);
+    return it == kernels_.end() ? nullptr : it->second;
+}
+
+size_t EmbeddedKernelRegistry::KernelCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return kernels_.size();
+}
+
+}  // namespace cudamgr
+}  // namespace dexsim
@@ -0,0 +1,71 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) 2021-2025 DexForce Technology Co., Ltd.
+//
+// All rights reserved.
+// ----------------------------------------------------------------------------
+#pragma once
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace dexsim {
+namespace cudamgr {
+
+/// \brief A kernel module compiled into the binary.
+struct EmbeddedModule {
+    const char* type;            // module type, e.g. "add" for add.ptx
+    const unsigned char* image;  // PTX or cubin, always null-terminated
+    size_t size;                 // bytes of the image without the terminator
+    bool cubin;                  // loaded as is, PTX goes through the JIT
+};
+
+/// \brief A CoreLUT.txt entry compiled into the binary.
+struct EmbeddedKernel {
+    const char* name;    // kernel name, as used by Launch
+    const char* module;  // type of the module holding it
+    const char* symbol;  // function name inside the module
+};
+
+/// \brief Kernel images and tables linked into the binary.
+///
+/// cmake/DFEmbedKernels.cmake turns a kernel directory into a translation unit
+/// registering its tables here, which lets CudaManager start without reading
+/// any file. The tables are static data, the registry only points into them.
+class EmbeddedKernelRegistry {
+public:
+    static EmbeddedKernelRegistry& Instance();
+
+    /// \brief Registers the tables of one generated translation unit, later
+    /// registrations replace entries of the same name
+    void Register(const EmbeddedModule* modules,
+                  size_t num_modules,
+                  const EmbeddedKernel* kernels,
+                  size_t num_kernels);
+
+    /// \return The module of that type, nullptr if none is embedded
+    const EmbeddedModule* FindModule(const char* type) const;
+    /// \return The kernel of that name, nullptr if none is embedded
+    const EmbeddedKernel* FindKernel(const char* name) const;
+
+    size_t KernelCount() const;
+
+private:
+    EmbeddedKernelRegistry() = default;
+
+    mutable std::mutex mutex_;
+    std::map<std::string, const EmbeddedModule*, std::less<>> modules_;
+    std::map<std::string, const EmbeddedKernel*, std::less<>> kernels_;
+};
+
+// Registers generated kernel tables during static initialization.
+#define DF_REGISTER_EMBEDDED_KERNELS(modules, kernels)                   \
+    static const bool df_embedded_kernels_registered = []() {            \
+        ::dexsim::cudamgr::EmbeddedKernelRegistry::Instance().Register(  \
+                modules, sizeof(modules) / sizeof(modules[0]), kernels,  \
+                sizeof(kernels) / sizeof(kernels[0]));                   \
+        return true;                                                     \
+    }()
+
+}  // namespace cudamgr
+}  // namespace dexsim
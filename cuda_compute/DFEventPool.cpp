@@ -0,0 +1,154 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) 2021-2025 DexForce Technology Co., Ltd.
+//
+// All rights reserved.
+// ----------------------------------------------------------------------------
+#include "DFEventPool.h"
+
+namespace dexsim {
+namespace cudamgr {
+
+namespace {
+
+// token layout: generation in the high word, slot + 1 in the low word, so
+// that no token equals kNoSignal
+SignalToken MakeToken(int slot, uint32_t generation) {
+    return (static_cast<SignalToken>(generation) << 32) |
+           static_cast<uint32_t>(slot + 1);
+}
+
+}  // namespace
+
+EventPool::EventPool(ICudaFunctionManager* cuda) : cuda_(cuda) {}
+
+EventPool::~EventPool() {
+    for (CUevent event : free_events_) { cuda_->cuEventDestroy(event); }
+    for (auto& slot : slots_) { cuda_->cuEventDestroy(slot.event); }
+}
+
+CUevent EventPool::Acquire() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!free_events_.empty()) {
+            CUevent event = free_events_.back();
+            free_events_.pop_back();
+            return event;
+        }
+    }
+    CUevent event = nullptr;
+    auto result = cuda_->cuEventCreate(&event, CU_EVENT_DISABLE_TIMING);
+    if (result != CUDA_SUCCESS) {
+        std::cerr << "Failed to create event. Result Code: " << result
+                  << std::endl;
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++created_;
+    return event;
+}
+
+void EventPool::Release(CUevent event) {
+    if (event == nullptr) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_events_.push_back(event);
+}
+
+void EventPool::Reclaim() {
+    // slots of different streams complete out of order, a slot that is not
+    // done yet moves to the back instead of holding up the others
+    int scan = static_cast<int>(pending_.size());
+    if (scan > kReclaimScan) scan = kReclaimScan;
+    for (int i = 0; i < scan; ++i) {
+        int index = pending_.front();
+        pending_.pop_front();
+        Slot& slot = slots_[index];
+        if (slot.waiters == 0 &&
+            cuda_->cuEventQuery(slot.event) == CUDA_SUCCESS) {
+            ++slot.generation;
+            free_slots_.push_back(index);
+        } else {
+            pending_.push_back(index);
+        }
+    }
+}
+
+EventPool::Slot* EventPool::Find(SignalToken token) {
+    uint32_t low = static_cast<uint32_t>(token);
+    if (low == 0 || low > slots_.size()) return nullptr;
+    Slot& slot = slots_[low - 1];
+    if (slot.generation != static_cast<uint32_t>(token >> 32)) return nullptr;
+    return &slot;
+}
+
+SignalToken EventPool::Signal(CUstream stream) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Reclaim();
+    int index;
+    if (!free_slots_.empty()) {
+        index = free_slots_.back();
+        free_slots_.pop_back();
+    } else {
+        CUevent event = nullptr;
+        auto result = cuda_->cuEventCreate(&event, CU_EVENT_DISABLE_TIMING);
+        if (result != CUDA_SUCCESS) {
+            std::cerr << "Failed to create event. Result Code: " << result
+                      << std::endl;
+            return kNoSignal;
+        }
+        ++created_;
+        index = static_cast<int>(slots_.size());
+        slots_.push_back(Slot());
+        slots_[index].event = event;
+    }
+
+    Slot& slot = slots_[index];
+    auto result = cuda_->cuEventRecord(slot.event, stream);
+    if (result != CUDA_SUCCESS) {
+        std::cerr << "Failed to record event. Result Code: " << result
+                  << std::endl;
+        free_slots_.push_back(index);
+        return kNoSignal;
+    }
+    pending_.push_back(index);
+    return MakeToken(index, slot.generation);
+}
+
+CUDA_CODES EventPool::Wait(CUstream stream, SignalToken token) {
+    // held across the call, so the slot cannot be recorded again before the
+    // stream took its snapshot
+    std::lock_guard<std::mutex> lock(mutex_);
+    Slot* slot = Find(token);
+    if (slot == nullptr) return CUDA_SUCCESS;
+    return cuda_->cuStreamWaitEvent(stream, slot->event, 0);
+}
+
+bool EventPool::Query(SignalToken token) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Slot* slot = Find(token);
+    return slot == nullptr || cuda_->cuEventQuery(slot->event) == CUDA_SUCCESS;
+}
+
+CUDA_CODES EventPool::Synchronize(SignalToken token) {
+    CUevent event;
+    int index;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Slot* slot = Find(token);
+        if (slot == nullptr) return CUDA_SUCCESS;
+        ++slot->waiters;
+        event = slot->event;
+        index = static_cast<int>(slot - slots_.data());
+    }
+    auto result = cuda_->cuEventSynchronize(event);
+    std::lock_guard<std::mutex> lock(mutex_);
+    --slots_[index].waiters;
+    return result;
+}
+
+size_t EventPool::Size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return created_;
+}
+
+}  // namespace cudamgr
+}  // namespace dexsim
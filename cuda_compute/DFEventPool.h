@@ -0,0 +1,93 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) 2021-2025 DexForce Technology Co., Ltd.
+//
+// All rights reserved.
+// ----------------------------------------------------------------------------
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include "DFCudaCodes.h"
+
+namespace dexsim {
+namespace cudamgr {
+
+// Point in a stream returned by Signal, other streams Wait for it. Tokens need
+// no release; kNoSignal is already reached.
+using SignalToken = uint64_t;
+constexpr SignalToken kNoSignal = 0;
+
+/// \brief Recycled CUDA events of a manager.
+///
+/// Events handed out with Acquire are owned by the caller until Release.
+/// Signal tokens are backed by pooled events as well, but name a slot and the
+/// generation it was recorded in: once the event of a slot has completed the
+/// slot is recorded again under the next generation, and tokens of earlier
+/// generations count as reached. Waiting on a token therefore never needs the
+/// token to be released, and old tokens stay valid forever.
+class EventPool {
+public:
+    /// \param cuda Driver entry points
+    explicit EventPool(ICudaFunctionManager* cuda);
+    ~EventPool();
+
+    EventPool(const EventPool&) = delete;
+    EventPool& operator=(const EventPool&) = delete;
+
+    /// \brief A free event, created if none is left; nullptr on failure
+    CUevent Acquire();
+
+    /// \brief Gives an event from Acquire back, it may be recorded again at
+    /// once since pending waits keep their snapshot
+    void Release(CUevent event);
+
+    /// \brief Records a token after the work queued on stream so far
+    ///
+    /// \return The token, kNoSignal if the event could not be recorded
+    SignalToken Signal(CUstream stream);
+
+    /// \brief Makes future work on stream wait for the token, the host does
+    /// not block
+    CUDA_CODES Wait(CUstream stream, SignalToken token);
+
+    /// \brief true once the work before the token has finished, never blocks
+    bool Query(SignalToken token);
+
+    /// \brief Blocks the calling thread until the token is reached
+    CUDA_CODES Synchronize(SignalToken token);
+
+    /// \brief Number of events created so far
+    size_t Size() const;
+
+private:
+    struct Slot {
+        CUevent event = nullptr;
+        uint32_t generation = 0;
+        // threads blocked in Synchronize, the slot is not reused meanwhile
+        int waiters = 0;
+    };
+
+    // looks a few recorded slots up and frees the completed ones, requires
+    // mutex_
+    void Reclaim();
+    // slot of a token, nullptr if its generation has passed. Requires mutex_.
+    Slot* Find(SignalToken token);
+
+    // pending slots checked per Signal
+    static constexpr int kReclaimScan = 8;
+
+    ICudaFunctionManager* cuda_;
+    std::vector<CUevent> free_events_;
+    std::vector<Slot> slots_;
+    std::vector<int> free_slots_;
+    // recorded slots, oldest first
+    std::deque<int> pending_;
+    size_t created_ = 0;
+    mutable std::mutex mutex_;
+};
+
+}  // namespace cudamgr
+}  // namespace dexsim
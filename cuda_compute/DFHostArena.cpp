@@ -0,0 +1,238 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) 2021-2025 DexForce Technology Co., Ltd.
+//
+// All rights reserved.
+// ----------------------------------------------------------------------------
+#include "DFHostArena.h"
+
+#include <iostream>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace dexsim {
+namespace cudamgr {
+
+HostArena::~HostArena() {
+    for (auto& list : free_lists_) {
+        while (list.second != nullptr) {
+            BlockHeader* next = list.second->next;
+            DeleteBlock(list.second);
+            list.second = next;
+        }
+    }
+    while (live_ != nullptr) {
+        BlockHeader* next = live_->next;
+        DeleteBlock(live_);
+        live_ = next;
+    }
+    for (auto& chunk : scratch_chunks_) { SystemFree(chunk.data, chunk.size); }
+}
+
+size_t HostArena::ClassSize(size_t size) {
+    if (size <= kAlignment) return kAlignment;
+    if (size >= kHugeBlockSize) {
+        return (size + kHugeBlockSize - 1) & ~(kHugeBlockSize - 1);
+    }
+    // four classes per power of two: 256, 320, 384, 448, 512, 640, ...
+    size_t power = kAlignment;
+    while (power * 2 < size) power *= 2;
+    size_t step = power < 4 * kAlignment ? kAlignment : power / 4;
+    return (size + step - 1) / step * step;
+}
+
+void* HostArena::SystemAllocate(size_t size) {
+    size_t alignment = size >= kHugeBlockSize ? kHugeBlockSize : kAlignment;
+    void* ptr =
+            ::operator new(size, std::align_val_t(alignment), std::nothrow);
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    // a hint only, the kernel may still use small pages
+    if (ptr != nullptr && size >= kHugeBlockSize) {
+        madvise(ptr, size, MADV_HUGEPAGE);
+    }
+#endif
+    return ptr;
+}
+
+void HostArena::SystemFree(void* ptr, size_t size) {
+    size_t alignment = size >= kHugeBlockSize ? kHugeBlockSize : kAlignment;
+    ::operator delete(ptr, std::align_val_t(alignment));
+}
+
+HostArena::BlockHeader* HostArena::HeaderOf(void* data) const {
+    // huge blocks start on a huge page, a small one only by chance
+    if ((reinterpret_cast<uintptr_t>(data) & (kHugeBlockSize - 1)) == 0) {
+        auto it = huge_headers_.find(data);
+        if (it != huge_headers_.end()) return it->second;
+    }
+    return reinterpret_cast<BlockHeader*>(static_cast<char*>(data) -
+                                          kAlignment);
+}
+
+HostArena::BlockHeader* HostArena::NewBlock(size_t class_size) {
+    BlockHeader* header = nullptr;
+    if (IsHuge(class_size)) {
+        // exactly class_size bytes, so the block covers whole huge pages
+        char* data = static_cast<char*>(SystemAllocate(class_size));
+        if (data == nullptr) return nullptr;
+        header = new (std::nothrow) BlockHeader;
+        if (header == nullptr) {
+            SystemFree(data, class_size);
+            return nullptr;
+        }
+        header->data = data;
+        huge_headers_.emplace(data, header);
+    } else {
+        header = static_cast<BlockHeader*>(
+                SystemAllocate(kAlignment + class_size));
+        if (header == nullptr) return nullptr;
+        header->data = reinterpret_cast<char*>(header) + kAlignment;
+    }
+    header->class_size = class_size;
+    return header;
+}
+
+void HostArena::DeleteBlock(BlockHeader* header) {
+    header->tag = 0;
+    if (IsHuge(header->class_size)) {
+        huge_headers_.erase(header->data);
+        SystemFree(header->data, header->class_size);
+        delete header;
+    } else {
+        SystemFree(header, kAlignment + header->class_size);
+    }
+}
+
+void HostArena::LinkLive(BlockHeader* header) {
+    header->tag = kLiveTag;
+    header->prev = nullptr;
+    header->next = live_;
+    if (live_ != nullptr) live_->prev = header;
+    live_ = header;
+}
+
+void HostArena::UnlinkLive(BlockHeader* header) {
+    if (header->prev != nullptr) {
+        header->prev->next = header->next;
+    } else {
+        live_ = header->next;
+    }
+    if (header->next != nullptr) header->next->prev = header->prev;
+}
+
+void* HostArena::Allocate(size_t size) {
+    size_t class_size = ClassSize(size);
+    std::lock_guard<std::mutex> lock(mutex_);
+    BlockHeader* header = nullptr;
+    auto it = free_lists_.find(class_size);
+    if (it != free_lists_.end() && it->second != nullptr) {
+        header = it->second;
+        it->second = header->next;
+        stats_.bytes_cached -= class_size;
+        ++stats_.hits;
+    } else {
+        header = NewBlock(class_size);
+        if (header == nullptr) {
+            std::cerr << "Warning: Failed to allocate " << class_size
+                      << " bytes of host memory." << std::endl;
+            return nullptr;
+        }
+        ++stats_.misses;
+    }
+    LinkLive(header);
+    stats_.bytes_in_use += class_size;
+    return header->data;
+}
+
+bool HostArena::Free(void* ptr) {
+    if (ptr == nullptr) return true;
+    std::lock_guard<std::mutex> lock(mutex_);
+    BlockHeader* header = HeaderOf(ptr);
+    if (header->tag != kLiveTag) return false;
+    UnlinkLive(header);
+    size_t class_size = header->class_size;
+    BlockHeader*& list = free_lists_[class_size];
+    header->tag = kFreeTag;
+    header->next = list;
+    list = header;
+    stats_.bytes_in_use -= class_size;
+    stats_.bytes_cached += class_size;
+    return true;
+}
+
+void* HostArena::AllocateScratch(size_t size) {
+    size = (size + kAlignment - 1) & ~(kAlignment - 1);
+    std::lock_guard<std::mutex> lock(mutex_);
+    // move on to the first chunk the request fits in; skipped space is only
+    // reused after the next reset
+    while (scratch_chunk_ < scratch_chunks_.size() &&
+           scratch_offset_ + size > scratch_chunks_[scratch_chunk_].size) {
+        ++scratch_chunk_;
+        scratch_offset_ = 0;
+    }
+    if (scratch_chunk_ == scratch_chunks_.size()) {
+        Chunk chunk;
+        chunk.size = ClassSize(size > kScratchChunkSize ? size
+                                                        : kScratchChunkSize);
+        chunk.data = static_cast<char*>(SystemAllocate(chunk.size));
+        if (chunk.data == nullptr) {
+            std::cerr << "Warning: Failed to allocate " << chunk.size
+                      << " bytes of scratch memory." << std::endl;
+            return nullptr;
+        }
+        scratch_chunks_.push_back(chunk);
+        stats_.scratch_bytes += chunk.size;
+    }
+    char* ptr = scratch_chunks_[scratch_chunk_].data + scratch_offset_;
+    scratch_offset_ += size;
+    scratch_in_use_ += size;
+    return ptr;
+}
+
+void HostArena::ResetScratch() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    scratch_chunk_ = 0;
+    scratch_offset_ = 0;
+    scratch_in_use_ = 0;
+}
+
+size_t HostArena::Trim() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t released = 0;
+    for (auto& list : free_lists_) {
+        while (list.second != nullptr) {
+            BlockHeader* next = list.second->next;
+            DeleteBlock(list.second);
+            released += list.first;
+            list.second = next;
+        }
+    }
+    stats_.bytes_cached = 0;
+
+    // chunks past the one in use hold no scratch memory
+    size_t keep = scratch_in_use_ == 0 ? 0 : scratch_chunk_ + 1;
+    while (scratch_chunks_.size() > keep) {
+        Chunk& chunk = scratch_chunks_.back();
+        SystemFree(chunk.data, chunk.size);
+        released += chunk.size;
+        stats_.scratch_bytes -= chunk.size;
+        scratch_chunks_.pop_back();
+    }
+    if (keep == 0) {
+        scratch_chunk_ = 0;
+        scratch_offset_ = 0;
+    }
+    return released;
+}
+
+HostArenaStats HostArena::GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    HostArenaStats stats = stats_;
+    stats.scratch_in_use = scratch_in_use_;
+    return stats;
+}
+
+}  // namespace cudamgr
+}  // namespace dexsim
@@ -0,0 +1,138 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) 2021-2025 DexForce Technology Co., Ltd.
+//
+// All rights reserved.
+// ----------------------------------------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace dexsim {
+namespace cudamgr {
+
+struct HostArenaStats {
+    size_t hits = 0;            // allocations served from a free list
+    size_t misses = 0;          // allocations that reached the system
+    size_t bytes_in_use = 0;    // bytes of the blocks handed out
+    size_t bytes_cached = 0;    // bytes parked in the free lists
+    size_t scratch_bytes = 0;   // bytes reserved for scratch memory
+    size_t scratch_in_use = 0;  // scratch bytes handed out since the reset
+};
+
+/// \brief Caching allocator for pageable host memory.
+///
+/// Blocks are aligned to a cache line, so vectorized host kernels and memcpy
+/// never straddle one at the start of an array; blocks of at least
+/// kHugeBlockSize come from allocations aligned to it and, on Linux, backed
+/// by huge pages. Sizes are rounded up to a size class, four per power of two,
+/// and freed blocks are parked in the free list of their class, so
+/// steady-state allocation does not reach the system allocator. Every block
+/// is preceded by a cache line holding its class and the list links, so
+/// Allocate and Free do not allocate bookkeeping either. Huge blocks keep
+/// that header apart, in a map created along with the block, so their data
+/// starts on the huge page and spans no extra one. Trim gives the cached
+/// blocks back.
+///
+/// Scratch memory is carved from a few large chunks with a bump pointer. It
+/// is not freed piece by piece: ResetScratch hands all of it out again at
+/// once, e.g. at the start of every frame.
+class HostArena {
+public:
+    static constexpr size_t kAlignment = 64;
+    static constexpr size_t kHugeBlockSize = size_t(2) << 20;
+
+    HostArena() = default;
+    ~HostArena();
+
+    HostArena(const HostArena&) = delete;
+    HostArena& operator=(const HostArena&) = delete;
+
+    /// \brief At least size bytes aligned to kAlignment, nullptr on failure
+    void* Allocate(size_t size);
+
+    /// \brief Returns a block from Allocate to its free list
+    ///
+    /// \param ptr Block from Allocate of this arena, or nullptr
+    /// \return false if the header of ptr does not mark a live block, e.g.
+    /// on a double free
+    bool Free(void* ptr);
+
+    /// \brief size bytes aligned to kAlignment, valid until ResetScratch
+    void* AllocateScratch(size_t size);
+
+    /// \brief Makes all scratch memory available again, in O(1)
+    void ResetScratch();
+
+    /// \brief Releases the cached blocks and unused scratch chunks
+    ///
+    /// \return Number of bytes given back
+    size_t Trim();
+
+    HostArenaStats GetStats() const;
+
+    /// \brief Size class a request of size bytes is rounded up to
+    static size_t ClassSize(size_t size);
+
+private:
+    struct Chunk {
+        char* data = nullptr;
+        size_t size = 0;
+    };
+
+    // the cache line in front of every block from Allocate, huge blocks
+    // have it allocated on its own
+    struct BlockHeader {
+        size_t class_size;
+        uint64_t tag;  // kLiveTag while handed out, kFreeTag when parked
+        char* data;    // the block handed out
+        // live_ list while handed out, next in the free list when parked
+        BlockHeader* prev;
+        BlockHeader* next;
+    };
+    static_assert(sizeof(BlockHeader) <= kAlignment,
+                  "the block header must fit in front of the alignment");
+    static constexpr uint64_t kLiveTag = 0x4446415245414c31ull;
+    static constexpr uint64_t kFreeTag = 0x4446415245414630ull;
+
+    static bool IsHuge(size_t class_size) {
+        return class_size >= kHugeBlockSize;
+    }
+    // the header of a block from Allocate, looked up in huge_headers_ if the
+    // block may be huge
+    BlockHeader* HeaderOf(void* data) const;
+    // a block of class_size data bytes, with its header, from the system
+    BlockHeader* NewBlock(size_t class_size);
+    void DeleteBlock(BlockHeader* header);
+    void LinkLive(BlockHeader* header);
+    void UnlinkLive(BlockHeader* header);
+
+    // size bytes from the system with the alignment of that size
+    static void* SystemAllocate(size_t size);
+    static void SystemFree(void* ptr, size_t size);
+
+    // scratch chunks are at least this large
+    static constexpr size_t kScratchChunkSize = size_t(4) << 20;
+
+    // class size -> parked blocks linked through their headers; a class gets
+    // its entry with the first free and keeps it
+    std::unordered_map<size_t, BlockHeader*> free_lists_;
+    // data -> header of every huge block, live or parked
+    std::unordered_map<void*, BlockHeader*> huge_headers_;
+    // every block handed out, released by the destructor
+    BlockHeader* live_ = nullptr;
+    // scratch chunks in the order they are used; chunks before
+    // scratch_chunk_ are full
+    std::vector<Chunk> scratch_chunks_;
+    size_t scratch_chunk_ = 0;
+    size_t scratch_offset_ = 0;
+    size_t scratch_in_use_ = 0;
+    HostArenaStats stats_;
+    mutable std::mutex mutex_;
+};
+
+}  // namespace cudamgr
+}  // namespace dexsim
@@ -0,0 +1,105 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) 2021-2025 DexForce Technology Co., Ltd.
+//
+// All rights reserved.
+// ----------------------------------------------------------------------------
+#include "DFHostKernels.h"
+
+#include <algorithm>
+#include <type_traits>
+
+#include "DFHostSimd.h"
+
+namespace dexsim {
+namespace cudamgr {
+
+namespace {
+// Strided views are gathered into blocks of this many elements, so that they
+// run the same span kernels as dense arrays.
+constexpr size_t kGatherBlock = 256;
+
+const char* const kElementwiseOpNames[OP_COUNT] = {
+        "add", "sub", "mul", "div", "fma", "clamp", "lerp"};
+
+// dest = op(inputs...), the arrays come in the argument order of the
+// arrayNd_<op><dtype> kernels in CoreLUT.txt, inputs first, dest last
+template <typename T, ElementwiseOp Op>
+void ElementwiseKernel(void** args, size_t begin, size_t end) {
+    constexpr int arity = ElementwiseArity(Op);
+    const auto& bounds = *static_cast<CudaBounds*>(args[0]);
+    const wp::array_t<T>* arrays[arity + 1];
+    bool dense = true;
+    for (int k = 0; k <= arity; ++k) {
+        arrays[k] = static_cast<wp::array_t<T>*>(args[k + 1]);
+        dense = dense && WarpArrayDense(*arrays[k], bounds);
+    }
+    SpanKernel<T> kernel = ActiveSpanKernels().Get<T>(Op);
+    const T* src[3];
+    if (dense) {
+        for (int k = 0; k < arity; ++k) { src[k] = arrays[k]->data + begin; }
+        kernel(src, arrays[arity]->data + begin, end - begin);
+        return;
+    }
+
+    T in[3][kGatherBlock];
+    T out[kGatherBlock];
+    for (size_t first = begin; first < end; first += kGatherBlock) {
+        size_t n = std::min(kGatherBlock, end - first);
+        for (int k = 0; k < arity; ++k) {
+            for (size_t i = 0; i < n; ++i) {
+                in[k][i] = WarpArrayAt(*arrays[k], bounds, first + i);
+            }
+            src[k] = in[k];
+        }
+        kernel(src, out, n);
+        for (size_t i = 0; i < n; ++i) {
+            WarpArrayAt(*arrays[arity], bounds, first + i) = out[i];
+        }
+    }
+}
+
+using KernelMap = std::map<std::string, HostKernel, std::less<>>;
+
+// Registers arrayNd_<op><dtype>_0 for every operation and N = 1..4.
+template <typename T>
+void AddElementwiseKernels(KernelMap* kernels, const char* dtype) {
+    const HostKernel ops[OP_COUNT] = {
+            ElementwiseKernel<T, OP_ADD>, ElementwiseKernel<T, OP_SUB>,
+            ElementwiseKernel<T, OP_MUL>, ElementwiseKernel<T, OP_DIV>,
+            ElementwiseKernel<T, OP_FMA>, ElementwiseKernel<T, OP_CLAMP>,
+            ElementwiseKernel<T, OP_LERP>};
+    for (int op = 0; op < OP_COUNT; ++op) {
+        if (op == OP_LERP && !std::is_floating_point<T>::value) continue;
+        for (int dim = 1; dim <= 4; ++dim) {
+            std::string name = "array" + std::to_string(dim) + "d_" +
+                               kElementwiseOpNames[op] + dtype + "_0";
+            (*kernels)[name] = ops[op];
+        }
+    }
+}
+}  // namespace
+
+HostKernelRegistry::HostKernelRegistry() {
+    AddElementwiseKernels<float>(&kernels_, "f32");
+    AddElementwiseKernels<double>(&kernels_, "f64");
+    AddElementwiseKernels<int32_t>(&kernels_, "i32");
+}
+
+HostKernelRegistry& HostKernelRegistry::Instance() {
+    static HostKernelRegistry instance;
+    return instance;
+}
+
+void HostKernelRegistry::Register(const std::string& name, HostKernel kernel) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    kernels_[name] = kernel;
+}
+
+HostKernel HostKernelRegistry::Find(const char* name) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = kernels_.find(name);
+    return it == kernels_.end() ? nullptr : it->second;
+}
+
+}  // namespace cudamgr
+}  // namespace dexsim
@@ -0,0 +1,61 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) 2021-2025 DexForce Technology Co., Ltd.
+//
+// All rights reserved.
+// ----------------------------------------------------------------------------
+#pragma once
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "DFWarpArgs.h"
+
+namespace dexsim {
+namespace cudamgr {
+
+/// \brief Signature of a kernel executed on the host.
+///
+/// \param args The Warp argument block, laid out exactly like the one passed
+/// to cuLaunchKernel: args[0] points to the CudaBounds, args[i + 1] to the
+/// wp::array_t of the i-th array.
+/// \param begin First flattened launch index to process
+/// \param end One past the last flattened launch index to process
+using HostKernel = void (*)(void** args, size_t begin, size_t end);
+
+/// \brief Name -> host kernel table used by the CPU backend.
+///
+/// Kernels are registered under the same names as in CoreLUT.txt so that step
+/// code can launch them unchanged on either backend.
+class HostKernelRegistry {
+public:
+    static HostKernelRegistry& Instance();
+
+    /// \brief Registers a host kernel, replacing any kernel with the same name
+    ///
+    /// \param name Kernel name, as used by Launch
+    /// \param kernel The host implementation
+    void Register(const std::string& name, HostKernel kernel);
+
+    /// \brief Looks up a host kernel
+    ///
+    /// \param name Kernel name, as used by Launch
+    /// \return The host implementation, nullptr if none is registered
+    HostKernel Find(const char* name) const;
+
+private:
+    HostKernelRegistry();
+
+    mutable std::mutex mutex_;
+    std::map<std::string, HostKernel, std::less<>> kernels_;
+};
+
+// Registers a host kernel during static initialization.
+#define DF_REGISTER_HOST_KERNEL(name, kernel)                               \
+    static const bool df_host_kernel_registered_##kernel = []() {           \
+        ::dexsim::cudamgr::HostKernelRegistry::Instance().Register(name,    \
+                                                                   kernel); \
+        return true;                                                        \
+    }()
+
+}  // namespace cudamgr
+}  // namespace dexsim
@@ -0,0 +1,129 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) 2021-2025 DexForce Technology Co., Ltd.
+//
+// All rights reserved.
+// ----------------------------------------------------------------------------
+#include "DFHostSimd.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#if defined(_MSC_VER) && !defined(__clang__) && \
+        (defined(_M_X64) || defined(_M_IX86))
+#include <immintrin.h>
+#include <intrin.h>
+#define DF_SIMD_CPUID 1
+#endif
+
+namespace dexsim {
+namespace cudamgr {
+
+namespace {
+
+// Instruction sets the CPU and the operating system support.
+SimdLevel DetectCpuSimdLevel() {
+#if defined(DF_SIMD_CPUID)
+    int info[4];
+    __cpuid(info, 1);
+    bool fma = (info[2] & (1 << 12)) != 0;
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    if (!fma || !osxsave) return SIMD_SCALAR;
+    // the OS must save the YMM (and for AVX-512 the ZMM and mask) state
+    unsigned long long xcr0 = _xgetbv(0);
+    if ((xcr0 & 0x6) != 0x6) return SIMD_SCALAR;
+    __cpuidex(info, 7, 0);
+    if ((info[1] & (1 << 5)) == 0) return SIMD_SCALAR;
+    if ((info[1] & (1 << 16)) != 0 && (xcr0 & 0xe6) == 0xe6) {
+        return SIMD_AVX512;
+    }
+    return SIMD_AVX2;
+#elif (defined(__GNUC__) || defined(__clang__)) && \
+        (defined(__x86_64__) || defined(__i386__))
+    // also checks that the OS saves the vector state
+    __builtin_cpu_init();
+    if (!__builtin_cpu_supports("avx2") || !__builtin_cpu_supports("fma")) {
+        return SIMD_SCALAR;
+    }
+    if (__builtin_cpu_supports("avx512f")) return SIMD_AVX512;
+    return SIMD_AVX2;
+#else
+    return SIMD_SCALAR;
+#endif
+}
+
+const SpanKernels* KernelsOf(SimdLevel level) {
+    switch (level) {
+        case SIMD_AVX512:
+            return SpanKernelsAvx512();
+        case SIMD_AVX2:
+            return SpanKernelsAvx2();
+        default:
+            return SpanKernelsScalar();
+    }
+}
+
+SimdLevel DetectSupportedSimdLevel() {
+    // a set is only usable if its translation unit was built for it
+    SimdLevel level = DetectCpuSimdLevel();
+    if (level == SIMD_AVX512 && SpanKernelsAvx512() == nullptr) {
+        level = SIMD_AVX2;
+    }
+    if (level == SIMD_AVX2 && SpanKernelsAvx2() == nullptr) {
+        level = SIMD_SCALAR;
+    }
+    return level;
+}
+
+SimdLevel DefaultSimdLevel() {
+    SimdLevel level = SupportedSimdLevel();
+    const char* name = std::getenv("DEXSIM_SIMD");
+    if (name == nullptr || *name == '\0') return level;
+    SimdLevel cap = level;
+    if (std::strcmp(name, "scalar") == 0) {
+        cap = SIMD_SCALAR;
+    } else if (std::strcmp(name, "avx2") == 0) {
+        cap = SIMD_AVX2;
+    } else if (std::strcmp(name, "avx512") != 0) {
+        std::cerr << "Warning: Unknown DEXSIM_SIMD value " << name << "."
+                  << std::endl;
+    }
+    return cap < level ? cap : level;
+}
+
+struct ActiveLevel {
+    std::atomic<SimdLevel> level{DefaultSimdLevel()};
+    std::atomic<const SpanKernels*> kernels{KernelsOf(level.load())};
+};
+
+ActiveLevel& Active() {
+    static ActiveLevel active;
+    return active;
+}
+
+}  // namespace
+
+SimdLevel SupportedSimdLevel() {
+    static const SimdLevel level = DetectSupportedSimdLevel();
+    return level;
+}
+
+SimdLevel GetSimdLevel() {
+    return Active().level.load(std::memory_order_relaxed);
+}
+
+bool SetSimdLevel(SimdLevel level) {
+    if (level > SupportedSimdLevel()) return false;
+    ActiveLevel& active = Active();
+    active.kernels.store(KernelsOf(level), std::memory_order_relaxed);
+    active.level.store(level, std::memory_order_relaxed);
+    return true;
+}
+
+const SpanKernels& ActiveSpanKernels() {
+    return *Active().kernels.load(std::memory_order_relaxed);
+}
+
+}  // namespace cudamgr
+}  // namespace dexsim
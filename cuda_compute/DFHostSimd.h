@@ -0,0 +1,95 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) 2021-2025 DexForce Technology Co., Ltd.
+//
+// All rights reserved.
+// ----------------------------------------------------------------------------
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace dexsim {
+namespace cudamgr {
+
+// Instruction sets the host kernels are built for, in increasing order.
+enum SimdLevel : unsigned char {
+    SIMD_SCALAR = 0,
+    SIMD_AVX2 = 1,    // AVX2 + FMA
+    SIMD_AVX512 = 2,  // AVX-512F
+};
+
+// Elementwise operations of the host kernel set. The inputs come first in the
+// argument order of the kernels, the destination last.
+enum ElementwiseOp : unsigned char {
+    OP_ADD = 0,    // a + b
+    OP_SUB = 1,    // a - b
+    OP_MUL = 2,    // a * b
+    OP_DIV = 3,    // a / b, an integer division by zero yields 0
+    OP_FMA = 4,    // a * b + c, fused
+    OP_CLAMP = 5,  // min(max(x, lo), hi)
+    OP_LERP = 6,   // a * (1 - t) + b * t, floating point only
+    OP_COUNT = 7,
+};
+
+// Number of input arrays of an operation.
+constexpr int ElementwiseArity(ElementwiseOp op) {
+    return op == OP_FMA || op == OP_CLAMP || op == OP_LERP ? 3 : 2;
+}
+
+// Applies an operation to n contiguous elements: dest[i] = op(src[0][i],
+// src[1][i], ...). dest may alias an input exactly.
+template <typename T>
+using SpanKernel = void (*)(const T* const* src, T* dest, size_t n);
+
+// The span kernels of one instruction set, nullptr where an operation is not
+// defined for a type.
+struct SpanKernels {
+    SpanKernel<float> f32[OP_COUNT];
+    SpanKernel<double> f64[OP_COUNT];
+    SpanKernel<int32_t> i32[OP_COUNT];
+
+    template <typename T>
+    SpanKernel<T> Get(ElementwiseOp op) const;
+};
+
+template <>
+inline SpanKernel<float> SpanKernels::Get<float>(ElementwiseOp op) const {
+    return f32[op];
+}
+
+template <>
+inline SpanKernel<double> SpanKernels::Get<double>(ElementwiseOp op) const {
+    return f64[op];
+}
+
+template <>
+inline SpanKernel<int32_t> SpanKernels::Get<int32_t>(ElementwiseOp op) const {
+    return i32[op];
+}
+
+// Tables of every instruction set, each built in its own translation unit.
+// The AVX tables are nullptr when the compiler did not target the set; they
+// must only be called once the CPU is known to support it.
+const SpanKernels* SpanKernelsScalar();
+const SpanKernels* SpanKernelsAvx2();
+const SpanKernels* SpanKernelsAvx512();
+
+/// \brief Best instruction set supported by both the CPU and the build
+SimdLevel SupportedSimdLevel();
+
+/// \brief Instruction set the host kernels currently use
+///
+/// Defaults to SupportedSimdLevel(), capped by the DEXSIM_SIMD environment
+/// variable ("scalar", "avx2" or "avx512").
+SimdLevel GetSimdLevel();
+
+/// \brief Switches the host kernels to another instruction set, e.g. to check
+/// the code paths against each other
+///
+/// \return false, and no change, if the level is not supported
+bool SetSimdLevel(SimdLevel level);
+
+/// \brief Span kernels of the current instruction set
+const SpanKernels& ActiveSpanKernels();
+
+}  // namespace cudamgr
+}  // namespace dexsim
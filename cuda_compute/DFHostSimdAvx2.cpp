@@ -0,0 +1,131 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) 2021-2025 DexForce Technology Co., Ltd.
+//
+// All rights reserved.
+// ----------------------------------------------------------------------------
+// Built with -mavx2 -mfma (/arch:AVX2), see CMakeLists.txt.
+#include "DFHostSimdLoops.h"
+
+#if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+#include <immintrin.h>
+
+namespace dexsim {
+namespace cudamgr {
+
+namespace {
+
+// lanes [0, n) of a 32 bit mask
+inline __m256i Mask32(size_t n) {
+    return _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int>(n)),
+                              _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+}
+
+// lanes [0, n) of a 64 bit mask
+inline __m256i Mask64(size_t n) {
+    return _mm256_cmpgt_epi64(_mm256_set1_epi64x(static_cast<long long>(n)),
+                              _mm256_setr_epi64x(0, 1, 2, 3));
+}
+
+struct Avx2F32 {
+    using Scalar = float;
+    using Reg = __m256;
+    static constexpr size_t kWidth = 8;
+
+    static Reg Load(const float* p) { return _mm256_loadu_ps(p); }
+    static Reg LoadPartial(const float* p, size_t n) {
+        return _mm256_maskload_ps(p, Mask32(n));
+    }
+    static void Store(float* p, Reg v) { _mm256_storeu_ps(p, v); }
+    static void StorePartial(float* p, Reg v, size_t n) {
+        _mm256_maskstore_ps(p, Mask32(n), v);
+    }
+    static Reg Set1(float x) { return _mm256_set1_ps(x); }
+    static Reg Add(Reg a, Reg b) { return _mm256_add_ps(a, b); }
+    static Reg Sub(Reg a, Reg b) { return _mm256_sub_ps(a, b); }
+    static Reg Mul(Reg a, Reg b) { return _mm256_mul_ps(a, b); }
+    static Reg Div(Reg a, Reg b) { return _mm256_div_ps(a, b); }
+    static Reg Fma(Reg a, Reg b, Reg c) { return _mm256_fmadd_ps(a, b, c); }
+    static Reg Min(Reg a, Reg b) { return _mm256_min_ps(a, b); }
+    static Reg Max(Reg a, Reg b) { return _mm256_max_ps(a, b); }
+};
+
+struct Avx2F64 {
+    using Scalar = double;
+    using Reg = __m256d;
+    static constexpr size_t kWidth = 4;
+
+    static Reg Load(const double* p) { return _mm256_loadu_pd(p); }
+    static Reg LoadPartial(const double* p, size_t n) {
+        return _mm256_maskload_pd(p, Mask64(n));
+    }
+    static void Store(double* p, Reg v) { _mm256_storeu_pd(p, v); }
+    static void StorePartial(double* p, Reg v, size_t n) {
+        _mm256_maskstore_pd(p, Mask64(n), v);
+    }
+    static Reg Set1(double x) { return _mm256_set1_pd(x); }
+    static Reg Add(Reg a, Reg b) { return _mm256_add_pd(a, b); }
+    static Reg Sub(Reg a, Reg b) { return _mm256_sub_pd(a, b); }
+    static Reg Mul(Reg a, Reg b) { return _mm256_mul_pd(a, b); }
+    static Reg Div(Reg a, Reg b) { return _mm256_div_pd(a, b); }
+    static Reg Fma(Reg a, Reg b, Reg c) { return _mm256_fmadd_pd(a, b, c); }
+    static Reg Min(Reg a, Reg b) { return _mm256_min_pd(a, b); }
+    static Reg Max(Reg a, Reg b) { return _mm256_max_pd(a, b); }
+};
+
+struct Avx2I32 {
+    using Scalar = int32_t;
+    using Reg = __m256i;
+    static constexpr size_t kWidth = 8;
+
+    static Reg Load(const int32_t* p) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    }
+    static Reg LoadPartial(const int32_t* p, size_t n) {
+        return _mm256_maskload_epi32(reinterpret_cast<const int*>(p),
+                                     Mask32(n));
+    }
+    static void Store(int32_t* p, Reg v) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+    }
+    static void StorePartial(int32_t* p, Reg v, size_t n) {
+        _mm256_maskstore_epi32(reinterpret_cast<int*>(p), Mask32(n), v);
+    }
+    static Reg Set1(int32_t x) { return _mm256_set1_epi32(x); }
+    static Reg Add(Reg a, Reg b) { return _mm256_add_epi32(a, b); }
+    static Reg Sub(Reg a, Reg b) { return _mm256_sub_epi32(a, b); }
+    static Reg Mul(Reg a, Reg b) { return _mm256_mullo_epi32(a, b); }
+    // there is no vector integer division
+    static Reg Div(Reg a, Reg b) {
+        alignas(32) int32_t x[8];
+        alignas(32) int32_t y[8];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(x), a);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(y), b);
+        for (int i = 0; i < 8; ++i) { x[i] = DivInt(x[i], y[i]); }
+        return _mm256_load_si256(reinterpret_cast<const __m256i*>(x));
+    }
+    static Reg Fma(Reg a, Reg b, Reg c) { return Add(Mul(a, b), c); }
+    static Reg Min(Reg a, Reg b) { return _mm256_min_epi32(a, b); }
+    static Reg Max(Reg a, Reg b) { return _mm256_max_epi32(a, b); }
+};
+
+constexpr SpanKernels kAvx2Kernels =
+        MakeSpanKernels<Avx2F32, Avx2F64, Avx2I32>();
+
+}  // namespace
+
+const SpanKernels* SpanKernelsAvx2() { return &kAvx2Kernels; }
+
+}  // namespace cudamgr
+}  // namespace dexsim
+
+#else
+
+namespace dexsim {
+namespace cudamgr {
+
+const SpanKernels* SpanKernelsAvx2() { return nullptr; }
+
+}  // namespace cudamgr
+}  // namespace dexsim
+
+#endif
@@ -0,0 +1,121 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) 2021-2025 DexForce Technology Co., Ltd.
+//
+// All rights reserved.
+// ----------------------------------------------------------------------------
+// Built with -mavx512f (/arch:AVX512), see CMakeLists.txt.
+#include "DFHostSimdLoops.h"
+
+#if defined(__AVX512F__)
+#include <immintrin.h>
+
+namespace dexsim {
+namespace cudamgr {
+
+namespace {
+
+// lanes [0, n) of a mask, n is below the vector width
+inline __mmask16 Mask16(size_t n) {
+    return static_cast<__mmask16>((1u << n) - 1);
+}
+
+inline __mmask8 Mask8(size_t n) { return static_cast<__mmask8>((1u << n) - 1); }
+
+struct Avx512F32 {
+    using Scalar = float;
+    using Reg = __m512;
+    static constexpr size_t kWidth = 16;
+
+    static Reg Load(const float* p) { return _mm512_loadu_ps(p); }
+    static Reg LoadPartial(const float* p, size_t n) {
+        return _mm512_maskz_loadu_ps(Mask16(n), p);
+    }
+    static void Store(float* p, Reg v) { _mm512_storeu_ps(p, v); }
+    static void StorePartial(float* p, Reg v, size_t n) {
+        _mm512_mask_storeu_ps(p, Mask16(n), v);
+    }
+    static Reg Set1(float x) { return _mm512_set1_ps(x); }
+    static Reg Add(Reg a, Reg b) { return _mm512_add_ps(a, b); }
+    static Reg Sub(Reg a, Reg b) { return _mm512_sub_ps(a, b); }
+    static Reg Mul(Reg a, Reg b) { return _mm512_mul_ps(a, b); }
+    static Reg Div(Reg a, Reg b) { return _mm512_div_ps(a, b); }
+    static Reg Fma(Reg a, Reg b, Reg c) { return _mm512_fmadd_ps(a, b, c); }
+    static Reg Min(Reg a, Reg b) { return _mm512_min_ps(a, b); }
+    static Reg Max(Reg a, Reg b) { return _mm512_max_ps(a, b); }
+};
+
+struct Avx512F64 {
+    using Scalar = double;
+    using Reg = __m512d;
+    static constexpr size_t kWidth = 8;
+
+    static Reg Load(const double* p) { return _mm512_loadu_pd(p); }
+    static Reg LoadPartial(const double* p, size_t n) {
+        return _mm512_maskz_loadu_pd(Mask8(n), p);
+    }
+    static void Store(double* p, Reg v) { _mm512_storeu_pd(p, v); }
+    static void StorePartial(double* p, Reg v, size_t n) {
+        _mm512_mask_storeu_pd(p, Mask8(n), v);
+    }
+    static Reg Set1(double x) { return _mm512_set1_pd(x); }
+    static Reg Add(Reg a, Reg b) { return _mm512_add_pd(a, b); }
+    static Reg Sub(Reg a, Reg b) { return _mm512_sub_pd(a, b); }
+    static Reg Mul(Reg a, Reg b) { return _mm512_mul_pd(a, b); }
+    static Reg Div(Reg a, Reg b) { return _mm512_div_pd(a, b); }
+    static Reg Fma(Reg a, Reg b, Reg c) { return _mm512_fmadd_pd(a, b, c); }
+    static Reg Min(Reg a, Reg b) { return _mm512_min_pd(a, b); }
+    static Reg Max(Reg a, Reg b) { return _mm512_max_pd(a, b); }
+};
+
+struct Avx512I32 {
+    using Scalar = int32_t;
+    using Reg = __m512i;
+    static constexpr size_t kWidth = 16;
+
+    static Reg Load(const int32_t* p) { return _mm512_loadu_si512(p); }
+    static Reg LoadPartial(const int32_t* p, size_t n) {
+        return _mm512_maskz_loadu_epi32(Mask16(n), p);
+    }
+    static void Store(int32_t* p, Reg v) { _mm512_storeu_si512(p, v); }
+    static void StorePartial(int32_t* p, Reg v, size_t n) {
+        _mm512_mask_storeu_epi32(p, Mask16(n), v);
+    }
+    static Reg Set1(int32_t x) { return _mm512_set1_epi32(x); }
+    static Reg Add(Reg a, Reg b) { return _mm512_add_epi32(a, b); }
+    static Reg Sub(Reg a, Reg b) { return _mm512_sub_epi32(a, b); }
+    static Reg Mul(Reg a, Reg b) { return _mm512_mullo_epi32(a, b); }
+    // there is no vector integer division
+    static Reg Div(Reg a, Reg b) {
+        alignas(64) int32_t x[16];
+        alignas(64) int32_t y[16];
+        _mm512_store_si512(x, a);
+        _mm512_store_si512(y, b);
+        for (int i = 0; i < 16; ++i) { x[i] = DivInt(x[i], y[i]); }
+        return _mm512_load_si512(x);
+    }
+    static Reg Fma(Reg a, Reg b, Reg c) { return Add(Mul(a, b), c); }
+    static Reg Min(Reg a, Reg b) { return _mm512_min_epi32(a, b); }
+    static Reg Max(Reg a, Reg b) { return _mm512_max_epi32(a, b); }
+};
+
+constexpr SpanKernels kAvx512Kernels =
+        MakeSpanKernels<Avx512F32, Avx512F64, Avx512I32>();
+
+}  // namespace
+
+const SpanKernels* SpanKernelsAvx512() { return &kAvx512Kernels; }
+
+}  // namespace cudamgr
+}  // namespace dexsim
+
+#else
+
+namespace dexsim {
+namespace cudamgr {
+
+const SpanKernels* SpanKernelsAvx512() { return nullptr; }
+
+}  // namespace cudamgr
+}  // namespace dexsim
+
+#endif
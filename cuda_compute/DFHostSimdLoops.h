@@ -0,0 +1,92 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) 2021-2025 DexForce Technology Co., Ltd.
+//
+// All rights reserved.
+// ----------------------------------------------------------------------------
+#pragma once
+// Span loops shared by DFHostSimdScalar/Avx2/Avx512.cpp. Each of them is built
+// for a different instruction set, so everything here lives in an unnamed
+// namespace: no inline function compiled with AVX may be merged with the copy
+// of another translation unit by the linker. For the same reason these
+// translation units include no standard headers beyond the C ones.
+#include "DFHostSimd.h"
+
+namespace dexsim {
+namespace cudamgr {
+namespace {
+
+// Integer division without traps, identical in every instruction set.
+inline int32_t DivInt(int32_t a, int32_t b) {
+    if (b == 0) return 0;
+    // INT_MIN / -1 overflows, wrap around like the other operations
+    if (b == -1) return static_cast<int32_t>(0u - static_cast<uint32_t>(a));
+    return a / b;
+}
+
+// V describes the vector registers of an instruction set for one element
+// type: Reg, Scalar, kWidth and the operations below. Partial loads read the
+// first n lanes and zero the others, partial stores write the first n lanes.
+template <typename V, ElementwiseOp Op>
+typename V::Reg ApplyOp(const typename V::Reg* in) {
+    if constexpr (Op == OP_ADD) return V::Add(in[0], in[1]);
+    if constexpr (Op == OP_SUB) return V::Sub(in[0], in[1]);
+    if constexpr (Op == OP_MUL) return V::Mul(in[0], in[1]);
+    if constexpr (Op == OP_DIV) return V::Div(in[0], in[1]);
+    if constexpr (Op == OP_FMA) return V::Fma(in[0], in[1], in[2]);
+    if constexpr (Op == OP_CLAMP) {
+        return V::Min(V::Max(in[0], in[1]), in[2]);
+    }
+    if constexpr (Op == OP_LERP) {
+        // the way Warp spells lerp, with the last product fused
+        auto one_minus_t = V::Sub(V::Set1(1), in[2]);
+        return V::Fma(in[1], in[2], V::Mul(in[0], one_minus_t));
+    }
+}
+
+template <typename V, ElementwiseOp Op>
+void SpanLoop(const typename V::Scalar* const* src,
+              typename V::Scalar* dest,
+              size_t n) {
+    constexpr int arity = ElementwiseArity(Op);
+    typename V::Reg in[3];
+    size_t i = 0;
+    for (; i + V::kWidth <= n; i += V::kWidth) {
+        for (int k = 0; k < arity; ++k) { in[k] = V::Load(src[k] + i); }
+        V::Store(dest + i, ApplyOp<V, Op>(in));
+    }
+    // the tail is one masked step instead of a scalar loop, so every element
+    // is computed by the same instructions
+    if (i < n) {
+        size_t rest = n - i;
+        for (int k = 0; k < arity; ++k) {
+            in[k] = V::LoadPartial(src[k] + i, rest);
+        }
+        V::StorePartial(dest + i, ApplyOp<V, Op>(in), rest);
+    }
+}
+
+template <typename V, bool Floating>
+constexpr void FillSpanKernels(SpanKernel<typename V::Scalar>* table) {
+    table[OP_ADD] = &SpanLoop<V, OP_ADD>;
+    table[OP_SUB] = &SpanLoop<V, OP_SUB>;
+    table[OP_MUL] = &SpanLoop<V, OP_MUL>;
+    table[OP_DIV] = &SpanLoop<V, OP_DIV>;
+    table[OP_FMA] = &SpanLoop<V, OP_FMA>;
+    table[OP_CLAMP] = &SpanLoop<V, OP_CLAMP>;
+    if constexpr (Floating) table[OP_LERP] = &SpanLoop<V, OP_LERP>;
+}
+
+// The table of an instruction set, constant initialized so that taking it
+// runs no code of that set.
+template <typename F32, typename F64, typename I32>
+constexpr SpanKernels MakeSpanKernels() {
+    SpanKernels kernels{};
+    FillSpanKernels<F32, true>(kernels.f32);
+    FillSpanKernels<F64, true>(kernels.f64);
+    FillSpanKernels<I32, false>(kernels.i32);
+    return kernels;
+}
+
+}  // namespace
+}  // namespace cudamgr
+}  // namespace dexsim
@@ -0,0 +1,56 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) 2021-2025 DexForce Technology Co., Ltd.
+//
+// All rights reserved.
+// ----------------------------------------------------------------------------
+#include <cmath>
+
+#include "DFHostSimdLoops.h"
+
+namespace dexsim {
+namespace cudamgr {
+
+namespace {
+
+// One element per step, the reference the vector paths are checked against.
+template <typename T>
+struct ScalarVec {
+    using Scalar = T;
+    using Reg = T;
+    static constexpr size_t kWidth = 1;
+
+    static Reg Load(const T* p) { return *p; }
+    static Reg LoadPartial(const T* p, size_t) { return *p; }
+    static void Store(T* p, Reg v) { *p = v; }
+    static void StorePartial(T* p, Reg v, size_t) { *p = v; }
+    static Reg Set1(T x) { return x; }
+    static Reg Add(Reg a, Reg b) { return a + b; }
+    static Reg Sub(Reg a, Reg b) { return a - b; }
+    static Reg Mul(Reg a, Reg b) { return a * b; }
+    static Reg Div(Reg a, Reg b) { return a / b; }
+    static Reg Fma(Reg a, Reg b, Reg c) { return std::fma(a, b, c); }
+    // operand order as in MINPS/MAXPS, so NaN and signed zeros come out the
+    // same as in the vector paths
+    static Reg Min(Reg a, Reg b) { return a < b ? a : b; }
+    static Reg Max(Reg a, Reg b) { return a > b ? a : b; }
+};
+
+// integer arithmetic wraps around like the vector instructions
+struct ScalarI32 : ScalarVec<int32_t> {
+    static uint32_t U(int32_t x) { return static_cast<uint32_t>(x); }
+    static Reg Add(Reg a, Reg b) { return static_cast<int32_t>(U(a) + U(b)); }
+    static Reg Sub(Reg a, Reg b) { return static_cast<int32_t>(U(a) - U(b)); }
+    static Reg Mul(Reg a, Reg b) { return static_cast<int32_t>(U(a) * U(b)); }
+    static Reg Div(Reg a, Reg b) { return DivInt(a, b); }
+    static Reg Fma(Reg a, Reg b, Reg c) { return Add(Mul(a, b), c); }
+};
+
+constexpr SpanKernels kScalarKernels =
+        MakeSpanKernels<ScalarVec<float>, ScalarVec<double>, ScalarI32>();
+
+}  // namespace
+
+const SpanKernels* SpanKernelsScalar() { return &kScalarKernels; }
+
+}  // namespace cudamgr
+}  // namespace dexsim
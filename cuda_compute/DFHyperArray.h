@@ -3,14 +3,18 @@
 //
 // All rights reserved.
 // ----------------------------------------------------------------------------
+#pragma once
+#include <atomic>
+
+#include "DFComputeType.h"
 #include "DFCudaCodes.h"
+#include "DFEventPool.h"
 
 #define HYPER_ARRAY_MAX_DIMS 4
 namespace dexsim {
 namespace cudamgr {
 using HyperArrayHook = void*;
 
-// TODO: implement Reshape
 struct ArrayShape {
     size_t dims[HYPER_ARRAY_MAX_DIMS];
 
@@ -20,24 +24,108 @@ struct ArrayShape {
     inline size_t& operator[](size_t i) { return dims[i]; }
 };
 
+// Which copies of a HyperArray hold its current contents. Bit 0 stands for the
+// host copy, bit 1 for the device copy.
+enum ArrayValidity : unsigned char {
+    ARRAY_INVALID = 0,
+    ARRAY_HOST_VALID = 1,
+    ARRAY_DEVICE_VALID = 2,
+    ARRAY_BOTH_VALID = 3,
+};
+
+// ArrayValidity bits that views copy along with the rest of the header.
+// Threads syncing different views of one storage, e.g. one environment each,
+// update the bits of the shared root concurrently.
+struct AtomicValidity : std::atomic<unsigned char> {
+    AtomicValidity(unsigned char valid = ARRAY_INVALID)
+        : std::atomic<unsigned char>(valid) {}
+    AtomicValidity(const AtomicValidity& other)
+        : std::atomic<unsigned char>(other.load()) {}
+    AtomicValidity& operator=(const AtomicValidity& other) {
+        store(other.load());
+        return *this;
+    }
+    using std::atomic<unsigned char>::operator=;
+};
+
+// Signal token of an asynchronous copy into or out of an array's storage that
+// nobody has waited for yet, kNoSignal if there is none.
+struct AtomicSignal : std::atomic<SignalToken> {
+    AtomicSignal() : std::atomic<SignalToken>(kNoSignal) {}
+    AtomicSignal(const AtomicSignal& other)
+        : std::atomic<SignalToken>(other.load()) {}
+    AtomicSignal& operator=(const AtomicSignal& other) {
+        store(other.load());
+        return *this;
+    }
+    using std::atomic<SignalToken>::operator=;
+};
+
+// References to an array header: its owner, HyperArrayRef copies and the
+// views whose root it is. A copied header is a new header with one owner.
+struct AtomicRefCount : std::atomic<int> {
+    AtomicRefCount() : std::atomic<int>(1) {}
+    AtomicRefCount(const AtomicRefCount&) : std::atomic<int>(1) {}
+    AtomicRefCount& operator=(const AtomicRefCount&) { return *this; }
+};
+
 template <typename T>
 struct SharedDataCPU {
     T* value_ = nullptr;
-    int semaphore_ = 1;
+    // owners of the storage, arrays sharing it and views
+    std::atomic<int> semaphore_{1};
     bool is_allocated_ = false;
+    // page-locked, transfers go straight to DMA
+    bool is_pinned_ = false;
 };
 
+// SharedDataGPU::stream_use_ of memory only used on the default stream, and
+// of memory used on more than one stream of the families
+constexpr int kNoStreamUse = -1;
+constexpr int kManyStreamUse = -2;
+
 struct SharedDataGPU {
     CUdeviceptr value_ = (CUdeviceptr) nullptr;
-    int semaphore_ = 1;
+    std::atomic<int> semaphore_{1};
+    // family stream of the launches and *Async copies using the memory, see
+    // NoteStreamUse; freeing it waits for that stream as well
+    std::atomic<int> stream_use_{kNoStreamUse};
     bool is_allocated_ = false;
+    // wraps memory owned by someone else, it is never freed by the manager
+    bool is_external_ = false;
 };
 
+// Everything about a HyperArray that does not depend on its element type.
+// Launches, graphs and views work on this part, so that arrays of different
+// element types can be passed together.
+struct HyperArrayBase {
+    SharedDataGPU* gpu_data_ = nullptr;
+    ArrayShape shape_;
+    size_t strides_[HYPER_ARRAY_MAX_DIMS];
+    size_t ndim_;
+    size_t size_;
+    // kept up to date by the manager, syncs towards a valid copy are skipped
+    AtomicValidity valid_;
+    // the last *Async copy, blocking accesses wait for it before trusting
+    // valid_ or touching the host storage
+    AtomicSignal pending_copy_;
+    DType dtype_ = DTYPE_UNKNOWN;
+    // views: bytes from the start of the shared storage to the first element,
+    // and the array owning that storage, whose valid_ the view shares
+    size_t offset_ = 0;
+    HyperArrayBase* root_ = nullptr;
+    // the header and its storage references are released at zero
+    AtomicRefCount refs_;
+};
+
+// HyperArray<T> derives from nothing but HyperArrayBase, so a HyperArrayHook
+// also points at the HyperArrayBase of the array.
 template <typename T>
-struct HyperArray {
+struct HyperArray : HyperArrayBase {
     HyperArray(size_t dim0) {
         shape_[0] = dim0;
         ndim_ = 1;
+        dtype_ = DTypeOf<T>::value;
         strides_[0] = sizeof(T);
         strides_[1] = 0;
         strides_[2] = 0;
@@ -48,6 +136,7 @@ struct HyperArray {
         shape_[0] = dim0;
         shape_[1] = dim1;
         ndim_ = 2;
+        dtype_ = DTypeOf<T>::value;
         strides_[0] = sizeof(T) * dim1;
         strides_[1] = sizeof(T);
         strides_[2] = 0;
@@ -59,6 +148,7 @@ struct HyperArray {
         shape_[1] = dim1;
         shape_[2] = dim2;
         ndim_ = 3;
+        dtype_ = DTypeOf<T>::value;
         strides_[0] = sizeof(T) * dim1 * dim2;
         strides_[1] = sizeof(T) * dim2;
         strides_[2] = sizeof(T);
@@ -71,6 +161,7 @@ struct HyperArray {
         shape_[2] = dim2;
         shape_[3] = dim3;
         ndim_ = 4;
+        dtype_ = DTypeOf<T>::value;
         strides_[0] = sizeof(T) * dim1 * dim2 * dim3;
         strides_[1] = sizeof(T) * dim2 * dim3;
         strides_[2] = sizeof(T) * dim3;
@@ -79,12 +170,126 @@ struct HyperArray {
     }
 
     SharedDataCPU<T>* cpu_data_ = nullptr;
-    SharedDataGPU* gpu_data_ = nullptr;
-    ArrayShape shape_;
-    size_t strides_[HYPER_ARRAY_MAX_DIMS];
-    size_t ndim_;
-    size_t size_;
 };
 
+// Device address of the first element of an array or view
+inline CUdeviceptr DeviceDataOf(const HyperArrayBase* array) {
+    return array->gpu_data_->value_ + array->offset_;
+}
+
+// Host address of the first element of an array or view
+template <typename T>
+T* HostPtrOf(const HyperArray<T>* array) {
+    return reinterpret_cast<T*>(
+            reinterpret_cast<char*>(array->cpu_data_->value_) +
+            array->offset_);
+}
+
+// Host storage of a HyperArray<T> seen through its HyperArrayBase
+template <typename T>
+void* HostDataOf(const HyperArrayBase* array) {
+    auto* typed = static_cast<const HyperArray<T>*>(array);
+    return typed->cpu_data_ == nullptr ? nullptr : HostPtrOf(typed);
+}
+
+// Validity of an array, views read the one of the array they alias.
+inline unsigned char ValidityOf(const HyperArrayBase* array) {
+    return array->root_ != nullptr ? array->root_->valid_ : array->valid_;
+}
+
+// Records that only the given copies hold the current contents. Validity is
+// tracked for the storage as a whole, so an update through a view, which only
+// covers part of it, can take copies away but never add them.
+inline void SetValidity(HyperArrayBase* array, unsigned char copies) {
+    if (array->root_ == nullptr) {
+        array->valid_ = copies;
+    } else {
+        array->root_->valid_ &= copies;
+    }
+}
+
+// Storage header holding the pending copy of an array, views share the one of
+// the array they alias.
+inline AtomicSignal& PendingCopyOf(HyperArrayBase* array) {
+    return array->root_ != nullptr ? array->root_->pending_copy_
+                                   : array->pending_copy_;
+}
+
+// Records that work using the device memory of an array was enqueued on a
+// stream. The common case, a stream that used it before, only reads.
+inline void NoteStreamUse(HyperArrayBase* array,
+                          int stream_type,
+                          int stream_id) {
+    if (stream_type < 0 || array->gpu_data_ == nullptr) return;
+    int use = (stream_type << 24) | stream_id;
+    std::atomic<int>& last = array->gpu_data_->stream_use_;
+    int seen = last.load(std::memory_order_relaxed);
+    if (seen == use || seen == kManyStreamUse) return;
+    if (seen == kNoStreamUse && last.compare_exchange_strong(seen, use)) {
+        return;
+    }
+    if (seen != use) last.store(kManyStreamUse);
+}
+
+// the stream family and id NoteStreamUse packed into stream_use_
+inline int StreamUseType(int use) { return use >> 24; }
+inline int StreamUseId(int use) { return use & 0xffffff; }
+
+// true if the elements of an array are packed in row-major order without
+// gaps. Arrays are created that way; transposed and sliced views are not.
+inline bool IsContiguous(const HyperArrayBase* array, size_t element_size) {
+    size_t expected = element_size;
+    for (size_t i = array->ndim_; i-- > 0;) {
+        if (array->shape_[i] != 1 && array->strides_[i] != expected) {
+            return false;
+        }
+        expected *= array->shape_[i];
+    }
+    return true;
+}
+
+// Splits the elements of a strided array into blocks of `height` rows of
+// `width` packed bytes, the rows `pitch` bytes apart, i.e. into 2D copies.
+// Trailing dimensions without gaps are folded into the rows. Calls
+// fn(offset, packed_offset, width, height, pitch) per block, offset counting
+// from the first element of the array and packed_offset from the start of a
+// packed copy of it.
+template <typename F>
+void ForEachCopyBlock(const HyperArrayBase* array,
+                      size_t element_size,
+                      F&& fn) {
+    if (array->size_ == 0) return;
+    int dim = static_cast<int>(array->ndim_) - 1;
+    size_t width = element_size;
+    while (dim >= 0 && (array->shape_[dim] == 1 ||
+                        array->strides_[dim] == width)) {
+        width *= array->shape_[dim];
+        --dim;
+    }
+    size_t height = 1;
+    size_t pitch = width;
+    if (dim >= 0) {
+        height = array->shape_[dim];
+        pitch = array->strides_[dim];
+        --dim;
+    }
+    size_t blocks = 1;
+    for (int i = 0; i <= dim; ++i) { blocks *= array->shape_[i]; }
+    for (size_t block = 0; block < blocks; ++block) {
+        size_t offset = 0;
+        size_t index = block;
+        for (int i = dim; i >= 0; --i) {
+            offset += (index % array->shape_[i]) * array->strides_[i];
+            index /= array->shape_[i];
+        }
+        fn(offset, block * width * height, width, height, pitch);
+    }
+}
+
+// Type-erased view of a HyperArrayHook
+inline HyperArrayBase* ToArrayBase(HyperArrayHook arr) {
+    return static_cast<HyperArrayBase*>(arr);
+}
+
 }  // namespace cudamgr
 }  // namespace dexsim
\ No newline at end of file
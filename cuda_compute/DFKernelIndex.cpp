@@ -0,0 +1,344 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) 2021-2025 DexForce Technology Co., Ltd.
+//
+// All rights reserved.
+// ----------------------------------------------------------------------------
+#include "DFKernelIndex.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+
+#if defined(__unix__) || defined(__unix)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace dexsim {
+namespace cudamgr {
+
+namespace {
+constexpr char kIndexMagic[4] = {'D', 'F', 'K', 'I'};
+// 2 added the source table
+constexpr uint32_t kIndexVersion = 2;
+
+std::string Trim(const std::string& line) {
+    size_t begin = line.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos) return std::string();
+    size_t end = line.find_last_not_of(" \t\r\n");
+    return line.substr(begin, end - begin + 1);
+}
+
+// size and modification time of a file, false if it cannot be read
+bool StatFile(const std::filesystem::path& path,
+              uint64_t* size,
+              int64_t* mtime) {
+    std::error_code ec;
+    *size = std::filesystem::file_size(path, ec);
+    if (ec) return false;
+    auto time = std::filesystem::last_write_time(path, ec);
+    if (ec) return false;
+    *mtime = static_cast<int64_t>(time.time_since_epoch().count());
+    return true;
+}
+}  // namespace
+
+uint64_t HashBytes(const void* data, size_t size) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    uint64_t hash = 1469598103934665603ull;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+bool KernelIndex::Build(const std::filesystem::path& kernel_dir,
+                        const std::filesystem::path& output,
+                        size_t* num_kernels) {
+    std::error_code ec;
+    std::vector<std::filesystem::path> luts;
+    for (const auto& entry :
+         std::filesystem::recursive_directory_iterator(kernel_dir, ec)) {
+        if (entry.path().filename() == "CoreLUT.txt") {
+            luts.push_back(entry.path());
+        }
+    }
+    // the same order on every machine, later files win like in ProcessFile
+    std::sort(luts.begin(), luts.end());
+
+    std::filesystem::path base = output.parent_path();
+    std::map<std::string, std::string> modules;  // type -> relative ptx path
+    std::map<std::string, std::pair<std::string, std::string>> kernels;
+    for (const auto& lut : luts) {
+        std::ifstream file(lut);
+        std::string line;
+        std::string type;
+        while (std::getline(file, line)) {
+            line = Trim(line);
+            if (line.empty()) continue;
+            size_t space = line.find(' ');
+            if (space != std::string::npos) {
+                type = line.substr(0, space);
+                modules[type] = (lut.parent_path() / (type + ".ptx"))
+                                        .lexically_relative(base)
+                                        .generic_string();
+            }
+            size_t colon = line.find(':');
+            if (colon != std::string::npos && !type.empty()) {
+                kernels[line.substr(0, colon)] = {type,
+                                                  line.substr(colon + 1)};
+            }
+        }
+    }
+
+    std::string strings;
+    auto add_string = [&strings](const std::string& value) {
+        uint32_t offset = static_cast<uint32_t>(strings.size());
+        strings.append(value);
+        strings.push_back('\0');
+        return offset;
+    };
+    std::vector<IndexModule> module_table;
+    std::map<std::string, uint32_t> module_ids;
+    for (const auto& module : modules) {
+        module_ids[module.first] = static_cast<uint32_t>(module_table.size());
+        module_table.push_back(
+                {add_string(module.first), add_string(module.second)});
+    }
+    std::vector<IndexSource> source_table;
+    for (const auto& lut : luts) {
+        IndexSource source;
+        if (!StatFile(lut, &source.size, &source.mtime)) continue;
+        source.path =
+                add_string(lut.lexically_relative(base).generic_string());
+        source.reserved = 0;
+        source_table.push_back(source);
+    }
+    std::vector<IndexKernel> kernel_table;
+    for (const auto& kernel : kernels) {
+        IndexKernel entry;
+        entry.hash = HashBytes(kernel.first.data(), kernel.first.size());
+        entry.name = add_string(kernel.first);
+        entry.module = module_ids[kernel.second.first];
+        entry.symbol = add_string(kernel.second.second);
+        entry.reserved = 0;
+        kernel_table.push_back(entry);
+    }
+    std::sort(kernel_table.begin(), kernel_table.end(),
+              [&strings](const IndexKernel& a, const IndexKernel& b) {
+                  if (a.hash != b.hash) return a.hash < b.hash;
+                  return std::strcmp(strings.c_str() + a.name,
+                                     strings.c_str() + b.name) < 0;
+              });
+
+    IndexHeader header;
+    std::memcpy(header.magic, kIndexMagic, sizeof(kIndexMagic));
+    header.version = kIndexVersion;
+    header.module_count = static_cast<uint32_t>(module_table.size());
+    header.kernel_count = static_cast<uint32_t>(kernel_table.size());
+    header.source_count = static_cast<uint32_t>(source_table.size());
+    header.reserved = 0;
+    header.strings_offset = sizeof(IndexHeader) +
+                            module_table.size() * sizeof(IndexModule) +
+                            kernel_table.size() * sizeof(IndexKernel) +
+                            source_table.size() * sizeof(IndexSource);
+    header.strings_size = strings.size();
+
+    std::filesystem::path tmp = output;
+    tmp += ".tmp" + std::to_string(std::chrono::steady_clock::now()
+                                           .time_since_epoch()
+                                           .count());
+    {
+        std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "Warning: Failed to write kernel index: " << tmp
+                      << std::endl;
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(module_table.data()),
+                   module_table.size() * sizeof(IndexModule));
+        file.write(reinterpret_cast<const char*>(kernel_table.data()),
+                   kernel_table.size() * sizeof(IndexKernel));
+        file.write(reinterpret_cast<const char*>(source_table.data()),
+                   source_table.size() * sizeof(IndexSource));
+        file.write(strings.data(), strings.size());
+        if (!file.good()) {
+            file.close();
+            std::filesystem::remove(tmp, ec);
+            return false;
+        }
+    }
+    std::filesystem::rename(tmp, output, ec);
+    if (ec) {
+        std::cerr << "Warning: Failed to replace kernel index: " << output
+                  << ", " << ec.message() << std::endl;
+        std::filesystem::remove(tmp, ec);
+        return false;
+    }
+    if (num_kernels != nullptr) *num_kernels = kernel_table.size();
+    return true;
+}
+
+KernelIndex::~KernelIndex() { Close(); }
+
+void KernelIndex::Close() {
+#if defined(__unix__) || defined(__unix)
+    if (mapped_) munmap(const_cast<char*>(data_), size_);
+#endif
+    data_ = nullptr;
+    size_ = 0;
+    mapped_ = false;
+    buffer_.clear();
+}
+
+bool KernelIndex::Open(const std::filesystem::path& path) {
+    Close();
+#if defined(__unix__) || defined(__unix)
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        void* data = mmap(nullptr, static_cast<size_t>(info.st_size),
+                          PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED) {
+            data_ = static_cast<const char*>(data);
+            size_ = static_cast<size_t>(info.st_size);
+            mapped_ = true;
+        }
+    }
+    ::close(fd);
+#else
+    std::ifstream file(path, std::ios::binary);
+    if (file.is_open()) {
+        buffer_.assign(std::istreambuf_iterator<char>(file),
+                       std::istreambuf_iterator<char>());
+        if (!buffer_.empty()) {
+            data_ = buffer_.data();
+            size_ = buffer_.size();
+        }
+    }
+#endif
+    if (data_ == nullptr) return false;
+
+    const IndexHeader* header = Header();
+    bool valid = size_ >= sizeof(IndexHeader) &&
+                 std::memcmp(header->magic, kIndexMagic,
+                             sizeof(kIndexMagic)) == 0 &&
+                 header->version == kIndexVersion &&
+                 header->strings_offset ==
+                         sizeof(IndexHeader) +
+                                 header->module_count * sizeof(IndexModule) +
+                                 header->kernel_count * sizeof(IndexKernel) +
+                                 header->source_count * sizeof(IndexSource) &&
+                 header->strings_offset + header->strings_size <= size_ &&
+                 header->strings_size > 0 &&
+                 data_[header->strings_offset + header->strings_size - 1] ==
+                         '\0';
+    if (!valid) {
+        std::cerr << "Warning: Ignoring invalid kernel index: " << path
+                  << std::endl;
+        Close();
+        return false;
+    }
+    base_ = path.parent_path();
+
+    std::filesystem::path changed = ChangedSource();
+    if (!changed.empty()) {
+        std::cerr << "Warning: Ignoring kernel index " << path << ", "
+                  << changed << " changed or was removed since it was "
+                  << "built. Rerun df_kernel_index to update it."
+                  << std::endl;
+        Close();
+        return false;
+    }
+    return true;
+}
+
+std::filesystem::path KernelIndex::ChangedSource() const {
+    const IndexSource* sources = Sources();
+    for (uint32_t i = 0; i < Header()->source_count; ++i) {
+        std::filesystem::path lut = base_ / String(sources[i].path);
+        uint64_t size = 0;
+        int64_t mtime = 0;
+        if (!StatFile(lut, &size, &mtime) || size != sources[i].size ||
+            mtime != sources[i].mtime) {
+            return lut;
+        }
+    }
+    return std::filesystem::path();
+}
+
+const KernelIndex::IndexHeader* KernelIndex::Header() const {
+    return reinterpret_cast<const IndexHeader*>(data_);
+}
+
+const KernelIndex::IndexModule* KernelIndex::Modules() const {
+    return reinterpret_cast<const IndexModule*>(data_ + sizeof(IndexHeader));
+}
+
+const KernelIndex::IndexKernel* KernelIndex::Kernels() const {
+    return reinterpret_cast<const IndexKernel*>(
+            data_ + sizeof(IndexHeader) +
+            Header()->module_count * sizeof(IndexModule));
+}
+
+const KernelIndex::IndexSource* KernelIndex::Sources() const {
+    return reinterpret_cast<const IndexSource*>(
+            reinterpret_cast<const char*>(Kernels()) +
+            Header()->kernel_count * sizeof(IndexKernel));
+}
+
+const char* KernelIndex::String(uint32_t offset) const {
+    if (offset >= Header()->strings_size) return "";
+    return data_ + Header()->strings_offset + offset;
+}
+
+bool KernelIndex::Find(const char* name,
+                       uint32_t* module,
+                       const char** symbol) const {
+    if (!IsOpen()) return false;
+    uint64_t hash = HashBytes(name, std::strlen(name));
+    const IndexKernel* begin = Kernels();
+    const IndexKernel* end = begin + Header()->kernel_count;
+    const IndexKernel* it = std::lower_bound(
+            begin, end, hash,
+            [](const IndexKernel& kernel, uint64_t value) {
+                return kernel.hash < value;
+            });
+    for (; it != end && it->hash == hash; ++it) {
+        if (std::strcmp(String(it->name), name) != 0) continue;
+        if (it->module >= Header()->module_count) return false;
+        *module = it->module;
+        *symbol = String(it->symbol);
+        return true;
+    }
+    return false;
+}
+
+uint32_t KernelIndex::ModuleCount() const {
+    return IsOpen() ? Header()->module_count : 0;
+}
+
+size_t KernelIndex::KernelCount() const {
+    return IsOpen() ? Header()->kernel_count : 0;
+}
+
+const char* KernelIndex::ModuleName(uint32_t module) const {
+    if (module >= ModuleCount()) return "";
+    return String(Modules()[module].name);
+}
+
+std::filesystem::path KernelIndex::ModulePath(uint32_t module) const {
+    if (module >= ModuleCount()) return std::filesystem::path();
+    return base_ / String(Modules()[module].path);
+}
+
+}  // namespace cudamgr
+}  // namespace dexsim
@@ -0,0 +1,128 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) 2021-2025 DexForce Technology Co., Ltd.
+//
+// All rights reserved.
+// ----------------------------------------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace dexsim {
+namespace cudamgr {
+
+// 64-bit FNV-1a hash, stable across runs and platforms
+uint64_t HashBytes(const void* data, size_t size);
+
+/// \brief Prebuilt, memory-mapped index of a kernel directory.
+///
+/// Build compiles every CoreLUT.txt below a directory into one file holding a
+/// table of modules and a table of kernels sorted by name hash, each kernel
+/// pointing at its module and symbol. Open maps that file, so a lookup is a
+/// binary search over the mapped table and startup does no parsing at all.
+///
+/// The index also records the size and modification time of every
+/// CoreLUT.txt it was built from. Open rejects it once one of them changed
+/// or is gone, so the caller falls back to parsing; CoreLUT.txt files added
+/// after the build are not noticed.
+///
+/// Layout: IndexHeader, module_count IndexModule, kernel_count IndexKernel,
+/// source_count IndexSource, then the null-terminated strings the tables
+/// point into.
+class KernelIndex {
+public:
+    /// File name the manager looks for in the kernel directory
+    static constexpr const char* kFileName = "KernelIndex.bin";
+
+    /// \brief Compiles the CoreLUT.txt files below kernel_dir into an index
+    ///
+    /// \param kernel_dir Directory searched recursively for CoreLUT.txt
+    /// \param output Index file to write, replaced atomically
+    /// \param num_kernels Receives the number of indexed kernels if not null
+    /// \return false if the index could not be written
+    static bool Build(const std::filesystem::path& kernel_dir,
+                      const std::filesystem::path& output,
+                      size_t* num_kernels = nullptr);
+
+    KernelIndex() = default;
+    ~KernelIndex();
+
+    KernelIndex(const KernelIndex&) = delete;
+    KernelIndex& operator=(const KernelIndex&) = delete;
+
+    /// \brief Maps an index written by Build
+    ///
+    /// \return false if the file is missing, not a valid index, or older than
+    /// one of its CoreLUT.txt files
+    bool Open(const std::filesystem::path& path);
+    bool IsOpen() const { return data_ != nullptr; }
+
+    /// \brief Looks up a kernel by name
+    ///
+    /// \param name Kernel name as listed in CoreLUT.txt
+    /// \param module Receives the module id of the kernel
+    /// \param symbol Receives the function name inside the module, valid
+    /// while the index is open
+    /// \return false if the kernel is not indexed
+    bool Find(const char* name, uint32_t* module, const char** symbol) const;
+
+    uint32_t ModuleCount() const;
+    size_t KernelCount() const;
+    /// \brief Module type of a module id, e.g. "add" for add.ptx
+    const char* ModuleName(uint32_t module) const;
+    /// \brief PTX file of a module id
+    std::filesystem::path ModulePath(uint32_t module) const;
+
+private:
+    struct IndexHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t module_count;
+        uint32_t kernel_count;
+        uint32_t source_count;
+        uint32_t reserved;
+        uint64_t strings_offset;
+        uint64_t strings_size;
+    };
+    // offsets into the string table
+    struct IndexModule {
+        uint32_t name;
+        uint32_t path;  // relative to the directory of the index
+    };
+    struct IndexKernel {
+        uint64_t hash;
+        uint32_t name;
+        uint32_t module;
+        uint32_t symbol;
+        uint32_t reserved;
+    };
+    // a CoreLUT.txt the index was built from
+    struct IndexSource {
+        uint32_t path;  // relative to the directory of the index
+        uint32_t reserved;
+        uint64_t size;
+        int64_t mtime;  // file clock ticks, only compared for equality
+    };
+
+    const IndexHeader* Header() const;
+    const IndexModule* Modules() const;
+    const IndexKernel* Kernels() const;
+    const IndexSource* Sources() const;
+    // the first source that changed since the build, empty if none did
+    std::filesystem::path ChangedSource() const;
+    const char* String(uint32_t offset) const;
+    void Close();
+
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    bool mapped_ = false;
+    // holds the file where memory mapping is not available
+    std::vector<char> buffer_;
+    std::filesystem::path base_;
+};
+
+}  // namespace cudamgr
+}  // namespace dexsim
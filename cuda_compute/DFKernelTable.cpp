@@ -0,0 +1,96 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) 2021-2025 DexForce Technology Co., Ltd.
+//
+// All rights reserved.
+// ----------------------------------------------------------------------------
+#include "DFKernelTable.h"
+
+#include "DFKernelIndex.h"
+
+namespace dexsim {
+namespace cudamgr {
+
+KernelTable::~KernelTable() {
+    for (auto& chunk : chunks_) { delete[] chunk.load(); }
+}
+
+const KernelTable::Entry* KernelTable::At(int handle) const {
+    const Entry* chunk =
+            chunks_[handle >> kChunkBits].load(std::memory_order_acquire);
+    return chunk + (handle & (kChunkSize - 1));
+}
+
+int KernelTable::Find(std::string_view name) const {
+    const Index* index = index_.load(std::memory_order_acquire);
+    if (index == nullptr) return -1;
+    uint64_t hash = HashBytes(name.data(), name.size());
+    // the index is never full, so probing ends at an empty slot
+    for (size_t i = hash & index->mask;; i = (i + 1) & index->mask) {
+        int slot = index->slots[i].load(std::memory_order_acquire);
+        if (slot == 0) return -1;
+        const Entry* entry = At(slot - 1);
+        if (entry->hash == hash && entry->name == name) return slot - 1;
+    }
+}
+
+void KernelTable::Insert(Index* index, uint64_t hash, int handle) {
+    size_t i = hash & index->mask;
+    while (index->slots[i].load(std::memory_order_relaxed) != 0) {
+        i = (i + 1) & index->mask;
+    }
+    // publishes the entry to readers that find the slot
+    index->slots[i].store(handle + 1, std::memory_order_release);
+}
+
+int KernelTable::Add(std::string_view name, void* kernel) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int existing = Find(name);
+    if (existing != -1) return existing;
+
+    int handle = size_.load(std::memory_order_relaxed);
+    if (handle >= kMaxChunks * kChunkSize) return -1;
+    auto& chunk = chunks_[handle >> kChunkBits];
+    if (chunk.load(std::memory_order_relaxed) == nullptr) {
+        chunk.store(new Entry[kChunkSize], std::memory_order_release);
+    }
+    auto* entry = const_cast<Entry*>(At(handle));
+    entry->name.assign(name.data(), name.size());
+    entry->hash = HashBytes(name.data(), name.size());
+    entry->kernel = kernel;
+
+    Index* index = index_.load(std::memory_order_relaxed);
+    size_t needed = 2 * (static_cast<size_t>(handle) + 1);
+    if (index == nullptr || needed > index->mask + 1) {
+        // readers of the old index miss only the newest names and fall back
+        // to Add, which finds them here
+        size_t capacity = index == nullptr ? 64 : 2 * (index->mask + 1);
+        std::unique_ptr<Index> grown(new Index);
+        grown->mask = capacity - 1;
+        grown->slots.reset(new std::atomic<int>[capacity]);
+        for (size_t i = 0; i < capacity; ++i) {
+            grown->slots[i].store(0, std::memory_order_relaxed);
+        }
+        for (int i = 0; i < handle; ++i) {
+            Insert(grown.get(), At(i)->hash, i);
+        }
+        index = grown.get();
+        indexes_.push_back(std::move(grown));
+    }
+    Insert(index, entry->hash, handle);
+    index_.store(index, std::memory_order_release);
+    size_.store(handle + 1, std::memory_order_release);
+    return handle;
+}
+
+void* KernelTable::Kernel(int handle) const {
+    if (handle < 0 || handle >= Size()) return nullptr;
+    return At(handle)->kernel;
+}
+
+const char* KernelTable::Name(int handle) const {
+    if (handle < 0 || handle >= Size()) return nullptr;
+    return At(handle)->name.c_str();
+}
+
+}  // namespace cudamgr
+}  // namespace dexsim
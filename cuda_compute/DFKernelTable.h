@@ -0,0 +1,81 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) 2021-2025 DexForce Technology Co., Ltd.
+//
+// All rights reserved.
+// ----------------------------------------------------------------------------
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace dexsim {
+namespace cudamgr {
+
+/// \brief Kernel handles of a manager, mapping names to handles and handles
+/// to backend kernels.
+///
+/// Lookups are lock-free, so launches from many threads never contend on the
+/// table; only adding a kernel takes a lock. Entries are never removed or
+/// moved, a reader may keep using an entry without holding anything.
+class KernelTable {
+public:
+    KernelTable() = default;
+    ~KernelTable();
+
+    KernelTable(const KernelTable&) = delete;
+    KernelTable& operator=(const KernelTable&) = delete;
+
+    /// \brief Handle of a kernel name, -1 if it was never added
+    int Find(std::string_view name) const;
+
+    /// \brief Adds a kernel under a new handle
+    ///
+    /// \return The new handle, the existing one if another thread added the
+    /// name first, -1 if the table is full
+    int Add(std::string_view name, void* kernel);
+
+    /// \brief Backend kernel of a handle, nullptr for invalid handles
+    void* Kernel(int handle) const;
+
+    /// \brief Name of a handle, nullptr for invalid handles
+    const char* Name(int handle) const;
+
+    /// \brief Number of kernels in the table
+    int Size() const { return size_.load(std::memory_order_acquire); }
+
+private:
+    struct Entry {
+        std::string name;
+        uint64_t hash = 0;
+        void* kernel = nullptr;
+    };
+    // open addressing from name hashes to handle + 1, at most half full
+    struct Index {
+        size_t mask = 0;
+        std::unique_ptr<std::atomic<int>[]> slots;
+    };
+
+    static constexpr int kChunkBits = 8;
+    static constexpr int kChunkSize = 1 << kChunkBits;
+    static constexpr int kMaxChunks = 1024;
+
+    const Entry* At(int handle) const;
+    static void Insert(Index* index, uint64_t hash, int handle);
+
+    // entries live in fixed chunks that are allocated once and never moved
+    std::atomic<Entry*> chunks_[kMaxChunks] = {};
+    std::atomic<int> size_{0};
+    std::atomic<Index*> index_{nullptr};
+    // the current index and the ones it replaced, which readers may still
+    // be probing; all are freed with the table
+    std::vector<std::unique_ptr<Index>> indexes_;
+    std::mutex mutex_;
+};
+
+}  // namespace cudamgr
+}  // namespace dexsim
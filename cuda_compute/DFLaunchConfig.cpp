@@ -0,0 +1,139 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) 2021-2025 DexForce Technology Co., Ltd.
+//
+// All rights reserved.
+// ----------------------------------------------------------------------------
+#include "DFLaunchConfig.h"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace dexsim {
+namespace cudamgr {
+
+namespace {
+constexpr unsigned int kWarpSize = 32;
+
+size_t RoundUp(size_t value, size_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+}  // namespace
+
+int LaunchSizeBucket(size_t size) {
+    int bucket = 0;
+    while (size > 1) {
+        size >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+void ShapeLaunchBlock(unsigned int block_threads,
+                      size_t size,
+                      unsigned int block[3]) {
+    block[1] = block[2] = 1;
+    if (block_threads == 0) block_threads = 1;
+    // use the block whole unless the launch is small
+    size_t wanted = RoundUp(size == 0 ? 1 : size, kWarpSize);
+    block[0] = static_cast<unsigned int>(
+            wanted < block_threads ? wanted : block_threads);
+}
+
+bool LaunchConfigCache::Load(const std::filesystem::path& path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    path_ = path;
+    if (!std::filesystem::exists(path)) return true;
+
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Warning: Failed to open launch config cache: " << path
+                  << std::endl;
+        return false;
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream iss(line);
+        std::string kernel;
+        int ndim, bucket;
+        Block block;
+        if (!(iss >> kernel >> ndim >> bucket >> block.dims[0] >>
+              block.dims[1] >> block.dims[2])) {
+            continue;
+        }
+        entries_[Key(kernel, ndim, bucket)] = block;
+    }
+    return true;
+}
+
+bool LaunchConfigCache::Save() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (path_.empty()) return false;
+    std::error_code ec;
+    std::filesystem::create_directories(path_.parent_path(), ec);
+
+    // other processes may read or write the file at the same time, so write
+    // a private copy and move it over the old one
+    std::filesystem::path tmp = path_;
+    tmp += ".tmp" + std::to_string(std::chrono::steady_clock::now()
+                                           .time_since_epoch()
+                                           .count());
+    {
+        std::ofstream file(tmp, std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "Warning: Failed to write launch config cache: "
+                      << tmp << std::endl;
+            return false;
+        }
+        file << "# kernel ndim bucket block_x block_y block_z\n";
+        for (const auto& entry : entries_) {
+            file << std::get<0>(entry.first) << ' '
+                 << std::get<1>(entry.first) << ' '
+                 << std::get<2>(entry.first) << ' ' << entry.second.dims[0]
+                 << ' ' << entry.second.dims[1] << ' '
+                 << entry.second.dims[2] << '\n';
+        }
+        if (!file.good()) {
+            std::filesystem::remove(tmp);
+            return false;
+        }
+    }
+    std::filesystem::rename(tmp, path_, ec);
+    if (ec) {
+        std::cerr << "Warning: Failed to replace launch config cache: "
+                  << path_ << ", " << ec.message() << std::endl;
+        std::filesystem::remove(tmp, ec);
+        return false;
+    }
+    return true;
+}
+
+bool LaunchConfigCache::Find(const char* kernel,
+                             int ndim,
+                             int bucket,
+                             unsigned int block[3]) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(std::make_tuple(kernel, ndim, bucket));
+    if (it == entries_.end()) return false;
+    for (int i = 0; i < 3; ++i) { block[i] = it->second.dims[i]; }
+    return true;
+}
+
+void LaunchConfigCache::Store(const char* kernel,
+                              int ndim,
+                              int bucket,
+                              const unsigned int block[3]) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Block& entry = entries_[Key(kernel, ndim, bucket)];
+    for (int i = 0; i < 3; ++i) { entry.dims[i] = block[i]; }
+}
+
+size_t LaunchConfigCache::Size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+}  // namespace cudamgr
+}  // namespace dexsim
@@ -0,0 +1,76 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) 2021-2025 DexForce Technology Co., Ltd.
+//
+// All rights reserved.
+// ----------------------------------------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+namespace dexsim {
+namespace cudamgr {
+
+// Problem size bucket of a launch covering size elements, floor(log2(size)).
+// Tuned configurations are shared by all sizes of a bucket.
+int LaunchSizeBucket(size_t size);
+
+// Block of a launch covering size elements: block_threads threads along x,
+// or fewer for small launches, rounded up to whole warps. Warp kernels index
+// by the flattened x coordinate only, so y and z stay 1.
+void ShapeLaunchBlock(unsigned int block_threads,
+                      size_t size,
+                      unsigned int block[3]);
+
+/// \brief Block shapes found by autotuning, keyed by kernel name, launch
+/// dimensionality and problem size bucket.
+///
+/// The table is kept in a text file, one "kernel ndim bucket x y z" line per
+/// entry, which is rewritten by atomically replacing it. Lookups do not
+/// allocate, so they can sit on the launch path.
+class LaunchConfigCache {
+public:
+    /// \brief Reads the entries stored at path and remembers it for Save
+    ///
+    /// \return false if the file exists but cannot be read, a missing file
+    /// starts an empty table
+    bool Load(const std::filesystem::path& path);
+
+    /// \brief Writes every entry to the path given to Load
+    ///
+    /// \return false if there is no path or the file could not be replaced
+    bool Save() const;
+
+    /// \brief Block shape stored for a launch
+    ///
+    /// \return true if an entry exists, block is left untouched otherwise
+    bool Find(const char* kernel,
+              int ndim,
+              int bucket,
+              unsigned int block[3]) const;
+
+    /// \brief Adds or replaces the block shape of a launch
+    void Store(const char* kernel,
+               int ndim,
+               int bucket,
+               const unsigned int block[3]);
+
+    size_t Size() const;
+
+private:
+    struct Block {
+        unsigned int dims[3];
+    };
+    using Key = std::tuple<std::string, int, int>;
+
+    std::map<Key, Block, std::less<>> entries_;
+    std::filesystem::path path_;
+    mutable std::mutex mutex_;
+};
+
+}  // namespace cudamgr
+}  // namespace dexsim
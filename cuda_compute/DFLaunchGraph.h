@@ -0,0 +1,53 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) 2021-2025 DexForce Technology Co., Ltd.
+//
+// All rights reserved.
+// ----------------------------------------------------------------------------
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "DFWarpArgs.h"
+
+namespace dexsim {
+namespace cudamgr {
+
+// One launch or transfer recorded between BeginCapture and EndCapture.
+struct GraphOp {
+    enum Kind { KERNEL, COPY_TO_DEVICE, COPY_TO_HOST };
+    Kind kind = KERNEL;
+
+    // KERNEL: private copy of the launch, its arguments back the graph node
+    std::unique_ptr<BoundLaunch> launch;
+    // backend node of a kernel, the CUgraphNode on the CUDA backend
+    void* node = nullptr;
+    // the launch was repacked, the node needs its new parameters
+    bool dirty = false;
+
+    // COPY_*: the array whose device memory is copied
+    HyperArrayBase* array = nullptr;
+    // set if the host side is the array's own host storage, returns it
+    void* (*host_data)(const HyperArrayBase*) = nullptr;
+    void* host = nullptr;
+    CUdeviceptr device = 0;
+    size_t size = 0;
+    // validity of the array after the copy, -1 leaves it unchanged
+    int valid_after = -1;
+};
+
+// A recorded sequence of launches and transfers that is replayed as a whole.
+struct LaunchGraph {
+    int stream_type = -1;
+    int stream_id = -1;
+    std::vector<GraphOp> ops;
+    // something could not be captured, EndCapture discards the graph
+    bool failed = false;
+
+    // backend objects, CUgraph and CUgraphExec on the CUDA backend
+    void* graph = nullptr;
+    void* exec = nullptr;
+};
+
+}  // namespace cudamgr
+}  // namespace dexsim
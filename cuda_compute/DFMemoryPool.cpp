@@ -0,0 +1,311 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) 2021-2025 DexForce Technology Co., Ltd.
+//
+// All rights reserved.
+// ----------------------------------------------------------------------------
+#include "DFMemoryPool.h"
+
+namespace dexsim {
+namespace cudamgr {
+
+namespace {
+// every block is a multiple of this, it also keeps blocks 512-byte aligned
+constexpr size_t kMinBlockSize = 512;
+// requests up to this size share segments of kSmallSegmentSize
+constexpr size_t kSmallRequest = 1 << 20;
+constexpr size_t kSmallSegmentSize = 2 << 20;
+// larger requests get a dedicated segment rounded to this granularity
+constexpr size_t kLargeSegmentRound = 2 << 20;
+constexpr size_t kNumBins = 64;
+}  // namespace
+
+DeviceMemoryPool::DeviceMemoryPool(ICudaFunctionManager* cuda)
+    : cuda_(cuda), bins_(kNumBins) {}
+
+DeviceMemoryPool::~DeviceMemoryPool() {
+    for (auto& pending : pending_) {
+        cuda_->cuEventSynchronize(pending.event);
+        cuda_->cuEventDestroy(pending.event);
+        if (pending.stream_event != nullptr) {
+            cuda_->cuEventSynchronize(pending.stream_event);
+            cuda_->cuEventDestroy(pending.stream_event);
+        }
+    }
+    for (CUevent event : idle_events_) { cuda_->cuEventDestroy(event); }
+    for (Block* head : segments_) {
+        cuda_->cuMemFree(head->ptr);
+        Block* block = head;
+        while (block != nullptr) {
+            Block* next = block->next;
+            delete block;
+            block = next;
+        }
+    }
+}
+
+size_t DeviceMemoryPool::RoundSize(size_t size) {
+    if (size < kMinBlockSize) return kMinBlockSize;
+    return (size + kMinBlockSize - 1) / kMinBlockSize * kMinBlockSize;
+}
+
+size_t DeviceMemoryPool::BinIndex(size_t size) {
+    size_t index = 0;
+    while (size > 1 && index + 1 < kNumBins) {
+        size >>= 1;
+        ++index;
+    }
+    return index;
+}
+
+void DeviceMemoryPool::InsertFree(Block* block) {
+    bins_[BinIndex(block->size)].insert(block);
+}
+
+void DeviceMemoryPool::RemoveFree(Block* block) {
+    bins_[BinIndex(block->size)].erase(block);
+}
+
+DeviceMemoryPool::Block* DeviceMemoryPool::FindFreeBlock(size_t size) {
+    Block key;
+    key.size = size;
+    for (size_t bin = BinIndex(size); bin < kNumBins; ++bin) {
+        // best fit: the smallest cached block that is large enough
+        auto it = bins_[bin].lower_bound(&key);
+        if (it != bins_[bin].end()) {
+            Block* block = *it;
+            bins_[bin].erase(it);
+            return block;
+        }
+    }
+    return nullptr;
+}
+
+DeviceMemoryPool::Block* DeviceMemoryPool::CreateSegment(size_t size) {
+    size_t segment_size =
+            size <= kSmallRequest
+                    ? kSmallSegmentSize
+                    : (size + kLargeSegmentRound - 1) / kLargeSegmentRound *
+                              kLargeSegmentRound;
+
+    CUdeviceptr ptr = 0;
+    auto result = cuda_->cuMemAlloc(&ptr, segment_size);
+    if (result == CUDA_ERROR_OUT_OF_MEMORY) {
+        // cached but unused segments may be what is holding the memory
+        ReleaseFreeSegments();
+        result = cuda_->cuMemAlloc(&ptr, segment_size);
+    }
+    if (result != CUDA_SUCCESS) return nullptr;
+
+    Block* head = new Block;
+    head->ptr = ptr;
+    head->size = segment_size;
+    head->segment_size = segment_size;
+    segments_.push_back(head);
+    bytes_reserved_ += segment_size;
+    return head;
+}
+
+CUDA_CODES DeviceMemoryPool::Allocate(CUdeviceptr* ptr, size_t size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t rounded = RoundSize(size);
+
+    ReleasePending(false);
+    Block* block = FindFreeBlock(rounded);
+    if (block != nullptr) {
+        ++hits_;
+    } else {
+        ++misses_;
+        block = CreateSegment(rounded);
+        if (block == nullptr && !pending_.empty()) {
+            // out of memory, waiting for the blocks still in use is the last
+            // resort
+            ReleasePending(true);
+            block = FindFreeBlock(rounded);
+            if (block == nullptr) block = CreateSegment(rounded);
+        }
+        if (block == nullptr) return CUDA_ERROR_OUT_OF_MEMORY;
+    }
+
+    // split off the tail so it can serve later requests
+    if (block->size - rounded >= kMinBlockSize) {
+        Block* remainder = new Block;
+        remainder->ptr = block->ptr + rounded;
+        remainder->size = block->size - rounded;
+        remainder->prev = block;
+        remainder->next = block->next;
+        if (block->next != nullptr) block->next->prev = remainder;
+        block->next = remainder;
+        block->size = rounded;
+        InsertFree(remainder);
+    }
+
+    block->allocated = true;
+    allocated_[block->ptr] = block;
+    bytes_in_use_ += block->size;
+    *ptr = block->ptr;
+    return CUDA_SUCCESS;
+}
+
+CUevent DeviceMemoryPool::RecordEvent(CUstream stream) {
+    CUevent event = nullptr;
+    if (!idle_events_.empty()) {
+        event = idle_events_.back();
+        idle_events_.pop_back();
+    } else if (cuda_->cuEventCreate(&event, CU_EVENT_DISABLE_TIMING) !=
+               CUDA_SUCCESS) {
+        return nullptr;
+    }
+    if (cuda_->cuEventRecord(event, stream) != CUDA_SUCCESS) {
+        idle_events_.push_back(event);
+        return nullptr;
+    }
+    return event;
+}
+
+CUDA_CODES DeviceMemoryPool::Free(CUdeviceptr ptr, CUstream stream) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = allocated_.find(ptr);
+    if (it == allocated_.end()) return CUDA_ERROR_INVALID_VALUE;
+
+    Block* block = it->second;
+    allocated_.erase(it);
+    bytes_in_use_ -= block->size;
+
+    // the block stays allocated, so it is not coalesced, until the events
+    // complete
+    CUevent event = RecordEvent(nullptr);
+    CUevent stream_event = nullptr;
+    if (event != nullptr && stream != nullptr) {
+        stream_event = RecordEvent(stream);
+        if (stream_event == nullptr) {
+            idle_events_.push_back(event);
+            event = nullptr;
+        }
+    }
+    if (event != nullptr) {
+        pending_.push_back({block, event, stream_event});
+        bytes_pending_ += block->size;
+        return CUDA_SUCCESS;
+    }
+
+    // without an event, wait like cuMemFree would
+    cuda_->cuCtxSynchronize();
+    ReleaseBlock(block);
+    return CUDA_SUCCESS;
+}
+
+void DeviceMemoryPool::ReleasePending(bool wait) {
+    // blocks are mostly done in the order they were freed, stop at the first
+    // one that is still in use unless waiting
+    size_t done = 0;
+    for (; done < pending_.size(); ++done) {
+        PendingBlock& pending = pending_[done];
+        CUDA_CODES result = wait ? cuda_->cuEventSynchronize(pending.event)
+                                 : cuda_->cuEventQuery(pending.event);
+        if (result == CUDA_SUCCESS && pending.stream_event != nullptr) {
+            result = wait ? cuda_->cuEventSynchronize(pending.stream_event)
+                          : cuda_->cuEventQuery(pending.stream_event);
+        }
+        if (result == CUDA_ERROR_NOT_READY) break;
+        if (result != CUDA_SUCCESS) {
+            std::cerr << "Warning: Failed to wait for freed device memory. "
+                         "Result Code: "
+                      << result << std::endl;
+            cuda_->cuCtxSynchronize();
+        }
+        idle_events_.push_back(pending.event);
+        if (pending.stream_event != nullptr) {
+            idle_events_.push_back(pending.stream_event);
+        }
+        bytes_pending_ -= pending.block->size;
+        ReleaseBlock(pending.block);
+    }
+    pending_.erase(pending_.begin(), pending_.begin() + done);
+}
+
+void DeviceMemoryPool::ReleaseBlock(Block* block) {
+    block->allocated = false;
+
+    // coalesce with free neighbours, the lower block always survives so the
+    // head of a segment never changes
+    Block* next = block->next;
+    if (next != nullptr && !next->allocated) {
+        RemoveFree(next);
+        block->size += next->size;
+        block->next = next->next;
+        if (next->next != nullptr) next->next->prev = block;
+        delete next;
+    }
+    Block* prev = block->prev;
+    if (prev != nullptr && !prev->allocated) {
+        RemoveFree(prev);
+        prev->size += block->size;
+        prev->next = block->next;
+        if (block->next != nullptr) block->next->prev = prev;
+        delete block;
+        block = prev;
+    }
+    InsertFree(block);
+}
+
+size_t DeviceMemoryPool::ReleaseFreeSegments() {
+    size_t released = 0;
+    std::vector<Block*> kept;
+    kept.reserve(segments_.size());
+    for (Block* head : segments_) {
+        bool unused = !head->allocated && head->next == nullptr &&
+                      head->size == head->segment_size;
+        if (!unused) {
+            kept.push_back(head);
+            continue;
+        }
+        RemoveFree(head);
+        auto result = cuda_->cuMemFree(head->ptr);
+        if (result != CUDA_SUCCESS) {
+            std::cerr << "Failed to free cached device memory. Result Code: "
+                      << result << std::endl;
+        }
+        released += head->segment_size;
+        bytes_reserved_ -= head->segment_size;
+        delete head;
+    }
+    segments_.swap(kept);
+    return released;
+}
+
+size_t DeviceMemoryPool::Trim() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ReleasePending(true);
+    return ReleaseFreeSegments();
+}
+
+MemoryPoolStats DeviceMemoryPool::GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    MemoryPoolStats stats;
+    stats.hits = hits_;
+    stats.misses = misses_;
+    stats.segments = segments_.size();
+    stats.bytes_reserved = bytes_reserved_;
+    stats.bytes_in_use = bytes_in_use_;
+    stats.bytes_pending = bytes_pending_;
+
+    size_t free_bytes = 0;
+    for (const auto& bin : bins_) {
+        stats.free_blocks += bin.size();
+        for (const Block* block : bin) {
+            free_bytes += block->size;
+            if (block->size > stats.largest_free_block) {
+                stats.largest_free_block = block->size;
+            }
+        }
+    }
+    if (free_bytes > 0) {
+        stats.fragmentation =
+                1.0 - static_cast<double>(stats.largest_free_block) /
+                              static_cast<double>(free_bytes);
+    }
+    return stats;
+}
+
+}  // namespace cudamgr
+}  // namespace dexsim
@@ -0,0 +1,139 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) 2021-2025 DexForce Technology Co., Ltd.
+//
+// All rights reserved.
+// ----------------------------------------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+#include "DFCudaCodes.h"
+
+namespace dexsim {
+namespace cudamgr {
+
+struct MemoryPoolStats {
+    size_t hits = 0;            // allocations served from cached blocks
+    size_t misses = 0;          // allocations that needed a new segment
+    size_t segments = 0;        // live cuMemAlloc allocations
+    size_t bytes_reserved = 0;  // bytes held from the driver
+    size_t bytes_in_use = 0;    // bytes handed out to callers
+    size_t bytes_pending = 0;   // freed, the GPU may still be using them
+    size_t free_blocks = 0;     // cached blocks ready for reuse
+    size_t largest_free_block = 0;
+    // 1 - largest_free_block / free bytes, 0 means all cached memory is one
+    // block
+    double fragmentation = 0.0;
+};
+
+/// \brief Caching allocator for device memory.
+///
+/// Memory is taken from the driver in segments and carved into blocks. Freed
+/// blocks are coalesced with their free neighbours and parked in size-class
+/// bins, so steady-state allocation never reaches cuMemAlloc/cuMemFree.
+/// Cached segments are only returned to the driver by Trim, or when an
+/// allocation runs out of memory.
+///
+/// cuMemFree waits for the device, Free does not: a freed block stays pending
+/// until an event recorded on the legacy default stream at the time of the
+/// free has completed. That event completes after all work enqueued before it
+/// on blocking streams, so a kernel still reading the block can never see it
+/// reused. A non-blocking stream the block was used on is passed to Free and
+/// gets an event of its own.
+class DeviceMemoryPool {
+public:
+    explicit DeviceMemoryPool(ICudaFunctionManager* cuda);
+    ~DeviceMemoryPool();
+
+    DeviceMemoryPool(const DeviceMemoryPool&) = delete;
+    DeviceMemoryPool& operator=(const DeviceMemoryPool&) = delete;
+
+    /// \brief Allocates at least size bytes of device memory
+    ///
+    /// \param ptr Receives the device pointer
+    /// \param size Number of bytes requested
+    /// \return CUDA_SUCCESS or the error returned by cuMemAlloc
+    CUDA_CODES Allocate(CUdeviceptr* ptr, size_t size);
+
+    /// \brief Returns a block obtained from Allocate to the pool, it can be
+    /// reused once the work enqueued before the call is done
+    ///
+    /// \param ptr Device pointer returned by Allocate
+    /// \param stream Non-blocking stream the block was used on, whose work
+    /// the legacy default stream does not wait for; nullptr if none
+    /// \return CUDA_ERROR_INVALID_VALUE if ptr is not owned by the pool
+    CUDA_CODES Free(CUdeviceptr ptr, CUstream stream = nullptr);
+
+    /// \brief Releases cached segments that are entirely free to the driver,
+    /// after waiting for the pending blocks
+    ///
+    /// \return Number of bytes given back
+    size_t Trim();
+
+    MemoryPoolStats GetStats() const;
+
+private:
+    struct Block {
+        CUdeviceptr ptr = 0;
+        size_t size = 0;
+        size_t segment_size = 0;  // only meaningful on the head block
+        bool allocated = false;
+        Block* prev = nullptr;  // neighbours inside the same segment
+        Block* next = nullptr;
+    };
+
+    struct BlockLess {
+        bool operator()(const Block* a, const Block* b) const {
+            if (a->size != b->size) return a->size < b->size;
+            return a->ptr < b->ptr;
+        }
+    };
+
+    using Bin = std::set<Block*, BlockLess>;
+
+    static size_t RoundSize(size_t size);
+    static size_t BinIndex(size_t size);
+
+    Block* FindFreeBlock(size_t size);
+    Block* CreateSegment(size_t size);
+    void InsertFree(Block* block);
+    void RemoveFree(Block* block);
+    // marks a block free and coalesces it with its free neighbours
+    void ReleaseBlock(Block* block);
+    // releases the pending blocks the device is done with, all of them if
+    // wait is true
+    void ReleasePending(bool wait);
+    size_t ReleaseFreeSegments();
+    // an idle or new event recorded on stream, nullptr if that fails
+    CUevent RecordEvent(CUstream stream);
+
+    ICudaFunctionManager* cuda_;
+    mutable std::mutex mutex_;
+    std::vector<Bin> bins_;
+    std::unordered_map<CUdeviceptr, Block*> allocated_;
+    std::vector<Block*> segments_;  // head block of every segment
+
+    // freed blocks in the order they were freed, with the events that mark
+    // the end of their last use on the legacy stream and on the non-blocking
+    // stream passed to Free
+    struct PendingBlock {
+        Block* block;
+        CUevent event;
+        CUevent stream_event;
+    };
+    std::vector<PendingBlock> pending_;
+    std::vector<CUevent> idle_events_;
+    size_t bytes_pending_ = 0;
+
+    size_t hits_ = 0;
+    size_t misses_ = 0;
+    size_t bytes_reserved_ = 0;
+    size_t bytes_in_use_ = 0;
+};
+
+}  // namespace cudamgr
+}  // namespace dexsim
@@ -0,0 +1,187 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) 2021-2025 DexForce Technology Co., Ltd.
+//
+// All rights reserved.
+// ----------------------------------------------------------------------------
+#include "DFModuleCache.h"
+
+#include "DFKernelIndex.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace dexsim {
+namespace cudamgr {
+
+ModuleCache::ModuleCache(ICudaFunctionManager* cuda,
+                         const std::filesystem::path& directory,
+                         int driver_version,
+                         int compute_capability,
+                         size_t max_bytes)
+    : cuda_(cuda),
+      directory_(directory),
+      driver_version_(driver_version),
+      compute_capability_(compute_capability),
+      max_bytes_(max_bytes) {}
+
+std::filesystem::path ModuleCache::EntryPath(std::string_view ptx) const {
+    char hash[17];
+    std::snprintf(hash, sizeof(hash), "%016llx",
+                  static_cast<unsigned long long>(HashBytes(ptx.data(), ptx.size())));
+    return directory_ / (std::string(hash) + "_" +
+                         std::to_string(driver_version_) + "_sm" +
+                         std::to_string(compute_capability_) + ".cubin");
+}
+
+CUDA_CODES ModuleCache::Load(CUmodule* module,
+                             std::string_view ptx,
+                             const std::string& name) {
+    std::filesystem::path entry = EntryPath(ptx);
+    std::error_code ec;
+    if (std::filesystem::exists(entry, ec)) {
+        std::ifstream file(entry, std::ios::binary);
+        std::string image((std::istreambuf_iterator<char>(file)),
+                          std::istreambuf_iterator<char>());
+        if (!image.empty() &&
+            cuda_->cuModuleLoadData(module, image.data()) == CUDA_SUCCESS) {
+            // keeps recently used entries away from eviction
+            std::filesystem::last_write_time(
+                    entry, std::filesystem::file_time_type::clock::now(), ec);
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++stats_.hits;
+            return CUDA_SUCCESS;
+        }
+        std::cerr << "Warning: Discarding unusable cached module: " << entry
+                  << std::endl;
+        std::filesystem::remove(entry, ec);
+    }
+    return Compile(module, ptx, name, entry);
+}
+
+CUDA_CODES ModuleCache::Compile(CUmodule* module,
+                                std::string_view ptx,
+                                const std::string& name,
+                                const std::filesystem::path& entry) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++stats_.misses;
+    }
+
+    CUlinkState link = nullptr;
+    void* cubin = nullptr;
+    size_t size = 0;
+    auto result = cuda_->cuLinkCreate(0, nullptr, nullptr, &link);
+    if (result == CUDA_SUCCESS) {
+        // the driver wants the terminating null of PTX input
+        result = cuda_->cuLinkAddData(link, CU_JIT_INPUT_PTX,
+                                      const_cast<char*>(ptx.data()),
+                                      ptx.size() + 1, name.c_str(), 0, nullptr,
+                                      nullptr);
+    }
+    if (result == CUDA_SUCCESS) {
+        result = cuda_->cuLinkComplete(link, &cubin, &size);
+    }
+    if (result == CUDA_SUCCESS) {
+        result = cuda_->cuModuleLoadData(module, cubin);
+    }
+    // the cubin belongs to the link state, store it before destroying that
+    if (result == CUDA_SUCCESS && Store(entry, cubin, size)) Evict();
+    if (link != nullptr) cuda_->cuLinkDestroy(link);
+
+    if (result != CUDA_SUCCESS) {
+        // without a usable linker the driver can still JIT the PTX itself
+        std::cerr << "Warning: Failed to compile module " << name
+                  << " for the cache, Result Code: " << result << std::endl;
+        result = cuda_->cuModuleLoadDataEx(module, ptx.data(), 0, nullptr,
+                                           nullptr);
+    }
+    return result;
+}
+
+bool ModuleCache::Store(const std::filesystem::path& entry,
+                        const void* image,
+                        size_t size) {
+    std::error_code ec;
+    std::filesystem::create_directories(directory_, ec);
+
+    // a private name per writer, the rename makes the entry appear whole
+    std::filesystem::path tmp = entry;
+    tmp += ".tmp" +
+           std::to_string(std::hash<std::thread::id>()(
+                   std::this_thread::get_id())) +
+           "_" +
+           std::to_string(std::chrono::steady_clock::now()
+                                  .time_since_epoch()
+                                  .count());
+    {
+        std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "Warning: Failed to write module cache entry: " << tmp
+                      << std::endl;
+            return false;
+        }
+        file.write(static_cast<const char*>(image),
+                   static_cast<std::streamsize>(size));
+        if (!file.good()) {
+            file.close();
+            std::filesystem::remove(tmp, ec);
+            return false;
+        }
+    }
+    std::filesystem::rename(tmp, entry, ec);
+    if (ec) {
+        std::filesystem::remove(tmp, ec);
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.stores;
+    return true;
+}
+
+void ModuleCache::Evict() {
+    struct Entry {
+        std::filesystem::file_time_type time;
+        size_t size;
+        std::filesystem::path path;
+    };
+    std::vector<Entry> entries;
+    size_t total = 0;
+    std::error_code ec;
+    for (const auto& file :
+         std::filesystem::directory_iterator(directory_, ec)) {
+        if (file.path().extension() != ".cubin") continue;
+        Entry entry{file.last_write_time(ec),
+                    static_cast<size_t>(file.file_size(ec)), file.path()};
+        if (ec) continue;
+        total += entry.size;
+        entries.push_back(entry);
+    }
+    if (total <= max_bytes_) return;
+
+    std::sort(entries.begin(), entries.end(),
+              [](const Entry& a, const Entry& b) { return a.time < b.time; });
+    // the newest entry is the one just stored, it always stays
+    size_t evicted = 0;
+    for (size_t i = 0; i + 1 < entries.size() && total > max_bytes_; ++i) {
+        if (std::filesystem::remove(entries[i].path, ec)) {
+            total -= entries[i].size;
+            ++evicted;
+        }
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.evictions += evicted;
+}
+
+ModuleCacheStats ModuleCache::GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+}  // namespace cudamgr
+}  // namespace dexsim
@@ -0,0 +1,91 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) 2021-2025 DexForce Technology Co., Ltd.
+//
+// All rights reserved.
+// ----------------------------------------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include "DFCudaCodes.h"
+
+namespace dexsim {
+namespace cudamgr {
+
+struct ModuleCacheStats {
+    size_t hits = 0;       // modules loaded from a cached cubin
+    size_t misses = 0;     // modules compiled from PTX
+    size_t stores = 0;     // cubins written to the cache
+    size_t evictions = 0;  // cubins removed to stay under the size limit
+};
+
+/// \brief On-disk cache of compiled kernel modules.
+///
+/// PTX is compiled once with the driver's linker and the resulting cubin is
+/// stored under a name made of the PTX content hash, the driver version and
+/// the compute capability of the device, so a driver or GPU change never
+/// picks up a stale image. Cubins are written to a private file and renamed
+/// into place, which lets many processes share one cache directory. The
+/// least recently used cubins are removed once the directory exceeds its
+/// size limit.
+class ModuleCache {
+public:
+    /// \param cuda Driver used for compiling and loading
+    /// \param directory Cache directory, created on first store
+    /// \param driver_version Driver version reported by cuDriverGetVersion
+    /// \param compute_capability Device capability as major * 10 + minor
+    /// \param max_bytes Size limit of all cached cubins together
+    ModuleCache(ICudaFunctionManager* cuda,
+                const std::filesystem::path& directory,
+                int driver_version,
+                int compute_capability,
+                size_t max_bytes);
+
+    ModuleCache(const ModuleCache&) = delete;
+    ModuleCache& operator=(const ModuleCache&) = delete;
+
+    /// \brief Loads a module from PTX, through the cache
+    ///
+    /// \param module Receives the loaded module
+    /// \param ptx PTX source of the module, followed by a null byte in memory
+    /// as the JIT expects; a std::string or an embedded image qualifies
+    /// \param name Name used in messages, e.g. the module type
+    /// \return CUDA_SUCCESS, or the error of the compilation or load
+    CUDA_CODES Load(CUmodule* module,
+                    std::string_view ptx,
+                    const std::string& name);
+
+    /// \brief Path of the cubin a PTX source is cached under
+    std::filesystem::path EntryPath(std::string_view ptx) const;
+
+    ModuleCacheStats GetStats() const;
+
+private:
+    // compiles ptx with the driver linker, loads the result and stores it
+    CUDA_CODES Compile(CUmodule* module,
+                       std::string_view ptx,
+                       const std::string& name,
+                       const std::filesystem::path& entry);
+    bool Store(const std::filesystem::path& entry,
+               const void* image,
+               size_t size);
+    // removes the oldest cubins until the cache fits max_bytes_
+    void Evict();
+
+    ICudaFunctionManager* cuda_;
+    std::filesystem::path directory_;
+    int driver_version_;
+    int compute_capability_;
+    size_t max_bytes_;
+
+    ModuleCacheStats stats_;
+    mutable std::mutex mutex_;
+};
+
+}  // namespace cudamgr
+}  // namespace dexsim
@@ -0,0 +1,78 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) 2021-2025 DexForce Technology Co., Ltd.
+//
+// All rights reserved.
+// ----------------------------------------------------------------------------
+#include "DFSlabAllocator.h"
+
+#include <iostream>
+
+namespace dexsim {
+namespace cudamgr {
+
+SlabAllocator::SlabAllocator(size_t block_size,
+                             size_t alignment,
+                             size_t blocks_per_slab)
+    : alignment_(alignment < alignof(FreeBlock) ? alignof(FreeBlock)
+                                                : alignment),
+      blocks_per_slab_(blocks_per_slab == 0 ? 1 : blocks_per_slab) {
+    // free blocks hold the list link, every block starts aligned
+    if (block_size < sizeof(FreeBlock)) block_size = sizeof(FreeBlock);
+    block_size_ = (block_size + alignment_ - 1) & ~(alignment_ - 1);
+}
+
+SlabAllocator::~SlabAllocator() {
+    for (void* slab : slabs_) {
+        ::operator delete(slab, std::align_val_t(alignment_));
+    }
+}
+
+void* SlabAllocator::Allocate() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (free_ == nullptr) {
+        void* slab = ::operator new(block_size_ * blocks_per_slab_,
+                                    std::align_val_t(alignment_),
+                                    std::nothrow);
+        if (slab == nullptr) {
+            std::cerr << "Warning: Failed to allocate a slab of "
+                      << blocks_per_slab_ << " blocks of " << block_size_
+                      << " bytes." << std::endl;
+            return nullptr;
+        }
+        slabs_.push_back(slab);
+        // thread the new blocks onto the list, lowest address first
+        char* blocks = static_cast<char*>(slab);
+        for (size_t i = blocks_per_slab_; i-- > 0;) {
+            auto* block =
+                    reinterpret_cast<FreeBlock*>(blocks + i * block_size_);
+            block->next = free_;
+            free_ = block;
+        }
+    }
+    FreeBlock* block = free_;
+    free_ = block->next;
+    ++live_;
+    return block;
+}
+
+void SlabAllocator::Free(void* block) {
+    if (block == nullptr) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto* freed = static_cast<FreeBlock*>(block);
+    freed->next = free_;
+    free_ = freed;
+    --live_;
+}
+
+size_t SlabAllocator::LiveBlocks() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return live_;
+}
+
+size_t SlabAllocator::Capacity() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return slabs_.size() * blocks_per_slab_;
+}
+
+}  // namespace cudamgr
+}  // namespace dexsim
@@ -0,0 +1,86 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) 2021-2025 DexForce Technology Co., Ltd.
+//
+// All rights reserved.
+// ----------------------------------------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace dexsim {
+namespace cudamgr {
+
+/// \brief Fixed-size blocks carved from larger slabs.
+///
+/// Array headers and their shared-data blocks are small and created and
+/// released all the time, e.g. one view per environment and step. Taking them
+/// from a free list keeps them off the general heap and close together in
+/// memory. Slabs are only returned to the system with the allocator.
+class SlabAllocator {
+public:
+    /// \param block_size Size of one block in bytes
+    /// \param alignment Alignment of every block, a power of two
+    /// \param blocks_per_slab Blocks allocated at once when the list is empty
+    SlabAllocator(size_t block_size,
+                  size_t alignment,
+                  size_t blocks_per_slab = 256);
+    ~SlabAllocator();
+
+    SlabAllocator(const SlabAllocator&) = delete;
+    SlabAllocator& operator=(const SlabAllocator&) = delete;
+
+    /// \brief A free block, nullptr if no slab can be allocated
+    void* Allocate();
+
+    /// \brief Returns a block from Allocate to the free list
+    void Free(void* block);
+
+    /// \brief Number of blocks handed out and not freed
+    size_t LiveBlocks() const;
+
+    /// \brief Number of blocks in all slabs
+    size_t Capacity() const;
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    size_t block_size_;
+    size_t alignment_;
+    size_t blocks_per_slab_;
+    FreeBlock* free_ = nullptr;
+    std::vector<void*> slabs_;
+    size_t live_ = 0;
+    mutable std::mutex mutex_;
+};
+
+// Slab of the objects of type T. It is never destroyed: arrays held by static
+// objects may be released after it would have been.
+template <typename T>
+SlabAllocator& SlabFor() {
+    static SlabAllocator* slab = new SlabAllocator(sizeof(T), alignof(T));
+    return *slab;
+}
+
+// new and delete for objects living in SlabFor<T>()
+template <typename T, typename... Args>
+T* SlabNew(Args&&... args) {
+    void* block = SlabFor<T>().Allocate();
+    if (block == nullptr) return nullptr;
+    return new (block) T(std::forward<Args>(args)...);
+}
+
+template <typename T>
+void SlabDelete(T* object) {
+    if (object == nullptr) return;
+    object->~T();
+    SlabFor<T>().Free(object);
+}
+
+}  // namespace cudamgr
+}  // namespace dexsim
@@ -0,0 +1,138 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) 2021-2025 DexForce Technology Co., Ltd.
+//
+// All rights reserved.
+// ----------------------------------------------------------------------------
+#include "DFStagingRing.h"
+
+#include <cstring>
+
+namespace dexsim {
+namespace cudamgr {
+
+namespace {
+// The staged copies run on the legacy default stream, like the synchronous
+// copies they replace: it waits for the work already enqueued on every
+// blocking stream, and work enqueued there later waits for the copy. A
+// stream of our own would only be ordered against the default stream, so a
+// readback could overtake a kernel still running on a family stream.
+const CUstream kLegacyStream = nullptr;
+}  // namespace
+
+PinnedStagingRing::PinnedStagingRing(ICudaFunctionManager* cuda,
+                                     size_t slot_size,
+                                     int num_slots)
+    : cuda_(cuda),
+      slot_size_(slot_size),
+      num_slots_(num_slots < 2 ? 2 : num_slots) {}
+
+PinnedStagingRing::~PinnedStagingRing() {
+    if (!allocated_) return;
+    for (auto& slot : slots_) {
+        cuda_->cuEventSynchronize(slot.done);
+        cuda_->cuEventDestroy(slot.done);
+        cuda_->cuMemFreeHost(slot.buffer);
+    }
+}
+
+bool PinnedStagingRing::EnsureAllocated() {
+    if (allocated_) return true;
+    if (failed_) return false;
+
+    CUDA_CODES result = CUDA_SUCCESS;
+    slots_.resize(num_slots_);
+    for (auto& slot : slots_) {
+        if (result != CUDA_SUCCESS) break;
+        void* buffer = nullptr;
+        result = cuda_->cuMemHostAlloc(&buffer, slot_size_,
+                                       CU_MEMHOSTALLOC_PORTABLE);
+        slot.buffer = static_cast<char*>(buffer);
+        if (result != CUDA_SUCCESS) break;
+        result = cuda_->cuEventCreate(&slot.done, CU_EVENT_DISABLE_TIMING);
+    }
+
+    if (result != CUDA_SUCCESS) {
+        std::cerr << "Warning: Failed to allocate pinned staging buffers, "
+                     "pageable copies go through the driver. Result Code: "
+                  << result << std::endl;
+        for (auto& slot : slots_) {
+            if (slot.done != nullptr) cuda_->cuEventDestroy(slot.done);
+            if (slot.buffer != nullptr) cuda_->cuMemFreeHost(slot.buffer);
+        }
+        slots_.clear();
+        failed_ = true;
+        return false;
+    }
+    allocated_ = true;
+    return true;
+}
+
+CUDA_CODES PinnedStagingRing::CopyToDevice(CUdeviceptr dst,
+                                           const void* src,
+                                           size_t size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!EnsureAllocated()) return cuda_->cuMemcpyHtoD(dst, src, size);
+
+    const char* source = static_cast<const char*>(src);
+    size_t chunks = (size + slot_size_ - 1) / slot_size_;
+    for (size_t chunk = 0; chunk < chunks; ++chunk) {
+        Slot& slot = slots_[chunk % num_slots_];
+        size_t offset = chunk * slot_size_;
+        size_t bytes = size - offset < slot_size_ ? size - offset : slot_size_;
+
+        // the slot's previous DMA must be done before it is overwritten
+        if (chunk >= static_cast<size_t>(num_slots_)) {
+            cuda_->cuEventSynchronize(slot.done);
+        }
+        std::memcpy(slot.buffer, source + offset, bytes);
+        auto result = cuda_->cuMemcpyHtoDAsync(dst + offset, slot.buffer,
+                                               bytes, kLegacyStream);
+        if (result != CUDA_SUCCESS) {
+            cuda_->cuStreamSynchronize(kLegacyStream);
+            return result;
+        }
+        cuda_->cuEventRecord(slot.done, kLegacyStream);
+    }
+    return cuda_->cuStreamSynchronize(kLegacyStream);
+}
+
+CUDA_CODES PinnedStagingRing::CopyToHost(void* dst,
+                                         CUdeviceptr src,
+                                         size_t size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!EnsureAllocated()) return cuda_->cuMemcpyDtoH(dst, src, size);
+
+    char* destination = static_cast<char*>(dst);
+    size_t chunks = (size + slot_size_ - 1) / slot_size_;
+    auto drain = [&](size_t chunk) {
+        Slot& slot = slots_[chunk % num_slots_];
+        size_t offset = chunk * slot_size_;
+        size_t bytes = size - offset < slot_size_ ? size - offset : slot_size_;
+        cuda_->cuEventSynchronize(slot.done);
+        std::memcpy(destination + offset, slot.buffer, bytes);
+    };
+
+    for (size_t chunk = 0; chunk < chunks; ++chunk) {
+        // keep num_slots_ chunks in flight, drain the oldest to free its slot
+        if (chunk >= static_cast<size_t>(num_slots_)) drain(chunk - num_slots_);
+
+        Slot& slot = slots_[chunk % num_slots_];
+        size_t offset = chunk * slot_size_;
+        size_t bytes = size - offset < slot_size_ ? size - offset : slot_size_;
+        auto result = cuda_->cuMemcpyDtoHAsync(slot.buffer, src + offset,
+                                               bytes, kLegacyStream);
+        if (result != CUDA_SUCCESS) {
+            cuda_->cuStreamSynchronize(kLegacyStream);
+            return result;
+        }
+        cuda_->cuEventRecord(slot.done, kLegacyStream);
+    }
+    size_t first = chunks > static_cast<size_t>(num_slots_)
+                           ? chunks - num_slots_
+                           : 0;
+    for (size_t chunk = first; chunk < chunks; ++chunk) { drain(chunk); }
+    return CUDA_SUCCESS;
+}
+
+}  // namespace cudamgr
+}  // namespace dexsim
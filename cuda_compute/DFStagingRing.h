@@ -0,0 +1,63 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) 2021-2025 DexForce Technology Co., Ltd.
+//
+// All rights reserved.
+// ----------------------------------------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+#include "DFCudaCodes.h"
+
+namespace dexsim {
+namespace cudamgr {
+
+/// \brief Ring of page-locked buffers used to move pageable host memory.
+///
+/// Copies from pageable memory are split into slot sized chunks. While the DMA
+/// engine moves one chunk between a pinned slot and the device, the CPU fills
+/// or drains the next slot, so the transfer runs at pinned bandwidth instead
+/// of going through the driver's own bounce buffer one piece at a time.
+class PinnedStagingRing {
+public:
+    /// \param cuda Driver entry points
+    /// \param slot_size Size of one pinned slot in bytes
+    /// \param num_slots Number of slots, at least 2 to overlap copy and DMA
+    PinnedStagingRing(ICudaFunctionManager* cuda,
+                      size_t slot_size,
+                      int num_slots);
+    ~PinnedStagingRing();
+
+    PinnedStagingRing(const PinnedStagingRing&) = delete;
+    PinnedStagingRing& operator=(const PinnedStagingRing&) = delete;
+
+    /// \brief Copies pageable host memory to the device, returns once the data
+    /// has arrived
+    CUDA_CODES CopyToDevice(CUdeviceptr dst, const void* src, size_t size);
+
+    /// \brief Copies device memory into pageable host memory, returns once the
+    /// data has arrived
+    CUDA_CODES CopyToHost(void* dst, CUdeviceptr src, size_t size);
+
+private:
+    struct Slot {
+        char* buffer = nullptr;
+        CUevent done = nullptr;
+    };
+
+    // the pinned slots are only allocated by the first staged copy
+    bool EnsureAllocated();
+
+    ICudaFunctionManager* cuda_;
+    size_t slot_size_;
+    int num_slots_;
+    bool allocated_ = false;
+    bool failed_ = false;
+    std::vector<Slot> slots_;
+    std::mutex mutex_;
+};
+
+}  // namespace cudamgr
+}  // namespace dexsim
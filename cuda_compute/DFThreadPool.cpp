@@ -0,0 +1,156 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) 2021-2025 DexForce Technology Co., Ltd.
+//
+// All rights reserved.
+// ----------------------------------------------------------------------------
+#include "DFThreadPool.h"
+
+namespace dexsim {
+namespace cudamgr {
+
+namespace {
+// identifies the pool and the deque owned by the current thread
+thread_local const ThreadPool* tls_pool = nullptr;
+thread_local int tls_worker = -1;
+}  // namespace
+
+ThreadPool::ThreadPool(unsigned num_threads) {
+    if (num_threads == 0) {
+        num_threads = std::thread::hardware_concurrency();
+        if (num_threads == 0) num_threads = 1;
+    }
+
+    num_threads_ = num_threads;
+    for (unsigned i = 0; i < num_threads; ++i) {
+        queues_.emplace_back(new WorkQueue);
+    }
+    for (unsigned i = 0; i < num_threads; ++i) {
+        workers_.emplace_back([this, i]() { WorkerLoop(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_) { worker.join(); }
+}
+
+int ThreadPool::CurrentWorker() const {
+    return tls_pool == this ? tls_worker : -1;
+}
+
+void ThreadPool::Push(std::function<void()> task) {
+    int self = CurrentWorker();
+    unsigned target = self >= 0 ? static_cast<unsigned>(self)
+                                : next_queue_.fetch_add(1) % Size();
+    {
+        std::lock_guard<std::mutex> lock(queues_[target]->mutex_);
+        queues_[target]->tasks_.push_back(std::move(task));
+    }
+    pending_.fetch_add(1);
+    {
+        // taking the lock orders the notify after a sleeper's predicate check
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+    }
+    wake_.notify_one();
+}
+
+bool ThreadPool::TryPop(int self, std::function<void()>& task) {
+    // own deque first, newest task is the warmest in cache
+    if (self >= 0) {
+        WorkQueue& own = *queues_[self];
+        std::lock_guard<std::mutex> lock(own.mutex_);
+        if (!own.tasks_.empty()) {
+            task = std::move(own.tasks_.back());
+            own.tasks_.pop_back();
+            pending_.fetch_sub(1);
+            return true;
+        }
+    }
+
+    // steal the oldest task of another worker
+    unsigned count = Size();
+    unsigned start = self >= 0 ? static_cast<unsigned>(self) + 1 : 0;
+    for (unsigned i = 0; i < count; ++i) {
+        unsigned victim = (start + i) % count;
+        if (static_cast<int>(victim) == self) continue;
+        WorkQueue& other = *queues_[victim];
+        std::lock_guard<std::mutex> lock(other.mutex_);
+        if (!other.tasks_.empty()) {
+            task = std::move(other.tasks_.front());
+            other.tasks_.pop_front();
+            pending_.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::WorkerLoop(unsigned index) {
+    tls_pool = this;
+    tls_worker = static_cast<int>(index);
+
+    std::function<void()> task;
+    while (true) {
+        if (TryPop(tls_worker, task)) {
+            task();
+            task = nullptr;
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        wake_.wait(lock, [this]() { return stop_ || pending_.load() > 0; });
+        if (stop_ && pending_.load() == 0) return;
+    }
+}
+
+void ThreadPool::Submit(std::function<void()> task) { Push(std::move(task)); }
+
+void ThreadPool::ParallelFor(size_t count,
+                             size_t grain,
+                             const std::function<void(size_t, size_t)>& body) {
+    if (count == 0) return;
+    if (grain == 0) grain = 1;
+    if (num_threads_ == 0 || count <= grain) {
+        body(0, count);
+        return;
+    }
+
+    // a few chunks per worker leaves room for stealing to balance the load
+    size_t chunks = (count + grain - 1) / grain;
+    size_t max_chunks = static_cast<size_t>(Size()) * 4;
+    if (chunks > max_chunks) chunks = max_chunks;
+    size_t chunk_size = (count + chunks - 1) / chunks;
+    chunks = (count + chunk_size - 1) / chunk_size;
+
+    std::atomic<size_t> remaining(chunks);
+    for (size_t c = 1; c < chunks; ++c) {
+        size_t begin = c * chunk_size;
+        size_t end = begin + chunk_size < count ? begin + chunk_size : count;
+        Push([&body, &remaining, begin, end]() {
+            body(begin, end);
+            remaining.fetch_sub(1, std::memory_order_release);
+        });
+    }
+
+    // the caller takes the first chunk, then helps with whatever is left
+    body(0, chunk_size < count ? chunk_size : count);
+    remaining.fetch_sub(1, std::memory_order_release);
+
+    int self = CurrentWorker();
+    std::function<void()> task;
+    while (remaining.load(std::memory_order_acquire) > 0) {
+        if (TryPop(self, task)) {
+            task();
+            task = nullptr;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+}  // namespace cudamgr
+}  // namespace dexsim
@@ -0,0 +1,80 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) 2021-2025 DexForce Technology Co., Ltd.
+//
+// All rights reserved.
+// ----------------------------------------------------------------------------
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dexsim {
+namespace cudamgr {
+
+/// \brief A work-stealing thread pool.
+///
+/// Every worker owns a task deque. Workers pop their own tasks LIFO and steal
+/// from the other workers FIFO when they run dry, so a ParallelFor spread over
+/// all deques keeps every core busy even when chunks have uneven cost.
+class ThreadPool {
+public:
+    /// \brief Creates the pool.
+    ///
+    /// \param num_threads Number of worker threads, 0 means one per hardware
+    /// thread.
+    explicit ThreadPool(unsigned num_threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /// \brief Number of worker threads owned by the pool
+    unsigned Size() const { return num_threads_; }
+
+    /// \brief Enqueues a task, it will be executed by one of the workers.
+    ///
+    /// \param task The task to execute
+    void Submit(std::function<void()> task);
+
+    /// \brief Runs body(begin, end) over [0, count) and blocks until every
+    /// chunk has finished.
+    ///
+    /// \param count Number of items in the range
+    /// \param grain Minimum number of items handled by one chunk
+    /// \param body Callable receiving a half-open sub range
+    /// \note The calling thread executes chunks too, so it is safe to call
+    /// ParallelFor from inside a task running on the pool.
+    void ParallelFor(size_t count,
+                     size_t grain,
+                     const std::function<void(size_t, size_t)>& body);
+
+private:
+    struct WorkQueue {
+        std::mutex mutex_;
+        std::deque<std::function<void()>> tasks_;
+    };
+
+    void WorkerLoop(unsigned index);
+    void Push(std::function<void()> task);
+    bool TryPop(int self, std::function<void()>& task);
+    int CurrentWorker() const;
+
+    unsigned num_threads_ = 0;
+    std::vector<std::unique_ptr<WorkQueue>> queues_;
+    std::vector<std::thread> workers_;
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+    std::atomic<size_t> pending_{0};
+    std::atomic<unsigned> next_queue_{0};
+    bool stop_ = false;
+};
+
+}  // namespace cudamgr
+}  // namespace dexsim
@@ -0,0 +1,187 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) 2021-2025 DexForce Technology Co., Ltd.
+//
+// All rights reserved.
+// ----------------------------------------------------------------------------
+#pragma once
+#include <cstdint>
+
+#include <native/builtin.h>
+
+#include "DFHyperArray.h"
+
+namespace dexsim {
+namespace cudamgr {
+
+// Launch bounds handed to every Warp kernel as its first argument, the layout
+// mirrors wp::launch_bounds_t.
+struct CudaBounds {
+    int shape[4];
+    int ndim;
+    size_t size;
+};
+
+// Most arrays a single launch can take, so that the argument block of a launch
+// fits in fixed storage.
+constexpr int kMaxLaunchArrays = 16;
+
+static_assert(sizeof(wp::array_t<float>) == sizeof(wp::array_t<int8_t>) &&
+                      sizeof(wp::array_t<float>) == sizeof(wp::array_t<double>),
+              "wp::array_t layout must not depend on the element type");
+
+// Kernel parameter block of a Warp launch: the launch bounds followed by one
+// array_t per argument. argv points into the struct itself.
+struct WarpArgs {
+    CudaBounds bounds;
+    // array_t<T> has the same layout for every scalar T, each slot is read by
+    // the kernel as the array_t of its argument's dtype
+    wp::array_t<float> arrays[kMaxLaunchArrays];
+    void* argv[kMaxLaunchArrays + 1];
+};
+
+// How the domain of a launch is mapped onto the CUDA grid.
+enum LaunchMode : unsigned char {
+    // one thread per element of the flattened domain, in a 1D grid
+    LAUNCH_SHAPED = 0,
+    // a 1D grid sized to fill the device once, every thread strides over the
+    // flattened domain and rebuilds its index from CudaBounds
+    LAUNCH_FLAT = 1,
+};
+
+// A launch whose kernel, arguments and launch dimensions are resolved once and
+// reused by every submission. The argument block is only repacked when an
+// array's device pointer or shape changed since the last submission.
+struct BoundLaunch {
+    BoundLaunch() = default;
+    BoundLaunch(const BoundLaunch&) = delete;
+    BoundLaunch& operator=(const BoundLaunch&) = delete;
+
+    // CUfunction on the CUDA backend, HostKernel on the host backend
+    void* kernel = nullptr;
+    int kernel_id = -1;
+
+    int num_arrays = 0;
+    HyperArrayBase* arrays[kMaxLaunchArrays];
+    int stream_type = -1;
+    int stream_id = -1;
+    uint32_t write_mask = ~0u;
+    LaunchMode mode = LAUNCH_SHAPED;
+
+    bool packed = false;
+    WarpArgs args;
+    unsigned int grid[3] = {1, 1, 1};
+    unsigned int block[3] = {1, 1, 1};
+};
+
+// One argument set of a LaunchBatch, e.g. the arrays of one environment.
+// Records of a batch share the kernel and the stream.
+struct LaunchRecord {
+    int num_arrays = 0;
+    HyperArrayHook* arrays = nullptr;
+    uint32_t write_mask = ~0u;
+};
+
+// true if two packed launches cover the same domain, so they can share the
+// launch dimensions
+inline bool SameLaunchDomain(const BoundLaunch& a, const BoundLaunch& b) {
+    if (a.mode != b.mode || a.num_arrays != b.num_arrays) return false;
+    for (int i = 0; i < a.num_arrays; ++i) {
+        const HyperArrayBase* x = a.arrays[i];
+        const HyperArrayBase* y = b.arrays[i];
+        if (x->ndim_ != y->ndim_) return false;
+        for (size_t dim = 0; dim < x->ndim_; ++dim) {
+            if (x->shape_[dim] != y->shape_[dim]) return false;
+        }
+    }
+    return true;
+}
+
+// Fills the argument block of a launch from its arrays. Returns false if an
+// argument has no device memory.
+inline bool PackWarpArgs(BoundLaunch* launch) {
+    WarpArgs& args = launch->args;
+    const HyperArrayBase* first = launch->arrays[0];
+    args.bounds.ndim = static_cast<int>(first->ndim_);
+    args.bounds.size = 1;
+    for (int i = 0; i < 4; ++i) { args.bounds.shape[i] = 1; }
+    for (int i = 0; i < args.bounds.ndim; ++i) {
+        args.bounds.shape[i] = static_cast<int>(first->shape_[i]);
+        args.bounds.size *= first->shape_[i];
+    }
+
+    args.argv[0] = &args.bounds;
+    for (int i = 0; i < launch->num_arrays; ++i) {
+        const HyperArrayBase* array = launch->arrays[i];
+        if (array->gpu_data_ == nullptr || !array->gpu_data_->is_allocated_) {
+            return false;
+        }
+        auto& warp_array = args.arrays[i];
+        warp_array.data = reinterpret_cast<float*>(DeviceDataOf(array));
+        warp_array.ndim = static_cast<int>(array->ndim_);
+        for (size_t dim = 0; dim < array->ndim_; ++dim) {
+            warp_array.shape[dim] = static_cast<int>(array->shape_[dim]);
+            warp_array.strides[dim] = static_cast<int>(array->strides_[dim]);
+        }
+        args.argv[i + 1] = &warp_array;
+    }
+    return true;
+}
+
+// true if the packed arguments no longer match the arrays of the launch
+inline bool WarpArgsStale(const BoundLaunch& launch) {
+    for (int i = 0; i < launch.num_arrays; ++i) {
+        const HyperArrayBase* array = launch.arrays[i];
+        const auto& warp_array = launch.args.arrays[i];
+        if (array->gpu_data_ == nullptr ||
+            reinterpret_cast<CUdeviceptr>(warp_array.data) !=
+                    DeviceDataOf(array) ||
+            static_cast<size_t>(warp_array.ndim) != array->ndim_) {
+            return true;
+        }
+        for (size_t dim = 0; dim < array->ndim_; ++dim) {
+            if (static_cast<size_t>(warp_array.shape[dim]) !=
+                        array->shape_[dim] ||
+                static_cast<size_t>(warp_array.strides[dim]) !=
+                        array->strides_[dim]) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Converts a flattened launch index into the address of the matching element
+// of a Warp array, honouring the byte strides stored in the array.
+template <typename T>
+inline T& WarpArrayAt(const wp::array_t<T>& array,
+                      const CudaBounds& bounds,
+                      size_t index) {
+    size_t offset = 0;
+    for (int dim = bounds.ndim - 1; dim >= 0; --dim) {
+        size_t extent = static_cast<size_t>(bounds.shape[dim]);
+        offset += (index % extent) * static_cast<size_t>(array.strides[dim]);
+        index /= extent;
+    }
+    return *reinterpret_cast<T*>(reinterpret_cast<char*>(array.data) + offset);
+}
+
+// true if element i of the launch is element i of the array's data, i.e. the
+// array is dense and row-major over the launch bounds
+template <typename T>
+inline bool WarpArrayDense(const wp::array_t<T>& array,
+                           const CudaBounds& bounds) {
+    size_t stride = sizeof(T);
+    for (int dim = bounds.ndim - 1; dim >= 0; --dim) {
+        // the stride of a unit dimension is never applied
+        if (bounds.shape[dim] == 1) continue;
+        if (array.strides[dim] < 0 ||
+            static_cast<size_t>(array.strides[dim]) != stride) {
+            return false;
+        }
+        stride *= static_cast<size_t>(bounds.shape[dim]);
+    }
+    return true;
+}
+
+}  // namespace cudamgr
+}  // namespace dexsim
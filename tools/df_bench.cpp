@@ -0,0 +1,432 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) 2021-2025 DexForce Technology Co., Ltd.
+//
+// All rights reserved.
+// ----------------------------------------------------------------------------
+// Host overhead benchmarks of the compute core.
+//
+// usage: df_bench [--repeats N] [--min-time-ms T] [--filter TEXT]
+//                 [--output FILE] [--list]
+//
+// Runs CudaManager on the host stand-in driver, so it needs neither a GPU nor
+// PhysX: device memory is host memory and launches are only counted, which
+// leaves the manager's own cost. Every benchmark is calibrated to at least
+// --min-time-ms per sample and repeated --repeats times after a warm-up
+// sample. The results are written as JSON to --output, or to stdout; progress
+// goes to stderr. Kernel directories and $HOME are redirected to a temporary
+// directory, which is removed at exit.
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "DFKernelIndex.h"
+#include "df_tool_common.h"
+
+using dexsim::cudamgr::CudaManager;
+using dexsim::cudamgr::HostFunctionManager;
+using dexsim::cudamgr::HyperArrayHook;
+using dexsim::cudamgr::KernelIndex;
+using dexsim::cudamgr::LaunchHook;
+using dexsim::tools::HostManager;
+using dexsim::tools::QuietConsole;
+using dexsim::tools::SetEnv;
+using dexsim::tools::TempRoot;
+using dexsim::tools::WriteKernelModule;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    int repeats = 10;
+    double min_sample_ms = 20.0;
+    std::string filter;
+    std::string output;
+    bool list = false;
+};
+
+// Runs the measured operation `iterations` times, returns the nanoseconds
+// spent in it. Setup that must not be timed stays outside the clock.
+using Body = std::function<double(size_t iterations)>;
+
+template <typename Op>
+double TimeLoop(size_t iterations, Op&& op) {
+    auto start = Clock::now();
+    for (size_t i = 0; i < iterations; ++i) { op(); }
+    return std::chrono::duration<double, std::nano>(Clock::now() - start)
+            .count();
+}
+
+struct Result {
+    std::string name;
+    std::vector<std::pair<std::string, long long>> params;
+    size_t iterations = 0;
+    // nanoseconds per operation of every sample, sorted
+    std::vector<double> samples;
+    // bytes moved by one operation, 0 if throughput does not apply
+    double bytes_per_op = 0.0;
+};
+
+class Runner {
+public:
+    explicit Runner(const Options& options) : options_(options) {}
+
+    void Run(const std::string& name,
+             std::vector<std::pair<std::string, long long>> params,
+             double bytes_per_op,
+             const Body& body) {
+        std::string id = name;
+        for (const auto& param : params) {
+            id += "/" + param.first + "=" + std::to_string(param.second);
+        }
+        if (options_.list) {
+            std::cerr << id << std::endl;
+            return;
+        }
+        if (!options_.filter.empty() &&
+            id.find(options_.filter) == std::string::npos) {
+            return;
+        }
+
+        // doubles the iterations until a sample takes long enough, the last
+        // calibration run doubles as the warm-up
+        const double min_sample_ns = options_.min_sample_ms * 1e6;
+        size_t iterations = 1;
+        double elapsed = body(iterations);
+        while (elapsed < min_sample_ns && iterations < (size_t(1) << 24)) {
+            double scale = elapsed > 0 ? min_sample_ns / elapsed : 2.0;
+            iterations = static_cast<size_t>(
+                    iterations * std::min(std::max(scale * 1.2, 2.0), 100.0));
+            elapsed = body(iterations);
+        }
+
+        Result result;
+        result.name = name;
+        result.params = std::move(params);
+        result.iterations = iterations;
+        result.bytes_per_op = bytes_per_op;
+        for (int i = 0; i < options_.repeats; ++i) {
+            result.samples.push_back(body(iterations) / iterations);
+        }
+        std::sort(result.samples.begin(), result.samples.end());
+        std::cerr << id << ": " << Median(result.samples) << " ns ("
+                  << iterations << " x " << options_.repeats << ")"
+                  << std::endl;
+        results_.push_back(std::move(result));
+    }
+
+    void WriteJson(std::ostream& out) const {
+        std::time_t now = std::time(nullptr);
+        char date[32];
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ",
+                      std::gmtime(&now));
+
+        out << "{\n"
+            << "  \"benchmark\": \"df_bench\",\n"
+            << "  \"schema_version\": 1,\n"
+            << "  \"date\": \"" << date << "\",\n"
+            << "  \"driver\": \"host\",\n"
+            << "  \"repeats\": " << options_.repeats << ",\n"
+            << "  \"min_sample_ms\": " << options_.min_sample_ms << ",\n"
+            << "  \"results\": [";
+        for (size_t i = 0; i < results_.size(); ++i) {
+            const Result& r = results_[i];
+            double median = Median(r.samples);
+            double mean = 0.0;
+            for (double s : r.samples) mean += s;
+            mean /= r.samples.size();
+            double variance = 0.0;
+            for (double s : r.samples) variance += (s - mean) * (s - mean);
+            if (r.samples.size() > 1) variance /= r.samples.size() - 1;
+
+            out << (i == 0 ? "\n" : ",\n") << "    {\"name\": \"" << r.name
+                << "\", \"params\": {";
+            for (size_t p = 0; p < r.params.size(); ++p) {
+                out << (p == 0 ? "" : ", ") << "\"" << r.params[p].first
+                    << "\": " << r.params[p].second;
+            }
+            out << "}, \"unit\": \"ns\", \"iterations\": " << r.iterations
+                << ", \"samples\": " << r.samples.size()
+                << ", \"min\": " << r.samples.front()
+                << ", \"median\": " << median << ", \"mean\": " << mean
+                << ", \"stddev\": " << std::sqrt(variance)
+                << ", \"max\": " << r.samples.back();
+            if (r.bytes_per_op > 0 && median > 0) {
+                out << ", \"bytes_per_second\": "
+                    << r.bytes_per_op / median * 1e9;
+            }
+            out << "}";
+        }
+        out << "\n  ]\n}\n";
+    }
+
+private:
+    static double Median(const std::vector<double>& sorted) {
+        size_t n = sorted.size();
+        if (n == 0) return 0.0;
+        return n % 2 ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2;
+    }
+
+    const Options& options_;
+    std::vector<Result> results_;
+};
+
+// A kernel directory of num_kernels kernels, kernels_per_module to a module:
+// <dir>/bench<m>/CoreLUT.txt and bench<m>.ptx. Kernel k of module m is named
+// bench<m>_<k>_0.
+void WriteKernelDir(const fs::path& dir,
+                    int num_kernels,
+                    int kernels_per_module) {
+    int modules = (num_kernels + kernels_per_module - 1) / kernels_per_module;
+    for (int m = 0; m < modules; ++m) {
+        std::string type = "bench" + std::to_string(m);
+        int count = std::min(kernels_per_module,
+                             num_kernels - m * kernels_per_module);
+        std::vector<std::pair<std::string, std::string>> kernels;
+        for (int k = 0; k < count; ++k) {
+            std::string name = type + "_" + std::to_string(k);
+            kernels.emplace_back(name + "_0", "wp_" + name);
+        }
+        WriteKernelModule(dir, type, kernels);
+    }
+}
+
+void BenchArrays(Runner& runner) {
+    HostManager host;
+    CudaManager& mgr = host.manager;
+
+    for (int elements : {16, 4096, 1 << 20}) {
+        std::vector<float> data(elements, 1.0f);
+        int shape[1] = {elements};
+        long long bytes = sizeof(float) * static_cast<long long>(elements);
+
+        runner.Run("create_release_array", {{"elements", elements}}, 0,
+                   [&](size_t iterations) {
+                       return TimeLoop(iterations, [&] {
+                           HyperArrayHook array = nullptr;
+                           mgr.CreateArray<float>(&array, 1, shape,
+                                                  data.data(), true);
+                           mgr.ReleaseArray<float>(array);
+                       });
+                   });
+
+        HyperArrayHook host_only = nullptr;
+        mgr.CreateArray<float>(&host_only, 1, shape, data.data(), false);
+        runner.Run("allocate_release_device", {{"bytes", bytes}}, 0,
+                   [&](size_t iterations) {
+                       return TimeLoop(iterations, [&] {
+                           mgr.AllocateDevice<float>(host_only);
+                           mgr.ReleaseArrayDataDevice<float>(host_only);
+                       });
+                   });
+        mgr.ReleaseArray<float>(host_only);
+
+        HyperArrayHook device_only = nullptr;
+        mgr.CreateArray<float>(&device_only, 1, shape, data.data(), true);
+        runner.Run("allocate_release_host", {{"bytes", bytes}}, 0,
+                   [&](size_t iterations) {
+                       return TimeLoop(iterations, [&] {
+                           mgr.AllocateHost<float>(device_only);
+                           mgr.ReleaseArrayDataHost<float>(device_only);
+                       });
+                   });
+        mgr.ReleaseArray<float>(device_only);
+    }
+}
+
+void BenchSync(Runner& runner) {
+    HostManager host;
+    CudaManager& mgr = host.manager;
+
+    // 4 KB to 16 MB, large pageable transfers are staged through pinned
+    // memory
+    for (int bytes : {4 << 10, 64 << 10, 1 << 20, 16 << 20}) {
+        int elements = bytes / static_cast<int>(sizeof(float));
+        std::vector<float> data(elements, 1.0f);
+        int shape[1] = {elements};
+        HyperArrayHook array = nullptr;
+        mgr.CreateArray<float>(&array, 1, shape, data.data(), true);
+        mgr.AllocateHost<float>(array);
+
+        // clean copies are skipped, so every sync first dirties its source
+        runner.Run("sync_to_device", {{"bytes", bytes}}, bytes,
+                   [&](size_t iterations) {
+                       return TimeLoop(iterations, [&] {
+                           mgr.MarkHostModified<float>(array);
+                           mgr.SyncToDevice<float>(array);
+                       });
+                   });
+        runner.Run("sync_to_host", {{"bytes", bytes}}, bytes,
+                   [&](size_t iterations) {
+                       return TimeLoop(iterations, [&] {
+                           mgr.MarkDeviceModified<float>(array);
+                           mgr.SyncToHost<float>(array);
+                       });
+                   });
+        mgr.ReleaseArray<float>(array);
+    }
+}
+
+void BenchLaunch(Runner& runner, const fs::path& kernel_dir) {
+    SetEnv("DEXSIM_KERNEL_DIR", kernel_dir.string());
+    HostManager host;
+    CudaManager& mgr = host.manager;
+    const char* kernel = "bench0_0_0";
+
+    const int kMaxArgs = dexsim::cudamgr::kMaxLaunchArrays;
+    std::vector<float> data(1000, 1.0f);
+    int shape[1] = {1000};
+    HyperArrayHook arrays[kMaxArgs];
+    for (HyperArrayHook& array : arrays) {
+        mgr.CreateArray<float>(&array, 1, shape, data.data(), true);
+    }
+
+    for (int args : {1, 2, 4, 8, kMaxArgs}) {
+        // by name, as step code written before BindLaunch does
+        runner.Run("launch", {{"args", args}}, 0, [&](size_t iterations) {
+            return TimeLoop(iterations,
+                            [&] { mgr.Launch(kernel, args, arrays, -1, -1); });
+        });
+
+        LaunchHook launch = mgr.BindLaunch(kernel, args, arrays, -1, -1);
+        runner.Run("submit_launch", {{"args", args}}, 0,
+                   [&](size_t iterations) {
+                       return TimeLoop(iterations,
+                                       [&] { mgr.SubmitLaunch(launch); });
+                   });
+        mgr.ReleaseLaunch(launch);
+    }
+
+    for (HyperArrayHook array : arrays) { mgr.ReleaseArray<float>(array); }
+}
+
+void BenchStartup(Runner& runner, const fs::path& root) {
+    for (int kernels : {100, 1000, 10000}) {
+        // the same kernels parsed from CoreLUT.txt and mapped from the index
+        fs::path lut_dir = root / ("kernels_" + std::to_string(kernels));
+        fs::path index_dir = lut_dir.string() + "_index";
+        WriteKernelDir(lut_dir, kernels, 100);
+        WriteKernelDir(index_dir, kernels, 100);
+        KernelIndex::Build(index_dir, index_dir / KernelIndex::kFileName);
+
+        // constructing the manager runs ProcessFile on every CoreLUT.txt
+        for (const auto& variant :
+             {std::make_pair("startup_lut", lut_dir),
+              std::make_pair("startup_index", index_dir)}) {
+            SetEnv("DEXSIM_KERNEL_DIR", variant.second.string());
+            runner.Run(variant.first, {{"kernels", kernels}}, 0,
+                       [&](size_t iterations) {
+                           double total = 0;
+                           for (size_t i = 0; i < iterations; ++i) {
+                               HostFunctionManager driver;
+                               auto start = Clock::now();
+                               CudaManager mgr(&driver);
+                               total += std::chrono::duration<double,
+                                                             std::nano>(
+                                                Clock::now() - start)
+                                                .count();
+                           }
+                           return total;
+                       });
+        }
+
+        // up to the first submitted launch, which loads one module; the
+        // module cache is warm after the calibration run
+        SetEnv("DEXSIM_KERNEL_DIR", lut_dir.string());
+        runner.Run("first_launch", {{"kernels", kernels}}, 0,
+                   [&](size_t iterations) {
+                       double total = 0;
+                       float value = 1.0f;
+                       int shape[1] = {1};
+                       for (size_t i = 0; i < iterations; ++i) {
+                           HostFunctionManager driver;
+                           auto start = Clock::now();
+                           CudaManager mgr(&driver);
+                           HyperArrayHook array = nullptr;
+                           mgr.CreateArray<float>(&array, 1, shape, &value,
+                                                  true);
+                           mgr.Launch("bench0_0_0", 1, &array, -1, -1);
+                           total += std::chrono::duration<double, std::nano>(
+                                            Clock::now() - start)
+                                            .count();
+                           mgr.ReleaseArray<float>(array);
+                       }
+                       return total;
+                   });
+    }
+}
+
+bool ParseOptions(int argc, char** argv, Options* options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--list") {
+            options->list = true;
+        } else if (arg == "--repeats" && has_value) {
+            options->repeats = std::atoi(argv[++i]);
+        } else if (arg == "--min-time-ms" && has_value) {
+            options->min_sample_ms = std::atof(argv[++i]);
+        } else if (arg == "--filter" && has_value) {
+            options->filter = argv[++i];
+        } else if (arg == "--output" && has_value) {
+            options->output = argv[++i];
+        } else {
+            return false;
+        }
+    }
+    return options->repeats > 0 && options->min_sample_ms >= 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!ParseOptions(argc, argv, &options)) {
+        std::cerr << "usage: " << argv[0]
+                  << " [--repeats N] [--min-time-ms T] [--filter TEXT]"
+                     " [--output FILE] [--list]"
+                  << std::endl;
+        return 2;
+    }
+
+    Runner runner(options);
+    {
+        TempRoot root("df_bench");
+        fs::path launch_dir = root.path() / "launch_kernels";
+        WriteKernelDir(launch_dir, 1, 1);
+        SetEnv("DEXSIM_KERNEL_DIR", launch_dir.string());
+        // the managers log to stdout, which may carry the JSON
+        QuietConsole quiet;
+
+        BenchArrays(runner);
+        BenchSync(runner);
+        BenchLaunch(runner, launch_dir);
+        BenchStartup(runner, root.path());
+    }
+    if (options.list) return 0;
+
+    if (options.output.empty()) {
+        runner.WriteJson(std::cout);
+    } else {
+        std::ofstream file(options.output);
+        runner.WriteJson(file);
+        if (!file) {
+            std::cerr << "Failed to write " << options.output << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
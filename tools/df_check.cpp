@@ -0,0 +1,520 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) 2021-2025 DexForce Technology Co., Ltd.
+//
+// All rights reserved.
+// ----------------------------------------------------------------------------
+// Functional checks of the compute core's caches.
+//
+// usage: df_check
+//
+// Runs CudaManager on the host stand-in driver and checks the counters behind
+// the caches: hits, misses and deferred frees of the device memory pool,
+// replays and kernel node updates of captured graphs, waits for pending
+// asynchronous copies and for pool streams before blocking copies, host
+// arena blocks, bytes of shared host and device storage, and hits and misses
+// of the compiled module cache. Also checks that the host elementwise kernels
+// give the same bits on every instruction set the CPU supports.
+// $HOME and the kernel directory are redirected to a temporary directory.
+// Prints one line per check group to stderr and exits with 1 if a check
+// failed.
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "DFCpuMgr.hpp"
+#include "DFHostArena.h"
+#include "DFHostSimd.h"
+#include "df_tool_common.h"
+
+using dexsim::cudamgr::CpuManager;
+using dexsim::cudamgr::CudaManager;
+using dexsim::cudamgr::ElementwiseArity;
+using dexsim::cudamgr::ElementwiseOp;
+using dexsim::cudamgr::EventHandle;
+using dexsim::cudamgr::GetSimdLevel;
+using dexsim::cudamgr::GraphHook;
+using dexsim::cudamgr::HostArena;
+using dexsim::cudamgr::HostArenaStats;
+using dexsim::cudamgr::HyperArrayBase;
+using dexsim::cudamgr::HyperArrayHook;
+using dexsim::cudamgr::kNoSignal;
+using dexsim::cudamgr::MemoryPoolStats;
+using dexsim::cudamgr::ModuleCacheStats;
+using dexsim::cudamgr::OP_COUNT;
+using dexsim::cudamgr::OP_LERP;
+using dexsim::cudamgr::SetSimdLevel;
+using dexsim::cudamgr::SIMD_SCALAR;
+using dexsim::cudamgr::SimdLevel;
+using dexsim::cudamgr::StreamPoolConfig;
+using dexsim::cudamgr::SupportedSimdLevel;
+using dexsim::cudamgr::ToArrayBase;
+using dexsim::tools::HostManager;
+using dexsim::tools::QuietConsole;
+using dexsim::tools::SetEnv;
+using dexsim::tools::TempRoot;
+using dexsim::tools::WriteKernelModule;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// c = a + b
+const char* const kKernel = "array1d_addf32_0";
+constexpr int kElements = 1024;
+constexpr size_t kBytes = kElements * sizeof(float);
+
+int failures = 0;
+
+void Expect(size_t actual, size_t expected, const std::string& what) {
+    if (actual == expected) return;
+    ++failures;
+    std::cerr << "check failed: " << what << " is " << actual << ", expected "
+              << expected << std::endl;
+}
+
+void Report(const char* name, int before) {
+    std::cerr << name << ": " << (failures == before ? "ok" : "FAILED")
+              << std::endl;
+}
+
+HyperArrayHook CreateDeviceArray(CudaManager& mgr) {
+    std::vector<float> data(kElements, 1.0f);
+    int shape[1] = {kElements};
+    HyperArrayHook array = nullptr;
+    mgr.CreateArray<float>(&array, 1, shape, data.data(), false);
+    mgr.AllocateDevice<float>(array);
+    return array;
+}
+
+// Allocations after a free are served from the cache, and a block freed
+// while the device may still use it is only reused once that work is done.
+void CheckMemoryPool() {
+    int before = failures;
+    HostManager host;
+    CudaManager& mgr = host.manager;
+    MemoryPoolStats start = mgr.GetDeviceMemoryStats();
+
+    HyperArrayHook array = CreateDeviceArray(mgr);
+    MemoryPoolStats stats = mgr.GetDeviceMemoryStats();
+    Expect(stats.misses - start.misses, 1, "pool misses of the first alloc");
+    Expect(stats.segments - start.segments, 1, "pool segments");
+    Expect(stats.bytes_in_use - start.bytes_in_use, kBytes,
+           "pool bytes in use");
+
+    // the device is idle, the freed block is reused in place
+    mgr.ReleaseArrayDataDevice<float>(array);
+    mgr.AllocateDevice<float>(array);
+    stats = mgr.GetDeviceMemoryStats();
+    Expect(stats.hits - start.hits, 1, "pool hits of a realloc");
+    Expect(stats.misses - start.misses, 1, "pool misses of a realloc");
+    Expect(stats.bytes_pending, 0, "pool bytes pending of a realloc");
+
+    // the device still runs work issued before the free
+    host.driver.HoldWork(true);
+    mgr.ReleaseArrayDataDevice<float>(array);
+    stats = mgr.GetDeviceMemoryStats();
+    Expect(stats.bytes_pending, kBytes, "pool bytes pending while busy");
+    Expect(stats.bytes_in_use - start.bytes_in_use, 0,
+           "pool bytes in use while busy");
+    mgr.AllocateDevice<float>(array);
+    Expect(mgr.GetDeviceMemoryStats().bytes_pending, kBytes,
+           "pool bytes pending of a realloc while busy");
+    host.driver.HoldWork(false);
+
+    mgr.ReleaseArray<float>(array);
+    mgr.TrimDeviceMemory();
+    stats = mgr.GetDeviceMemoryStats();
+    Expect(stats.bytes_pending, 0, "pool bytes pending after trim");
+    Expect(stats.bytes_in_use - start.bytes_in_use, 0,
+           "pool bytes in use after trim");
+    Expect(stats.segments - start.segments, 0, "pool segments after trim");
+    Report("memory_pool", before);
+}
+
+// Replays submit the instantiated graph as is, until an argument moves and
+// the nodes of the launches using it are updated once.
+void CheckGraphs() {
+    int before = failures;
+    HostManager host;
+    CudaManager& mgr = host.manager;
+    HyperArrayHook args[3] = {CreateDeviceArray(mgr), CreateDeviceArray(mgr),
+                              CreateDeviceArray(mgr)};
+
+    int stream = mgr.CreateStreamInFamily(CALCULATE_STREAM);
+    Expect(mgr.BeginCapture(CALCULATE_STREAM, stream), 1, "BeginCapture");
+    mgr.Launch(kKernel, 3, args, CALCULATE_STREAM, stream);
+    mgr.Launch(kKernel, 3, args, CALCULATE_STREAM, stream);
+    GraphHook graph = mgr.EndCapture();
+    Expect(graph != nullptr, 1, "EndCapture");
+
+    if (graph != nullptr) {
+        for (int i = 0; i < 3; ++i) { mgr.ReplayGraph(graph); }
+        Expect(host.driver.GraphLaunchCount(), 3, "graph launches");
+        Expect(host.driver.NodeUpdateCount(), 0, "node updates");
+
+        // a block freed while the device is busy is not reused, so the
+        // output moves
+        host.driver.HoldWork(true);
+        mgr.ReleaseArrayDataDevice<float>(args[2]);
+        mgr.AllocateDevice<float>(args[2]);
+        host.driver.HoldWork(false);
+        mgr.ReplayGraph(graph);
+        Expect(host.driver.GraphLaunchCount(), 4,
+               "graph launches after a realloc");
+        Expect(host.driver.NodeUpdateCount(), 2,
+               "node updates after a realloc");
+        mgr.ReplayGraph(graph);
+        Expect(host.driver.NodeUpdateCount(), 2,
+               "node updates of the next replay");
+        mgr.ReleaseGraph(graph);
+    }
+
+    mgr.DeleteStreamFromFamily(CALCULATE_STREAM, stream);
+    for (HyperArrayHook array : args) { mgr.ReleaseArray<float>(array); }
+    Report("graphs", before);
+}
+
+// A blocking access to an array waits for the *Async copy still running on
+// it instead of trusting the validity bits the copy already set.
+void CheckPendingCopies() {
+    int before = failures;
+    HostManager host;
+    CudaManager& mgr = host.manager;
+    HyperArrayHook array = CreateDeviceArray(mgr);
+    HyperArrayBase* base = ToArrayBase(array);
+    int stream = mgr.CreateStreamInFamily(CALCULATE_STREAM);
+    std::vector<float> data(kElements, 0.0f);
+
+    host.driver.HoldWork(true);
+    EventHandle event =
+            mgr.SyncToDeviceAsync<float>(array, CALCULATE_STREAM, stream);
+    Expect(base->pending_copy_ != kNoSignal, 1, "to device copy pending");
+    Expect(mgr.QueryEvent(event), 0, "to device copy done while busy");
+    mgr.WriteArrayDataHost<float>(array, data.data());
+    Expect(base->pending_copy_ == kNoSignal, 1,
+           "to device copy pending after a host write");
+    mgr.ReleaseEvent(event);
+
+    mgr.MarkDeviceModified<float>(array);
+    event = mgr.SyncToHostAsync<float>(array, CALCULATE_STREAM, stream);
+    Expect(base->pending_copy_ != kNoSignal, 1, "to host copy pending");
+    mgr.SyncToHost<float>(array);
+    Expect(base->pending_copy_ == kNoSignal, 1,
+           "to host copy pending after SyncToHost");
+    mgr.ReleaseEvent(event);
+
+    mgr.MarkDeviceModified<float>(array);
+    event = mgr.SyncToHostAsync<float>(array, CALCULATE_STREAM, stream);
+    mgr.GetArrayDataDevice<float>(array, data.data());
+    Expect(base->pending_copy_ == kNoSignal, 1,
+           "to host copy pending after GetArrayDataDevice");
+    mgr.ReleaseEvent(event);
+    host.driver.HoldWork(false);
+
+    mgr.DeleteStreamFromFamily(CALCULATE_STREAM, stream);
+    mgr.ReleaseArray<float>(array);
+    Report("pending_copies", before);
+}
+
+// Blocking copies run on the legacy default stream, so they first wait for
+// the non-blocking pool stream an array was launched on.
+void CheckPoolStreamCopies() {
+    int before = failures;
+    HostManager host;
+    CudaManager& mgr = host.manager;
+    StreamPoolConfig config;
+    config.num_streams = 2;
+    Expect(mgr.ConfigureStreamPool(CALCULATE_STREAM, config), 1,
+           "ConfigureStreamPool");
+    HyperArrayHook args[3] = {CreateDeviceArray(mgr), CreateDeviceArray(mgr),
+                              CreateDeviceArray(mgr)};
+    std::vector<float> data(kElements, 0.0f);
+
+    size_t syncs = host.driver.StreamSyncCount();
+    mgr.GetArrayDataDevice<float>(args[0], data.data());
+    Expect(host.driver.StreamSyncCount() - syncs, 0,
+           "stream syncs of a copy before any launch");
+
+    int stream = mgr.AcquireStream(CALCULATE_STREAM);
+    mgr.Launch(kKernel, 3, args, CALCULATE_STREAM, stream);
+    syncs = host.driver.StreamSyncCount();
+    mgr.SyncToHost<float>(args[2]);
+    Expect(host.driver.StreamSyncCount() - syncs, 1,
+           "stream syncs of SyncToHost after a pool launch");
+    mgr.GetArrayDataDevice<float>(args[0], data.data());
+    Expect(host.driver.StreamSyncCount() - syncs, 2,
+           "stream syncs of GetArrayDataDevice after a pool launch");
+    mgr.WriteArrayDataDevice<float>(args[1], data.data());
+    Expect(host.driver.StreamSyncCount() - syncs, 3,
+           "stream syncs of WriteArrayDataDevice after a pool launch");
+
+    for (HyperArrayHook array : args) { mgr.ReleaseArray<float>(array); }
+    Report("pool_stream_copies", before);
+}
+
+// Huge blocks start on a huge page and are reused from the free list like
+// the small ones, whose header sits in front of them.
+void CheckHostArena() {
+    int before = failures;
+    HostArena arena;
+    size_t sizes[] = {100, HostArena::kHugeBlockSize,
+                      HostArena::kHugeBlockSize + 1};
+    for (size_t size : sizes) {
+        std::string name = "arena block of " + std::to_string(size) + " bytes";
+        size_t alignment = size >= HostArena::kHugeBlockSize
+                                   ? HostArena::kHugeBlockSize
+                                   : HostArena::kAlignment;
+        void* block = arena.Allocate(size);
+        Expect(reinterpret_cast<uintptr_t>(block) % alignment, 0,
+               name + " misalignment");
+        Expect(arena.Free(block), 1, name + " freed");
+        Expect(arena.Free(block), 0, name + " freed twice");
+        Expect(arena.Allocate(size) == block, 1, name + " reused");
+        arena.Free(block);
+    }
+    HostArenaStats stats = arena.GetStats();
+    Expect(stats.hits, 3, "arena hits");
+    Expect(stats.bytes_in_use, 0, "arena bytes in use");
+    Expect(arena.Trim(), stats.bytes_cached, "arena bytes trimmed");
+    Report("host_arena", before);
+}
+
+// Sharing host storage releases the storage the destination held, which the
+// arena then caches, and the shared storage lives until both arrays let go.
+void CheckSharedHostMemory() {
+    int before = failures;
+    HostManager host;
+    CudaManager& mgr = host.manager;
+    HostArenaStats start = mgr.GetHostArenaStats();
+
+    HyperArrayHook src = CreateDeviceArray(mgr);
+    HyperArrayHook dst = CreateDeviceArray(mgr);
+    Expect(mgr.GetHostArenaStats().bytes_in_use - start.bytes_in_use,
+           2 * kBytes, "arena bytes in use of two arrays");
+    mgr.ShareFromArrayDataHost<float>(src, dst);
+    HostArenaStats stats = mgr.GetHostArenaStats();
+    Expect(stats.bytes_in_use - start.bytes_in_use, kBytes,
+           "arena bytes in use after sharing");
+    Expect(stats.bytes_cached - start.bytes_cached, kBytes,
+           "arena bytes cached after sharing");
+
+    mgr.ReleaseArray<float>(src);
+    Expect(mgr.GetHostArenaStats().bytes_in_use - start.bytes_in_use, kBytes,
+           "arena bytes in use after releasing the source");
+    mgr.ReleaseArray<float>(dst);
+    Expect(mgr.GetHostArenaStats().bytes_in_use - start.bytes_in_use, 0,
+           "arena bytes in use after releasing both");
+    Report("shared_host_memory", before);
+}
+
+// Inputs of the SIMD parity check: random values with the ones the paths are
+// most likely to disagree on mixed in. For integers the divisor, input 1,
+// holds zeros, and -1 under INT_MIN dividends.
+template <typename T>
+std::vector<T> ParityInput(int input, size_t n) {
+    using limits = std::numeric_limits<T>;
+    std::mt19937 random(1234 + input);
+    std::vector<T> values(n);
+    if constexpr (std::is_floating_point<T>::value) {
+        const T special[] = {T(0),
+                             -T(0),
+                             limits::infinity(),
+                             -limits::infinity(),
+                             limits::quiet_NaN(),
+                             limits::denorm_min(),
+                             limits::max(),
+                             limits::lowest(),
+                             T(1),
+                             T(-1)};
+        std::uniform_real_distribution<T> value(T(-100), T(100));
+        for (size_t i = 0; i < n; ++i) {
+            values[i] = i % 5 == 0 ? special[(i / 5 + input) % 10]
+                                   : value(random);
+        }
+    } else {
+        std::uniform_int_distribution<T> value(limits::min(), limits::max());
+        for (size_t i = 0; i < n; ++i) {
+            values[i] = value(random);
+            if (input == 1 && i % 7 == 0) values[i] = 0;
+            if (i % 11 == 3) {
+                if (input == 0) values[i] = limits::min();
+                if (input == 1) values[i] = -1;
+            }
+        }
+    }
+    return values;
+}
+
+// Runs an elementwise kernel over n elements and returns the destination.
+// Strided runs pass every other element of arrays twice as long, which the
+// host kernels gather into blocks.
+template <typename T>
+std::vector<T> RunElementwise(CpuManager& mgr,
+                              const std::string& kernel,
+                              int arity,
+                              size_t n,
+                              bool strided) {
+    int length = static_cast<int>(strided ? 2 * n : n);
+    HyperArrayHook arrays[4] = {};
+    HyperArrayHook args[4] = {};
+    for (int k = 0; k <= arity; ++k) {
+        std::vector<T> data = k < arity ? ParityInput<T>(k, length)
+                                        : std::vector<T>(length, T(0));
+        mgr.CreateArray<T>(&arrays[k], 1, &length, data.data(), false);
+        mgr.AllocateDevice<T>(arrays[k]);
+        mgr.SyncToDevice<T>(arrays[k]);
+        args[k] = strided ? mgr.Slice<T>(arrays[k], 0, 1, length, 2)
+                          : arrays[k];
+    }
+    mgr.Launch(kernel.c_str(), arity + 1, args, -1, -1);
+    std::vector<T> result(n);
+    mgr.GetArrayDataDevice<T>(args[arity], result.data());
+    for (int k = 0; k <= arity; ++k) {
+        if (strided) mgr.ReleaseView<T>(args[k]);
+        mgr.ReleaseArray<T>(arrays[k]);
+    }
+    return result;
+}
+
+// Every supported instruction set computes each elementwise kernel exactly
+// like the scalar table, on a length that is no multiple of any vector width
+// and on strided views.
+template <typename T>
+void CheckSimdParityOf(CpuManager& mgr, const char* dtype) {
+    const char* const ops[OP_COUNT] = {"add", "sub", "mul", "div",
+                                       "fma", "clamp", "lerp"};
+    const char* const levels[] = {"scalar", "avx2", "avx512"};
+    constexpr size_t kParityElements = 1003;
+    for (int op = 0; op < OP_COUNT; ++op) {
+        if (op == OP_LERP && !std::is_floating_point<T>::value) continue;
+        std::string kernel =
+                std::string("array1d_") + ops[op] + dtype + "_0";
+        int arity = ElementwiseArity(static_cast<ElementwiseOp>(op));
+        for (bool strided : {false, true}) {
+            SetSimdLevel(SIMD_SCALAR);
+            std::vector<T> expected = RunElementwise<T>(
+                    mgr, kernel, arity, kParityElements, strided);
+            for (int level = SIMD_SCALAR + 1; level <= SupportedSimdLevel();
+                 ++level) {
+                SetSimdLevel(static_cast<SimdLevel>(level));
+                std::vector<T> actual = RunElementwise<T>(
+                        mgr, kernel, arity, kParityElements, strided);
+                Expect(std::memcmp(actual.data(), expected.data(),
+                                   kParityElements * sizeof(T)) == 0,
+                       1,
+                       kernel + (strided ? " strided" : "") + " on " +
+                               levels[level] + " matching scalar");
+            }
+        }
+    }
+}
+
+void CheckSimdParity() {
+    int before = failures;
+    SimdLevel initial = GetSimdLevel();
+    CpuManager mgr(4);
+    CheckSimdParityOf<float>(mgr, "f32");
+    CheckSimdParityOf<double>(mgr, "f64");
+    CheckSimdParityOf<int32_t>(mgr, "i32");
+    SetSimdLevel(initial);
+    Report("simd_parity", before);
+}
+
+// Sharing device storage gives the destination's block back to the pool,
+// sharing storage an array already holds keeps it.
+void CheckSharedDeviceMemory() {
+    int before = failures;
+    HostManager host;
+    CudaManager& mgr = host.manager;
+    MemoryPoolStats start = mgr.GetDeviceMemoryStats();
+
+    HyperArrayHook src = CreateDeviceArray(mgr);
+    HyperArrayHook dst = CreateDeviceArray(mgr);
+    mgr.ShareFromArrayDataDevice<float>(src, dst);
+    Expect(mgr.GetDeviceMemoryStats().bytes_in_use - start.bytes_in_use,
+           kBytes, "pool bytes in use after sharing");
+    mgr.ShareFromArrayDataDevice<float>(src, dst);
+    Expect(ToArrayBase(src)->gpu_data_->semaphore_, 2,
+           "references to the shared device storage");
+
+    // the only reference to the storage, releasing it would free the block
+    HyperArrayHook own = CreateDeviceArray(mgr);
+    mgr.ShareFromArrayDataDevice<float>(own, own);
+    Expect(mgr.GetDeviceMemoryStats().bytes_in_use - start.bytes_in_use,
+           2 * kBytes, "pool bytes in use after sharing into itself");
+    Expect(ToArrayBase(own)->gpu_data_->semaphore_, 1,
+           "references to storage shared into itself");
+    mgr.ReleaseArray<float>(own);
+
+    mgr.ReleaseArray<float>(src);
+    Expect(mgr.GetDeviceMemoryStats().bytes_in_use - start.bytes_in_use,
+           kBytes, "pool bytes in use after releasing the source");
+    mgr.ReleaseArray<float>(dst);
+    Expect(mgr.GetDeviceMemoryStats().bytes_in_use - start.bytes_in_use, 0,
+           "pool bytes in use after releasing both");
+    Report("shared_device_memory", before);
+}
+
+// The first manager compiles the module and stores it, the next one loads
+// the stored cubin.
+void CheckModuleCache(const fs::path& root) {
+    int before = failures;
+    // a $HOME no earlier manager has filled
+    fs::create_directories(root / "home_modules");
+    SetEnv("HOME", (root / "home_modules").string());
+    HyperArrayHook args[3] = {nullptr, nullptr, nullptr};
+    for (int run = 0; run < 2; ++run) {
+        HostManager host;
+        CudaManager& mgr = host.manager;
+        for (HyperArrayHook& array : args) { array = CreateDeviceArray(mgr); }
+        mgr.Launch(kKernel, 3, args, -1, -1);
+        mgr.Launch(kKernel, 3, args, -1, -1);
+
+        std::string name = run == 0 ? "cold" : "warm";
+        ModuleCacheStats stats = mgr.GetModuleCacheStats();
+        Expect(stats.hits, run == 0 ? 0 : 1, name + " module cache hits");
+        Expect(stats.misses, run == 0 ? 1 : 0, name + " module cache misses");
+        Expect(stats.stores, run == 0 ? 1 : 0, name + " module cache stores");
+        Expect(host.driver.LinkCount(), run == 0 ? 1 : 0,
+               name + " module links");
+        Expect(host.driver.ModuleLoadCount(), 1, name + " module loads");
+        for (HyperArrayHook array : args) { mgr.ReleaseArray<float>(array); }
+    }
+    Report("module_cache", before);
+}
+
+}  // namespace
+
+int main() {
+    {
+        TempRoot root("df_check");
+        fs::path kernels = root.path() / "kernels";
+        WriteKernelModule(kernels, "check",
+                          {{kKernel, std::string("wp_") + kKernel}});
+        SetEnv("DEXSIM_KERNEL_DIR", kernels.string());
+        QuietConsole quiet;
+
+        CheckMemoryPool();
+        CheckGraphs();
+        CheckPendingCopies();
+        CheckPoolStreamCopies();
+        CheckHostArena();
+        CheckSharedHostMemory();
+        CheckSharedDeviceMemory();
+        CheckSimdParity();
+        CheckModuleCache(root.path());
+    }
+
+    if (failures != 0) {
+        std::cerr << "df_check: " << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cerr << "df_check: passed" << std::endl;
+    return 0;
+}
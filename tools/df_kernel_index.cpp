@@ -0,0 +1,35 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) 2021-2025 DexForce Technology Co., Ltd.
+//
+// All rights reserved.
+// ----------------------------------------------------------------------------
+// Compiles the CoreLUT.txt files of a kernel directory into KernelIndex.bin.
+//
+// usage: df_kernel_index <kernel_dir> [output]
+// output defaults to <kernel_dir>/KernelIndex.bin, where CudaManager looks
+// for it. Rerun it whenever a CoreLUT.txt changes or is added; the manager
+// ignores an index older than one of the CoreLUT.txt files it was built from.
+#include <filesystem>
+#include <iostream>
+
+#include "DFKernelIndex.h"
+
+using dexsim::cudamgr::KernelIndex;
+
+int main(int argc, char** argv) {
+    if (argc < 2 || argc > 3) {
+        std::cerr << "usage: " << argv[0] << " <kernel_dir> [output]"
+                  << std::endl;
+        return 2;
+    }
+    std::filesystem::path kernel_dir = argv[1];
+    std::filesystem::path output = argc == 3
+                                           ? std::filesystem::path(argv[2])
+                                           : kernel_dir / KernelIndex::kFileName;
+
+    size_t num_kernels = 0;
+    if (!KernelIndex::Build(kernel_dir, output, &num_kernels)) return 1;
+    std::cout << "Indexed " << num_kernels << " kernels into " << output
+              << std::endl;
+    return 0;
+}
@@ -0,0 +1,310 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) 2021-2025 DexForce Technology Co., Ltd.
+//
+// All rights reserved.
+// ----------------------------------------------------------------------------
+// Concurrency stress test of the compute core.
+//
+// usage: df_stress [--threads N] [--iterations N]
+//
+// Drives CudaManager on the host stand-in driver and CpuManager from many
+// threads at once: array life cycles on per-thread streams, a stream family
+// growing under concurrent launches, launches racing with the deletion of
+// their stream, and graph capture and replay. Results are checked against
+// the launches the stand-in driver saw and, on the host backend, against the
+// kernel output. Build it with -DDF_STRESS_TSAN=ON to have ThreadSanitizer
+// report the data races the checks cannot see. Prints one line per scenario
+// to stderr and exits with 1 if a check failed.
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "DFCpuMgr.hpp"
+#include "df_tool_common.h"
+
+using dexsim::cudamgr::CpuManager;
+using dexsim::cudamgr::EventHandle;
+using dexsim::cudamgr::GraphHook;
+using dexsim::cudamgr::HyperArrayHook;
+using dexsim::cudamgr::ICudaManager;
+using dexsim::cudamgr::LaunchHook;
+using dexsim::cudamgr::LaunchRecord;
+using dexsim::tools::HostManager;
+using dexsim::tools::QuietConsole;
+using dexsim::tools::SetEnv;
+using dexsim::tools::TempRoot;
+using dexsim::tools::WriteKernelModule;
+
+namespace {
+
+// c = a + b, a host kernel on the CPU backend and a LUT entry on the CUDA one
+const char* const kKernel = "array1d_addf32_0";
+constexpr int kElements = 256;
+
+struct Options {
+    int threads = 8;
+    int iterations = 200;
+};
+
+bool ParseOptions(int argc, char** argv, Options* options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--threads" && has_value) {
+            options->threads = std::atoi(argv[++i]);
+        } else if (arg == "--iterations" && has_value) {
+            options->iterations = std::atoi(argv[++i]);
+        } else {
+            return false;
+        }
+    }
+    // the stream churn needs a deleting thread and at least one submitter
+    return options->threads > 1 && options->iterations > 0;
+}
+
+std::atomic<int> failures{0};
+std::mutex report_mutex;
+
+void Check(bool ok, const std::string& what) {
+    if (ok) return;
+    // reports the first failures only, a broken invariant repeats a lot
+    if (failures.fetch_add(1) < 20) {
+        std::lock_guard<std::mutex> lock(report_mutex);
+        std::cerr << "check failed: " << what << std::endl;
+    }
+}
+
+void RunThreads(int threads, const std::function<void(int)>& body) {
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (int t = 0; t < threads; ++t) { workers.emplace_back(body, t); }
+    for (auto& worker : workers) { worker.join(); }
+}
+
+struct Arrays {
+    HyperArrayHook hooks[3] = {nullptr, nullptr, nullptr};
+};
+
+// a, b and c of kKernel with a = b = value, on host and device
+Arrays CreateArrays(ICudaManager& mgr, float value) {
+    Arrays arrays;
+    std::vector<float> data(kElements, value);
+    int shape[1] = {kElements};
+    for (HyperArrayHook& hook : arrays.hooks) {
+        mgr.CreateArray<float>(&hook, 1, shape, data.data(), false);
+        mgr.AllocateDevice<float>(hook);
+    }
+    return arrays;
+}
+
+void ReleaseArrays(ICudaManager& mgr, Arrays& arrays) {
+    for (HyperArrayHook hook : arrays.hooks) { mgr.ReleaseArray<float>(hook); }
+}
+
+void CheckSum(ICudaManager& mgr, HyperArrayHook c, float expected) {
+    std::vector<float> output(kElements);
+    mgr.GetArrayDataDevice<float>(c, output.data());
+    Check(output.front() == expected && output.back() == expected,
+          "launch result");
+}
+
+// Every thread runs whole array life cycles on a stream of its own: upload,
+// launch, batch, cross-stream signal, read back, release. Returns the number
+// of kernel launches.
+size_t StressArrays(ICudaManager& mgr, const Options& options, bool values) {
+    RunThreads(options.threads, [&](int tid) {
+        float value = static_cast<float>(tid + 1);
+        for (int it = 0; it < options.iterations; ++it) {
+            int stream = mgr.CreateStreamInFamily(CALCULATE_STREAM);
+            Check(stream >= 0, "CreateStreamInFamily");
+            Arrays arrays = CreateArrays(mgr, value);
+            HyperArrayHook* args = arrays.hooks;
+
+            mgr.SyncToDevice<float>(args[0]);
+            EventHandle upload =
+                    mgr.SyncToDeviceAsync<float>(args[1], CALCULATE_STREAM,
+                                                 stream);
+            mgr.WaitEvent(upload);
+            mgr.ReleaseEvent(upload);
+
+            mgr.Launch(kKernel, 3, args, CALCULATE_STREAM, stream);
+            LaunchRecord records[2] = {{3, args}, {3, args}};
+            Check(mgr.LaunchBatch(kKernel, records, 2, CALCULATE_STREAM,
+                                  stream),
+                  "LaunchBatch");
+            // the default stream, which reads back, waits for ours
+            mgr.Wait(-1, -1, mgr.Signal(CALCULATE_STREAM, stream));
+            if (values) CheckSum(mgr, args[2], 2 * value);
+
+            ReleaseArrays(mgr, arrays);
+            mgr.DeleteStreamFromFamily(CALCULATE_STREAM, stream);
+        }
+    });
+    return static_cast<size_t>(options.threads) * options.iterations * 3;
+}
+
+// Thread 0 deletes and recreates a stream while the others keep submitting
+// their bound launch on it; no submission may reach a destroyed stream.
+// Returns the number of kernel launches.
+size_t StressStreamChurn(ICudaManager& mgr, const Options& options) {
+    int stream = mgr.CreateStreamInFamily(PHYSICS_STREAM);
+    Check(stream >= 0, "CreateStreamInFamily");
+
+    int submitters = options.threads - 1;
+    int submissions = options.iterations * 10;
+    std::atomic<int> running{submitters};
+    RunThreads(options.threads, [&](int tid) {
+        if (tid == 0) {
+            while (running.load() > 0) {
+                mgr.DeleteStreamFromFamily(PHYSICS_STREAM, stream);
+                Check(mgr.CreateStreamInFamily(PHYSICS_STREAM) == stream,
+                      "stream slot reuse");
+            }
+            return;
+        }
+        // a bound launch belongs to one thread at a time
+        Arrays arrays = CreateArrays(mgr, 1.0f);
+        LaunchHook launch = mgr.BindLaunch(kKernel, 3, arrays.hooks,
+                                           PHYSICS_STREAM, stream);
+        Check(launch != nullptr, "BindLaunch");
+        for (int i = 0; i < submissions; ++i) { mgr.SubmitLaunch(launch); }
+        mgr.ReleaseLaunch(launch);
+        ReleaseArrays(mgr, arrays);
+        running.fetch_sub(1);
+    });
+
+    mgr.DeleteStreamFromFamily(PHYSICS_STREAM, stream);
+    return static_cast<size_t>(submitters) * submissions;
+}
+
+// Every thread creates a batch of streams in one family, together more than
+// the first slot chunks hold, and launches on each while the family grows
+// under the others. Returns the number of kernel launches.
+size_t StressStreamGrowth(ICudaManager& mgr, const Options& options) {
+    constexpr int kStreamsPerThread = 40;
+    RunThreads(options.threads, [&](int) {
+        Arrays arrays = CreateArrays(mgr, 1.0f);
+        std::vector<int> streams;
+        for (int i = 0; i < kStreamsPerThread; ++i) {
+            int stream = mgr.CreateStreamInFamily(GEOMETRY_STREAM);
+            Check(stream >= 0, "CreateStreamInFamily");
+            if (stream < 0) continue;
+            streams.push_back(stream);
+            mgr.Launch(kKernel, 3, arrays.hooks, GEOMETRY_STREAM, stream);
+        }
+        mgr.Wait(-1, -1, mgr.Signal(GEOMETRY_STREAM, streams.back()));
+        for (int stream : streams) {
+            mgr.DeleteStreamFromFamily(GEOMETRY_STREAM, stream);
+        }
+        ReleaseArrays(mgr, arrays);
+    });
+    return static_cast<size_t>(options.threads) * kStreamsPerThread;
+}
+
+// Every thread captures two launches on its own stream and replays them,
+// while the other threads keep replaying theirs. Returns the number of kernel
+// launches.
+size_t StressGraphs(ICudaManager& mgr, const Options& options, bool values) {
+    // one thread at a time can capture
+    std::mutex capture_mutex;
+    RunThreads(options.threads, [&](int tid) {
+        float value = static_cast<float>(tid + 1);
+        int stream = mgr.CreateStreamInFamily(CALCULATE_STREAM);
+        Check(stream >= 0, "CreateStreamInFamily");
+        Arrays arrays = CreateArrays(mgr, value);
+        HyperArrayHook* args = arrays.hooks;
+        mgr.SyncToDevice<float>(args[0]);
+        mgr.SyncToDevice<float>(args[1]);
+
+        GraphHook graph = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(capture_mutex);
+            Check(mgr.BeginCapture(CALCULATE_STREAM, stream), "BeginCapture");
+            mgr.Launch(kKernel, 3, args, CALCULATE_STREAM, stream);
+            mgr.Launch(kKernel, 3, args, CALCULATE_STREAM, stream);
+            graph = mgr.EndCapture();
+        }
+        Check(graph != nullptr, "EndCapture");
+        for (int it = 0; graph != nullptr && it < options.iterations; ++it) {
+            Check(mgr.ReplayGraph(graph), "ReplayGraph");
+        }
+        mgr.ReleaseGraph(graph);
+        mgr.Wait(-1, -1, mgr.Signal(CALCULATE_STREAM, stream));
+        if (values) CheckSum(mgr, args[2], 2 * value);
+
+        ReleaseArrays(mgr, arrays);
+        mgr.DeleteStreamFromFamily(CALCULATE_STREAM, stream);
+    });
+    return static_cast<size_t>(options.threads) * options.iterations * 2;
+}
+
+using Scenario = std::function<size_t(ICudaManager&, const Options&, bool)>;
+
+void Run(const char* name, const Scenario& scenario, const Options& options) {
+    int before = failures.load();
+    {
+        // the stand-in only counts launches, it has no values to check
+        HostManager host;
+        size_t launches = scenario(host.manager, options, false);
+        Check(host.driver.LaunchCount() == launches,
+              std::string(name) + " launches on the CUDA backend, " +
+                      std::to_string(host.driver.LaunchCount()) + " of " +
+                      std::to_string(launches));
+    }
+    {
+        CpuManager cpu(4);
+        scenario(cpu, options, true);
+    }
+    std::lock_guard<std::mutex> lock(report_mutex);
+    std::cerr << name << ": "
+              << (failures.load() == before ? "ok" : "FAILED") << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!ParseOptions(argc, argv, &options)) {
+        std::cerr << "usage: " << argv[0]
+                  << " [--threads N (at least 2)] [--iterations N]"
+                  << std::endl;
+        return 2;
+    }
+
+    {
+        TempRoot root("df_stress");
+        // kKernel for the CUDA backend
+        std::filesystem::path kernels = root.path() / "kernels";
+        WriteKernelModule(kernels, "stress",
+                          {{kKernel, std::string("wp_") + kKernel}});
+        SetEnv("DEXSIM_KERNEL_DIR", kernels.string());
+        QuietConsole quiet;
+
+        Run("arrays", StressArrays, options);
+        Run("stream_churn",
+            [](ICudaManager& mgr, const Options& opts, bool) {
+                return StressStreamChurn(mgr, opts);
+            },
+            options);
+        Run("stream_growth",
+            [](ICudaManager& mgr, const Options& opts, bool) {
+                return StressStreamGrowth(mgr, opts);
+            },
+            options);
+        Run("graphs", StressGraphs, options);
+    }
+
+    int failed = failures.load();
+    if (failed != 0) {
+        std::cerr << "df_stress: " << failed << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cerr << "df_stress: passed" << std::endl;
+    return 0;
+}
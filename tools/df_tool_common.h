@@ -0,0 +1,109 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) 2021-2025 DexForce Technology Co., Ltd.
+//
+// All rights reserved.
+// ----------------------------------------------------------------------------
+#pragma once
+// Fixtures shared by df_bench, df_check and df_stress, which run the compute
+// core on the host stand-in driver inside a temporary directory.
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <streambuf>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "DFCudaHostCodes.hpp"
+#include "DFCudaMgr.hpp"
+
+namespace dexsim {
+namespace tools {
+
+// CudaManager on its own stand-in driver, declared in destruction order
+struct HostManager {
+    cudamgr::HostFunctionManager driver;
+    cudamgr::CudaManager manager{&driver};
+};
+
+inline void SetEnv(const char* name, const std::string& value) {
+#if defined(_WIN32)
+    _putenv_s(name, value.c_str());
+#else
+    setenv(name, value.c_str(), 1);
+#endif
+}
+
+// A fresh directory under the system temp directory, removed with everything
+// in it on destruction. $HOME is redirected to its "home" subdirectory, which
+// keeps the module cache and tuned launch configs out of the real one.
+class TempRoot {
+public:
+    explicit TempRoot(const std::string& prefix) {
+        std::random_device random;
+        path_ = std::filesystem::temp_directory_path() /
+                (prefix + "_" + std::to_string(random()));
+        std::filesystem::create_directories(path_ / "home");
+        SetEnv("HOME", (path_ / "home").string());
+    }
+    ~TempRoot() {
+        std::error_code error;
+        std::filesystem::remove_all(path_, error);
+    }
+    TempRoot(const TempRoot&) = delete;
+    TempRoot& operator=(const TempRoot&) = delete;
+
+    const std::filesystem::path& path() const { return path_; }
+
+private:
+    std::filesystem::path path_;
+};
+
+// Writes the module <dir>/<type>: a CoreLUT.txt listing the kernels as
+// (name, function) pairs and an empty PTX image, which the stand-in driver
+// loads like any other.
+inline void WriteKernelModule(
+        const std::filesystem::path& dir,
+        const std::string& type,
+        const std::vector<std::pair<std::string, std::string>>& kernels) {
+    std::filesystem::create_directories(dir / type);
+    std::ofstream lut(dir / type / "CoreLUT.txt");
+    lut << type << " " << kernels.size() << "\n";
+    for (const auto& kernel : kernels) {
+        lut << kernel.first << ":" << kernel.second << "\n";
+    }
+    std::ofstream ptx(dir / type / (type + ".ptx"));
+    ptx << ".version 7.0\n.target sm_50\n.address_size 64\n";
+}
+
+// Swallows the console output of the managers while it lives. CudaManager
+// turns off stdio sync, which would reinstall the buffer of std::cout, so
+// that is done before redirecting it.
+class QuietConsole {
+public:
+    QuietConsole() {
+        std::ios::sync_with_stdio(false);
+        console_ = std::cout.rdbuf(&null_buffer_);
+    }
+    ~QuietConsole() { std::cout.rdbuf(console_); }
+    QuietConsole(const QuietConsole&) = delete;
+    QuietConsole& operator=(const QuietConsole&) = delete;
+
+    // the buffer std::cout wrote to before, e.g. to still print results
+    std::streambuf* console() const { return console_; }
+
+private:
+    class NullBuffer : public std::streambuf {
+    protected:
+        int overflow(int c) override { return c; }
+    };
+
+    NullBuffer null_buffer_;
+    std::streambuf* console_ = nullptr;
+};
+
+}  // namespace tools
+}  // namespace dexsim